@@ -21,6 +21,8 @@
 #include "tdog/private/basic_test.hpp"
 #include "tdog/private/test_case.hpp"
 #include "tdog/private/test_fixture.hpp"
+#include "tdog/private/bench_case.hpp"
+#include "tdog/private/shared_fixture.hpp"
 #include "tdog/private/run_interface.hpp"
 #include "tdog/private/suite_manager.hpp"
 
@@ -99,7 +101,7 @@
  * the file containing the main() function.
  * \param[in] test_name The test name
  * \sa TDOG_SUITE(), TDOG_EXPLICIT_SUITE(), TDOG_TEST_PROTECTED(),
- * TDOG_DEFINE_REPEATED(), TDOG_TEST_FIXTURE(), TDOG_RUN()
+ * TDOG_DEFINE_REPEATED(), TDOG_TEST_FIXTURE(), TDOG_BENCHMARK(), TDOG_RUN()
  */
 #if defined(DOXYGEN_HIDEIMPL)
   // Dummy doc
@@ -383,6 +385,170 @@
   void test_name##_fixtclass::tdog_impl()
 #endif
 
+/**
+ * \brief Declares a fixture which is set up once, and shared by the tests
+ * of a suite.
+ * \details Where setup is expensive, such as loading a data file or opening
+ * a connection, TDOG_TEST_FIXTURE() repeats it for every test. A shared
+ * fixture is instead constructed and set up once, before the first test
+ * which uses it, and torn down after the last. Tests declared with
+ * TDOG_TEST_SHARED() use it, and access it with TDOG_SHARED().
+ *
+ * The user type must implement setup() and teardown() as for
+ * TDOG_TEST_FIXTURE(), and be a simple identifier, as it is used in naming
+ * the fixture instance. It should be declared in the same suite as the
+ * tests which use it.
+ *
+ * Tests are given const access only, as they may run concurrently, and
+ * must not depend on one another through it. Where the runner is in
+ * isolated mode, each worker process has its own copy of the fixture as
+ * it was when set up.
+ *
+ * The time taken by setup() and teardown() is not included in test
+ * durations, but is written to the test log of the first and last tests
+ * which use it. Where setup() returns false or throws, it is not retried,
+ * and the tests which use it are put in the "error" state.
+ *
+ * Example
+ *
+ * \code
+ * struct dictionary_t
+ * {
+ *   std::set<std::string> words;
+ *
+ *   bool setup()
+ *   {
+ *     return load_words("words.txt", words);
+ *   }
+ *
+ *   void teardown()
+ *   {
+ *   }
+ * };
+ *
+ * TDOG_SHARED_FIXTURE(dictionary_t)
+ *
+ * TDOG_TEST_SHARED(has_cat, dictionary_t)
+ * {
+ *   TDOG_ASSERT(TDOG_SHARED().words.count("cat") != 0);
+ * }
+ * \endcode
+ * \param[in] user_type The fixture type
+ * \sa TDOG_TEST_SHARED(), TDOG_SHARED(), TDOG_TEST_FIXTURE()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Dummy doc
+  #define TDOG_SHARED_FIXTURE(user_type)
+#else
+  #define TDOG_SHARED_FIXTURE(user_type) \
+  tdog::shared_fixture<user_type> user_type##_shared_inst(#user_type);
+#endif
+
+/**
+ * \brief Declares and implements a test using a shared fixture.
+ * \details The body is declared as for TDOG_TEST_CASE(). The fixture, which
+ * must have been declared with TDOG_SHARED_FIXTURE(), is accessed with
+ * TDOG_SHARED(), and a typedef of USER_TYPE is provided.
+ * \param[in] test_name The test name
+ * \param[in] user_type The fixture type
+ * \sa TDOG_SHARED_FIXTURE(), TDOG_SHARED()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Dummy doc
+  #define TDOG_TEST_SHARED(test_name, user_type)
+#else
+  #define TDOG_TEST_SHARED(test_name, user_type) \
+  class test_name##_shrdclass : public tdog::run_interface { \
+  public: \
+    typedef user_type USER_TYPE; \
+    const user_type& tdog_shared() const { return user_type##_shared_inst.get(); } \
+    virtual void tdog_impl(); \
+    test_name##_shrdclass(tdog::run_helper* ptr) \
+      : tdog::run_interface(ptr) {} \
+  }; \
+  tdog::shared_test<test_name##_shrdclass> test_name##_inst( \
+    #test_name, &user_type##_shared_inst, __FILE__, __LINE__, #user_type); \
+  void test_name##_shrdclass::tdog_impl()
+#endif
+
+/**
+ * \brief Const reference to the shared fixture of a test.
+ * \details Only valid in a test declared with TDOG_TEST_SHARED().
+ * \sa TDOG_TEST_SHARED(), TDOG_SHARED_FIXTURE()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Dummy doc
+  #define TDOG_SHARED()
+#else
+  #define TDOG_SHARED() \
+  tdog_shared()
+#endif
+
+/**
+ * \brief Declares and implements a microbenchmark.
+ * \details The body is declared as for TDOG_TEST_CASE(), but is run many
+ * times, in batches, with each batch timed in nanoseconds. The batch size
+ * is found by increasing it until a batch takes around 1 ms. Batches are
+ * then run for a short warmup period, before up to 100 batches are timed.
+ *
+ * The time per iteration of the body is reported as the median, 90th and
+ * 99th percentile of these samples, together with the median absolute
+ * deviation (MAD) and the number of operations per second (from the median).
+ * These figures are written by all report styles.
+ *
+ * The result of a computation which is otherwise unused should be passed
+ * to TDOG_DO_NOT_OPTIMIZE(), so that the compiler cannot remove it:
+ *
+ * \code
+ * TDOG_BENCHMARK(hash_bench)
+ * {
+ *   TDOG_DO_NOT_OPTIMIZE( fnv_hash("the quick brown fox") );
+ * }
+ * \endcode
+ *
+ * Asserts may be used in the body as normal. However, only those of the
+ * first iteration are written to the test log, other than failures.
+ * Sampling stops where the test fails, in which case no figures are
+ * reported. Time limits apply to the benchmark as a whole.
+ *
+ * Like TDOG_TEST_CASE(), the test will "self-register" unless declared
+ * in a suite created with TDOG_EXPLICIT_SUITE().
+ * \param[in] test_name The test name
+ * \sa TDOG_DO_NOT_OPTIMIZE(), TDOG_TEST_CASE(), TDOG_SET_TEST_TIMEOUT()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Dummy doc
+  #define TDOG_BENCHMARK(test_name)
+#else
+  #define TDOG_BENCHMARK(test_name) \
+  class test_name##_benchclass : public tdog::run_interface { \
+  public: \
+    virtual void tdog_impl(); \
+    test_name##_benchclass(tdog::run_helper* ptr) \
+      : tdog::run_interface(ptr) {} \
+  }; \
+  tdog::bench_case<test_name##_benchclass> test_name##_inst( \
+    #test_name, __FILE__, __LINE__); \
+  void test_name##_benchclass::tdog_impl()
+#endif
+
+/**
+ * \brief Prevents the compiler from discarding a value computed in a
+ * benchmark.
+ * \details Where the result of a computation is not otherwise used, an
+ * optimizing compiler may remove the computation entirely. Passing the
+ * value to this macro prevents this, at little or no cost.
+ * \param[in] value Value or expression
+ * \sa TDOG_BENCHMARK()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Dummy doc
+  #define TDOG_DO_NOT_OPTIMIZE(value)
+#else
+  #define TDOG_DO_NOT_OPTIMIZE(value) \
+  tdog::do_not_optimize(value)
+#endif
+
 /**
  * \brief Allows "auto-registering" tests to be namespaced and grouped into
  * "suites".
@@ -809,8 +975,8 @@
 #else
   // Actual
   #define TDOG_ASSERT(condition) \
-  tdog_helper->assert_true(condition, true, std::string("ASSERT( ") + \
-    #condition + std::string(" )"), __LINE__)
+  tdog_helper->assert_true(condition, true, \
+    tdog::static_str("ASSERT( " #condition " )"), __LINE__)
 #endif
 
 /**
@@ -826,8 +992,8 @@
 #else
   // Actual
   #define TDOG_ASSERT_NOT(condition) \
-  tdog_helper->assert_true(condition, false, std::string("ASSERT_NOT( ") + \
-    #condition + std::string(" )"), __LINE__)
+  tdog_helper->assert_true(condition, false, \
+    tdog::static_str("ASSERT_NOT( " #condition " )"), __LINE__)
 #endif
 
 /**
@@ -888,8 +1054,8 @@
 #else
   // Actual
   #define TDOG_ASSERT_EQ(exp, act) \
-  tdog_helper->assert_equal(exp, act, true, std::string("ASSERT_EQ( ") + #exp + \
-    std::string(", ") + #act + std::string(" )"), __LINE__)
+  tdog_helper->assert_equal(exp, act, true, \
+    tdog::static_str("ASSERT_EQ( " #exp ", " #act " )"), __LINE__)
 #endif
 
 /**
@@ -905,8 +1071,8 @@
 #else
   // Actual
   #define TDOG_ASSERT_NEQ(nxp, act) \
-  tdog_helper->assert_equal(nxp, act, false, std::string("ASSERT_NEQ( ") + #nxp + \
-    std::string(", ") + #act + std::string(" )"), __LINE__)
+  tdog_helper->assert_equal(nxp, act, false, \
+    tdog::static_str("ASSERT_NEQ( " #nxp ", " #act " )"), __LINE__)
 #endif
 
 /**
@@ -939,8 +1105,8 @@
 #else
   // Actual
   #define TDOG_ASSERT_LT(act, lim) \
-  tdog_helper->assert_less_than(act, lim, false, std::string("ASSERT_LT( ") + #act + \
-    std::string(", ") + #lim + std::string(" )"), __LINE__)
+  tdog_helper->assert_less_than(act, lim, false, \
+    tdog::static_str("ASSERT_LT( " #act ", " #lim " )"), __LINE__)
 #endif
 
 /**
@@ -973,8 +1139,8 @@
 #else
   // Actual
   #define TDOG_ASSERT_LTE(act, lim) \
-  tdog_helper->assert_less_than(act, lim, true, std::string("ASSERT_LTE( ") + #act + \
-    std::string(", ") + #lim + std::string(" )"), __LINE__)
+  tdog_helper->assert_less_than(act, lim, true, \
+    tdog::static_str("ASSERT_LTE( " #act ", " #lim " )"), __LINE__)
 #endif
 
 /**
@@ -1007,8 +1173,8 @@
 #else
   // Actual
   #define TDOG_ASSERT_GT(act, lim) \
-  tdog_helper->assert_greater_than(act, lim, false, std::string("ASSERT_GT( ") + #act + \
-    std::string(", ") + #lim + std::string(" )"), __LINE__)
+  tdog_helper->assert_greater_than(act, lim, false, \
+    tdog::static_str("ASSERT_GT( " #act ", " #lim " )"), __LINE__)
 #endif
 
 /**
@@ -1041,8 +1207,8 @@
 #else
   // Actual
   #define TDOG_ASSERT_GTE(act, lim) \
-  tdog_helper->assert_greater_than(act, lim, true, std::string("ASSERT_GTE( ") + #act + \
-    std::string(", ") + #lim + std::string(" )"), __LINE__)
+  tdog_helper->assert_greater_than(act, lim, true, \
+    tdog::static_str("ASSERT_GTE( " #act ", " #lim " )"), __LINE__)
 #endif
 
 /**
@@ -1206,8 +1372,7 @@
   // Actual
   #define TDOG_ASSERT_DOUBLE_EQ(exp, act, delta) \
   tdog_helper->assert_double_equal(exp, act, true, delta, \
-    std::string("ASSERT_DOUBLE_EQ( ") + #exp + std::string(", ") + \
-    #act + std::string(" )"), __LINE__)
+    tdog::static_str("ASSERT_DOUBLE_EQ( " #exp ", " #act " )"), __LINE__)
 #endif
 
 /**
@@ -1226,8 +1391,7 @@
   // Actual
   #define TDOG_ASSERT_DOUBLE_NEQ(nxp, act, delta) \
   tdog_helper->assert_double_equal(nxp, act, false, delta, \
-    std::string("ASSERT_DOUBLE_NEQ( ") + #nxp + std::string(", ") + \
-    #act + std::string(" )"), __LINE__)
+    tdog::static_str("ASSERT_DOUBLE_NEQ( " #nxp ", " #act " )"), __LINE__)
 #endif
 
 /**
@@ -1300,8 +1464,7 @@
   // Actual
   #define TDOG_ASSERT_STRIC_EQ(exp, act) \
   tdog_helper->assert_stric_equal(exp, act, true, \
-    std::string("ASSERT_STRIC_EQ( ") + #exp + \
-    std::string(", ") + #act + std::string(" )"), __LINE__)
+    tdog::static_str("ASSERT_STRIC_EQ( " #exp ", " #act " )"), __LINE__)
 #endif
 
 /**
@@ -1329,8 +1492,7 @@
   // Actual
   #define TDOG_ASSERT_STRIC_NEQ(nxp, act) \
   tdog_helper->assert_stric_equal(nxp, act, false, \
-    std::string("ASSERT_STRIC_NEQ( ") + #nxp + \
-    std::string(", ") + #act + std::string(" )"), __LINE__)
+    tdog::static_str("ASSERT_STRIC_NEQ( " #nxp ", " #act " )"), __LINE__)
 #endif
 
 /**
@@ -1419,6 +1581,13 @@
  * pointer passed as a C-style type with a non-zero "size" value will
  * cause the test to fail.
  *
+ * Arrays of integer and character types (and std::vector of them) are
+ * compared as a block of memory, rather than element by element. Floating
+ * point types are not, as 0.0 equals -0.0, whereas NaN does not equal
+ * itself. On failure, the index of the first differing element is given in
+ * the report, together with a hex dump around the first differing byte
+ * where compared as memory.
+ *
  * Note. This macro can only be used within the scope of a test case.
  * \param[in] exp Expected value
  * \param[in] act Actual value
@@ -1432,8 +1601,7 @@
   // Actual
   #define TDOG_ASSERT_ARRAY_EQ(exp, act, size) \
   tdog_helper->assert_array_equal(exp, act, true, size, \
-  std::string("ASSERT_ARRAY_EQ( ") + #exp + \
-    std::string(", ") + #act + std::string(" )"), __LINE__)
+  tdog::static_str("ASSERT_ARRAY_EQ( " #exp ", " #act " )"), __LINE__)
 #endif
 
 /**
@@ -1461,8 +1629,7 @@
   // Actual
   #define TDOG_ASSERT_ARRAY_NEQ(nxp, act, size) \
   tdog_helper->assert_array_equal(nxp, act, false, size, \
-  std::string("ASSERT_ARRAY_NEQ( ") + #nxp + \
-    std::string(", ") + #act + std::string(" )"), __LINE__)
+  tdog::static_str("ASSERT_ARRAY_NEQ( " #nxp ", " #act " )"), __LINE__)
 #endif
 
 /**
@@ -1519,6 +1686,280 @@
   tdog_helper->assert_array_equal(nxp, act, false, size, msg, __LINE__)
 #endif
 
+/**
+ * \brief Asserts that floating point arrays are equal to within an
+ * absolute tolerance (the test fails if not).
+ * \details This macro asserts that: <em>|act[i] - exp[i]| <= tol</em>
+ * for each of the first "size" elements. Arrays of double or float
+ * (including std::vector) may be compared, but both must be of the same type.
+ *
+ * Unlike a loop of TDOG_ASSERT_DOUBLE_EQ() statements, a single assert is
+ * recorded for the whole array, and the compare is vectorised where the
+ * CPU supports it. On failure, the report gives the number of elements
+ * which were not within tolerance, the index and values of the worst, and
+ * the largest absolute and relative errors over the array.
+ *
+ * Equal values (including infinities) are always within tolerance, whereas
+ * NaN never is.
+ *
+ * Example
+ *
+ * \code
+ * TDOG_TEST_CASE(test_fft)
+ * {
+ *   std::vector<double> exp = load_reference("fft.dat");
+ *   std::vector<double> act = my_fft(signal);
+ *   TDOG_ASSERT_ARRAY_NEAR(exp, act, exp.size(), 1.0e-9);
+ * }
+ * \endcode
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp Expected values
+ * \param[in] act Actual values
+ * \param[in] size Number of elements to be compared
+ * \param[in] tol Absolute tolerance
+ * \sa TDOG_ASSERT_ARRAY_REL(), TDOG_ASSERT_ARRAY_ULP(),
+ * TDOG_ASSERT_ARRAY_NEAR_MSG(), TDOG_ASSERT_DOUBLE_EQ()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_ARRAY_NEAR(exp, act, size, tol)
+#else
+  // Actual
+  #define TDOG_ASSERT_ARRAY_NEAR(exp, act, size, tol) \
+  tdog_helper->assert_array_close(exp, act, size, tdog::TOL_ABS, tol, \
+  tdog::static_str("ASSERT_ARRAY_NEAR( " #exp ", " #act " )"), __LINE__)
+#endif
+
+/**
+ * \brief Asserts that floating point arrays are equal to within a
+ * relative tolerance (the test fails if not).
+ * \details This macro asserts that: <em>|act[i] - exp[i]| <= tol * |exp[i]|</em>
+ * for each of the first "size" elements. Hence, where an expected value is
+ * zero, the actual value must equal it exactly. It is otherwise equivalent
+ * to TDOG_ASSERT_ARRAY_NEAR().
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp Expected values
+ * \param[in] act Actual values
+ * \param[in] size Number of elements to be compared
+ * \param[in] tol Relative tolerance, i.e. 1.0e-6
+ * \sa TDOG_ASSERT_ARRAY_NEAR(), TDOG_ASSERT_ARRAY_ULP(),
+ * TDOG_ASSERT_ARRAY_REL_MSG()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_ARRAY_REL(exp, act, size, tol)
+#else
+  // Actual
+  #define TDOG_ASSERT_ARRAY_REL(exp, act, size, tol) \
+  tdog_helper->assert_array_close(exp, act, size, tdog::TOL_REL, tol, \
+  tdog::static_str("ASSERT_ARRAY_REL( " #exp ", " #act " )"), __LINE__)
+#endif
+
+/**
+ * \brief Asserts that floating point arrays are equal to within a number
+ * of units in the last place (the test fails if not).
+ * \details This macro asserts that no more than "ulps" representable values
+ * of the type lie between act[i] and exp[i], for each of the first "size"
+ * elements. A value of 0 requires values to be equal, although 0.0 and -0.0
+ * are taken to be the same. The report additionally gives the largest ULP
+ * distance. It is otherwise equivalent to TDOG_ASSERT_ARRAY_NEAR().
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp Expected values
+ * \param[in] act Actual values
+ * \param[in] size Number of elements to be compared
+ * \param[in] ulps Maximum distance in representable values
+ * \sa TDOG_ASSERT_ARRAY_NEAR(), TDOG_ASSERT_ARRAY_REL(),
+ * TDOG_ASSERT_ARRAY_ULP_MSG()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_ARRAY_ULP(exp, act, size, ulps)
+#else
+  // Actual
+  #define TDOG_ASSERT_ARRAY_ULP(exp, act, size, ulps) \
+  tdog_helper->assert_array_close(exp, act, size, tdog::TOL_ULP, ulps, \
+  tdog::static_str("ASSERT_ARRAY_ULP( " #exp ", " #act " )"), __LINE__)
+#endif
+
+/**
+ * \brief Asserts that floating point arrays are equal to within an
+ * absolute tolerance. A custom message is supplied for the test report.
+ * \details This macro is equivalent to TDOG_ASSERT_ARRAY_NEAR() except that a
+ * custom message is supplied for use in the test report output. The message
+ * will be displayed in "verbose" style reports or if the test fails.
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp Expected values
+ * \param[in] act Actual values
+ * \param[in] size Number of elements to be compared
+ * \param[in] tol Absolute tolerance
+ * \param[in] msg Message passed as std::string or C-style string
+ * \sa TDOG_ASSERT_ARRAY_NEAR()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_ARRAY_NEAR_MSG(exp, act, size, tol, msg)
+#else
+  // Actual
+  #define TDOG_ASSERT_ARRAY_NEAR_MSG(exp, act, size, tol, msg) \
+  tdog_helper->assert_array_close(exp, act, size, tdog::TOL_ABS, tol, msg, __LINE__)
+#endif
+
+/**
+ * \brief Asserts that floating point arrays are equal to within a
+ * relative tolerance. A custom message is supplied for the test report.
+ * \details This macro is equivalent to TDOG_ASSERT_ARRAY_REL() except that a
+ * custom message is supplied for use in the test report output.
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp Expected values
+ * \param[in] act Actual values
+ * \param[in] size Number of elements to be compared
+ * \param[in] tol Relative tolerance
+ * \param[in] msg Message passed as std::string or C-style string
+ * \sa TDOG_ASSERT_ARRAY_REL()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_ARRAY_REL_MSG(exp, act, size, tol, msg)
+#else
+  // Actual
+  #define TDOG_ASSERT_ARRAY_REL_MSG(exp, act, size, tol, msg) \
+  tdog_helper->assert_array_close(exp, act, size, tdog::TOL_REL, tol, msg, __LINE__)
+#endif
+
+/**
+ * \brief Asserts that floating point arrays are equal to within a number of
+ * units in the last place. A custom message is supplied for the test report.
+ * \details This macro is equivalent to TDOG_ASSERT_ARRAY_ULP() except that a
+ * custom message is supplied for use in the test report output.
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp Expected values
+ * \param[in] act Actual values
+ * \param[in] size Number of elements to be compared
+ * \param[in] ulps Maximum distance in representable values
+ * \param[in] msg Message passed as std::string or C-style string
+ * \sa TDOG_ASSERT_ARRAY_ULP()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_ARRAY_ULP_MSG(exp, act, size, ulps, msg)
+#else
+  // Actual
+  #define TDOG_ASSERT_ARRAY_ULP_MSG(exp, act, size, ulps, msg) \
+  tdog_helper->assert_array_close(exp, act, size, tdog::TOL_ULP, ulps, msg, __LINE__)
+#endif
+
+/**
+ * \brief Asserts that the contents of two files are equal (the test
+ * fails if not).
+ * \details Files are compared byte for byte, and need not be text. They
+ * are mapped into memory a window at a time, rather than read whole, so
+ * that large files may be compared without using memory in proportion to
+ * their size.
+ *
+ * On failure, the report gives the offset of the first differing byte
+ * and its line and column (counted from 1), together with the file sizes
+ * where they differ. Where one file is the start of the other, the
+ * location given is the end of the shorter. A file which cannot be opened
+ * causes the test to fail.
+ *
+ * Example:
+ *
+ * \code
+ * TDOG_TEST_CASE(test_export)
+ * {
+ *   export_db("./out/db.csv");
+ *   TDOG_ASSERT_FILE_EQ("./golden/db.csv", "./out/db.csv");
+ * }
+ * \endcode
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp_file Filename of expected content
+ * \param[in] act_file Filename of actual content
+ * \sa TDOG_ASSERT_FILE_BUF_EQ(), TDOG_ASSERT_FILE_EQ_MSG()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_FILE_EQ(exp_file, act_file)
+#else
+  // Actual
+  #define TDOG_ASSERT_FILE_EQ(exp_file, act_file) \
+  tdog_helper->assert_file_equal(exp_file, act_file, \
+  tdog::static_str("ASSERT_FILE_EQ( " #exp_file ", " #act_file " )"), __LINE__)
+#endif
+
+/**
+ * \brief Asserts that the contents of a file equal those of a buffer in
+ * memory (the test fails if not).
+ * \details The buffer is given by pointer and size in bytes, i.e. &v[0]
+ * and v.size() for a std::vector. A null pointer with a non-zero size will
+ * cause the test to fail. It is otherwise equivalent to TDOG_ASSERT_FILE_EQ().
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp_file Filename of expected content
+ * \param[in] act Pointer to actual content
+ * \param[in] size Size of actual content in bytes
+ * \sa TDOG_ASSERT_FILE_EQ(), TDOG_ASSERT_FILE_BUF_EQ_MSG()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_FILE_BUF_EQ(exp_file, act, size)
+#else
+  // Actual
+  #define TDOG_ASSERT_FILE_BUF_EQ(exp_file, act, size) \
+  tdog_helper->assert_file_equal(exp_file, act, size, \
+  tdog::static_str("ASSERT_FILE_BUF_EQ( " #exp_file ", " #act " )"), __LINE__)
+#endif
+
+/**
+ * \brief Asserts that the contents of two files are equal. A custom message
+ * is supplied for the test report.
+ * \details This macro is equivalent to TDOG_ASSERT_FILE_EQ() except that a
+ * custom message is supplied for use in the test report output. The message
+ * will be displayed in "verbose" style reports or if the test fails.
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp_file Filename of expected content
+ * \param[in] act_file Filename of actual content
+ * \param[in] msg Message passed as std::string or C-style string
+ * \sa TDOG_ASSERT_FILE_EQ()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_FILE_EQ_MSG(exp_file, act_file, msg)
+#else
+  // Actual
+  #define TDOG_ASSERT_FILE_EQ_MSG(exp_file, act_file, msg) \
+  tdog_helper->assert_file_equal(exp_file, act_file, msg, __LINE__)
+#endif
+
+/**
+ * \brief Asserts that the contents of a file equal those of a buffer in
+ * memory. A custom message is supplied for the test report.
+ * \details This macro is equivalent to TDOG_ASSERT_FILE_BUF_EQ() except that
+ * a custom message is supplied for use in the test report output.
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exp_file Filename of expected content
+ * \param[in] act Pointer to actual content
+ * \param[in] size Size of actual content in bytes
+ * \param[in] msg Message passed as std::string or C-style string
+ * \sa TDOG_ASSERT_FILE_BUF_EQ()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_FILE_BUF_EQ_MSG(exp_file, act, size, msg)
+#else
+  // Actual
+  #define TDOG_ASSERT_FILE_BUF_EQ_MSG(exp_file, act, size, msg) \
+  tdog_helper->assert_file_equal(exp_file, act, size, msg, __LINE__)
+#endif
+
 /**
  * \brief Asserts that the expression throws an exception of the
  * specified type.
@@ -1549,8 +1990,7 @@
     catch(const e_type&) { ethrown = true; } \
     catch(...) {} \
     tdog_helper->assert_true(ethrown, true, \
-      std::string("ASSERT THROWS ( ") + #exprn + \
-      std::string(" )") + #e_type, __LINE__); \
+      tdog::static_str("ASSERT THROWS ( " #exprn " )" #e_type), __LINE__); \
   } while(false)
 #endif
 
@@ -1581,8 +2021,82 @@
     try {  exprn; } \
     catch(...) { ethrown = true; } \
     tdog_helper->assert_true(ethrown, false, \
-      std::string("ASSERT NO THROW ( ") + #exprn + \
-      std::string(" )"), __LINE__); \
+      tdog::static_str("ASSERT NO THROW ( " #exprn " )"), __LINE__); \
+  } while(false)
+#endif
+
+/**
+ * \brief Asserts that the expression does not allocate from the heap.
+ * \details The test fails if the expression makes any allocation with
+ * operator new in the thread running the test. Use it to check that a
+ * hot path in your code does not allocate.
+ *
+ * Example:
+ *
+ * \code
+ * // Test will fail if push allocates
+ * ring_buffer rb(64);
+ * TDOG_ASSERT_NO_ALLOC( rb.push(42) );
+ * \endcode
+ *
+ * Allocations are counted only where the TDOG library is built with the
+ * TDOG_ALLOC_TRACKING macro defined, in which case it replaces the global
+ * operator new and delete. Otherwise, the assert gives a test warning.
+ * Allocations made by other threads are not counted.
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exprn Test expression
+ * \sa TDOG_ASSERT_ALLOC_LTE()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_NO_ALLOC(exprn)
+#else
+  // Actual
+  // The while(false) allows statement to be terminated with semicolon
+  #define TDOG_ASSERT_NO_ALLOC(exprn) \
+  do { \
+    tdog::alloc_counts amark = tdog_helper->alloc_mark(); \
+    exprn; \
+    tdog_helper->assert_alloc(amark, 0, -1, \
+      tdog::static_str("ASSERT NO ALLOC ( " #exprn " )"), __LINE__); \
+  } while(false)
+#endif
+
+/**
+ * \brief Asserts that the expression allocates no more than the given
+ * number of bytes from the heap.
+ * \details The test fails if allocations made by the expression with
+ * operator new, in the thread running the test, exceed max_bytes in total.
+ * Memory freed by the expression is not deducted.
+ *
+ * Example:
+ *
+ * \code
+ * // Test will fail if encoding allocates more than 1KB
+ * TDOG_ASSERT_ALLOC_LTE( encode_frame(frame, out), 1024 );
+ * \endcode
+ *
+ * As with TDOG_ASSERT_NO_ALLOC(), this requires the TDOG library to be
+ * built with TDOG_ALLOC_TRACKING defined, and otherwise gives a warning.
+ *
+ * Note. This macro can only be used within the scope of a test case.
+ * \param[in] exprn Test expression
+ * \param[in] max_bytes Maximum bytes allocated
+ * \sa TDOG_ASSERT_NO_ALLOC()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_ASSERT_ALLOC_LTE(exprn, max_bytes)
+#else
+  // Actual
+  // The while(false) allows statement to be terminated with semicolon
+  #define TDOG_ASSERT_ALLOC_LTE(exprn, max_bytes) \
+  do { \
+    tdog::alloc_counts amark = tdog_helper->alloc_mark(); \
+    exprn; \
+    tdog_helper->assert_alloc(amark, -1, max_bytes, \
+      tdog::static_str("ASSERT ALLOC <= ( " #exprn " ) " #max_bytes), __LINE__); \
   } while(false)
 #endif
 
@@ -1944,6 +2458,14 @@
  * /trun:* /tdis:test1,suite2::test2
  * \endcode
  *
+ * The "--tjobs N" option sets the maximum number of tests executed
+ * concurrently. See TDOG_SET_PARALLELISM(). The "--tisolate" option
+ * runs tests in isolated worker processes. See TDOG_SET_ISOLATED(). The
+ * "--thistory file" option gives a file of test durations used to
+ * schedule concurrent tests. See TDOG_SET_HISTORY_FILE(). The
+ * "--tbaseline file" option gives a file of benchmark timings against
+ * which benchmarks are compared. See TDOG_SET_BASELINE_FILE().
+ *
  * This macro is also overloaded with the wchar_t type for use with a
  * Windows main function.
  *
@@ -2028,6 +2550,132 @@
   tdog::runner::global().set_sorted(full_sort)
 #endif
 
+/**
+ * \brief Sets the maximum number of test cases which may be executed
+ * concurrently.
+ * \details The default is 1, where tests run serially. Where greater than 1,
+ * tests are executed on a pool of worker threads. Tests named "setup" will
+ * complete before any others in the suite are started, while "teardown" tests
+ * wait for all those before them to finish. Reports are written in the normal
+ * run order.
+ *
+ * Tests which run concurrently must not share unsynchronized state.
+ * A value of 0 will use the number of processors on the system.
+ *
+ * This macro should not be called from within a test.
+ * \param[in] n Number of concurrent test cases
+ * \sa TDOG_RUN_CMD()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_SET_PARALLELISM(n)
+#else
+  // Actual
+  #define TDOG_SET_PARALLELISM(n) \
+  tdog::runner::global().set_parallelism(n)
+#endif
+
+/**
+ * \brief Sets whether tests are executed in isolated worker processes.
+ * \details Where true, tests are executed in forked worker processes,
+ * and a test which crashes is reported as an error giving the signal
+ * name, without ending the run. The number of workers is given by
+ * TDOG_SET_PARALLELISM(). Setup and teardown tests are executed in
+ * the runner process.
+ *
+ * Supported on POSIX platforms only. Elsewhere, it has no effect.
+ *
+ * This macro should not be called from within a test.
+ * \param[in] flag Isolated flag
+ * \sa TDOG_SET_PARALLELISM(), TDOG_RUN_CMD()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_SET_ISOLATED(flag)
+#else
+  // Actual
+  #define TDOG_SET_ISOLATED(flag) \
+  tdog::runner::global().set_isolated(flag)
+#endif
+
+/**
+ * \brief Sets the name of a file used to record test durations between runs.
+ * \details Where tests are executed concurrently, those which took longest
+ * in previous runs are started first. The file is read before the run and
+ * rewritten afterwards. An empty string disables the history.
+ *
+ * This macro should not be called from within a test.
+ * \param[in] filename History filename
+ * \sa TDOG_SET_PARALLELISM(), TDOG_RUN_CMD()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_SET_HISTORY_FILE(filename)
+#else
+  // Actual
+  #define TDOG_SET_HISTORY_FILE(filename) \
+  tdog::runner::global().set_history_file(filename)
+#endif
+
+/**
+ * \brief Sets the name of a file of benchmark timings against which
+ * benchmarks are compared.
+ * \details Each benchmark which passes is compared with its timings in the
+ * file from previous runs, using a statistical test on their distribution.
+ * A significant slowdown fails the test, and a borderline one gives a
+ * warning. Benchmarks not in the file are recorded, and the file is
+ * rewritten after the run. An empty string disables the comparison.
+ *
+ * This macro should not be called from within a test.
+ * \param[in] filename Baseline filename
+ * \sa TDOG_SET_BASELINE_UPDATE(), TDOG_BENCHMARK(), TDOG_RUN_CMD()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_SET_BASELINE_FILE(filename)
+#else
+  // Actual
+  #define TDOG_SET_BASELINE_FILE(filename) \
+  tdog::runner::global().set_baseline_file(filename)
+#endif
+
+/**
+ * \brief Sets whether benchmark baselines are updated.
+ * \details Where true, benchmarks are not compared with the baseline file,
+ * but their timings replace those held in it.
+ *
+ * This macro should not be called from within a test.
+ * \param[in] flag Update flag
+ * \sa TDOG_SET_BASELINE_FILE()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_SET_BASELINE_UPDATE(flag)
+#else
+  // Actual
+  #define TDOG_SET_BASELINE_UPDATE(flag) \
+  tdog::runner::global().set_baseline_update(flag)
+#endif
+
+/**
+ * \brief Sets whether hardware counters are taken around each test.
+ * \details Where true, CPU cycles, instructions, cache misses and branch
+ * misses are counted over each test, and given in verbose reports. Where
+ * the platform or system does not permit it, tests run without counts.
+ *
+ * This macro should not be called from within a test.
+ * \param[in] flag Counters flag
+ * \sa TDOG_STATISTIC_COUNT()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_SET_HW_COUNTERS(flag)
+#else
+  // Actual
+  #define TDOG_SET_HW_COUNTERS(flag) \
+  tdog::runner::global().set_hw_counters(flag)
+#endif
+
 /**
  * \brief Sets the name string for the software under test.
  * \details Use to give the test project a name (typically your software's name) prior to
@@ -2202,6 +2850,35 @@
   tdog::runner::global().set_default_report(style)
 #endif
 
+/**
+ * \brief Sets whether the report written to STDOUT is generated on a
+ * separate thread.
+ * \details Where true, completed tests are passed to a dedicated reporter
+ * thread, which formats and writes them while the next tests execute. The
+ * content and order of the report is unchanged, and it is complete before
+ * the run returns. The default is false.
+ *
+ * Example:
+ *
+ * \code
+ * TDOG_SET_ASYNC_REPORT(true);
+ * ...
+ * TDOG_RUN("*");
+ * \endcode
+ *
+ * This macro should not be called from within a test.
+ * \param[in] flag Asynchronous report flag
+ * \sa TDOG_SET_DEFAULT_REPORT()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_SET_ASYNC_REPORT(flag)
+#else
+  // Actual
+  #define TDOG_SET_ASYNC_REPORT(flag) \
+  tdog::runner::global().set_async_report(flag)
+#endif
+
 /**
  * \brief Causes an additional report to be written to file automatically
  * at the conclusion of the test run.
@@ -2261,6 +2938,32 @@
   tdog::runner::global().add_report(style, filename)
 #endif
 
+/**
+ * \brief Saves the results of the last test run to a binary file.
+ * \details Reports can be generated from the file later, without running
+ * the tests again, using the "tdogrpt" tool or tdog::runner::load_results().
+ *
+ * Example:
+ *
+ * \code
+ * TDOG_RUN("*");
+ * TDOG_SAVE_RESULTS("./test-results.tdr");
+ * \endcode
+ *
+ * This macro should be called after the test run, and not from within a test.
+ * \param[in] filename Output filename string
+ * \return True on success
+ * \sa TDOG_ADD_REPORT()
+ */
+#if defined(DOXYGEN_HIDEIMPL)
+  // Doc dummy
+  #define TDOG_SAVE_RESULTS(filename)
+#else
+  // Actual
+  #define TDOG_SAVE_RESULTS(filename) \
+  tdog::runner::global().save_results(filename)
+#endif
+
 /**
  * @}
  * @name Accessing statistics
@@ -2283,7 +2986,15 @@
  * - tdog::CNT_ASSERT_TOTAL - Total number of assert statements
  * - tdog::CNT_ASSERT_FAILED - Number of assert failures
  * - tdog::CNT_DURATION - Duration in milliseconds
+ * - tdog::CNT_CYCLES - CPU cycles
+ * - tdog::CNT_INSTRUCTIONS - Instructions retired
+ * - tdog::CNT_CACHE_MISSES - Last level cache misses
+ * - tdog::CNT_BRANCH_MISSES - Mispredicted branches
  * .
+ * The hardware counts are taken only where enabled with
+ * TDOG_SET_HW_COUNTERS(), and are totals of those tests for which
+ * counts were available. Otherwise, they are 0.
+ *
  * Either a single test case or suite name may be specified, and will match tests
  * according to the following rules:
  *
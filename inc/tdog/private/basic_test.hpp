@@ -31,11 +31,24 @@
 // Namespace
 namespace tdog {
 
+class basic_shared;
+
 //---------------------------------------------------------------------------
 // CLASS basic_test
 //---------------------------------------------------------------------------
 class basic_test
 {
+  public:
+
+  // Sort key, computed once on construction
+  // so that sorting does not allocate.
+  struct sort_key
+  {
+    int rank; // <- 0 setup, 1 test, 2 teardown
+    std::string suite_lower;
+    std::string name_lower;
+  };
+
   private:
 
   std::string m_test_name;
@@ -47,11 +60,29 @@ class basic_test
   test_type_t m_test_type;
   std::string m_user_typename;
   std::string m_repeat_typename;
+  sort_key m_sort_key;
+
+  void _init(const std::string& sname, const std::string& tname,
+    test_type_t ttype, const std::string& fname, int lnum,
+    const std::string& utype, const std::string& rtype);
 
   protected:
 
   run_helper m_helper;
 
+  // Suite shared fixture used, or null
+  basic_shared* m_shared;
+
+  // Construction with explicit suite name. The
+  // test is not registered with the global runner.
+  basic_test(const std::string& sname, // <- suite name
+    const std::string& tname, // <- test name
+    test_type_t ttype,  // <- test type
+    const std::string& fname, // <- filename
+    int lnum,   // <- line number
+    const std::string& utype,   // <- user typename
+    const std::string& rtype);  // <- repeated test typename
+
   // Must be implemented in typed concrete class.
   virtual void _run_unprotected() = 0;
 
@@ -67,14 +98,18 @@ class basic_test
   virtual ~basic_test();
 
   // Properties
-  std::string test_name() const;
-  std::string suite_name() const;
-  std::string full_name() const;
+  const std::string& test_name() const;
+  const std::string& suite_name() const;
+  const std::string& full_name() const;
   const char* full_name_cstr();
   bool is_setup() const;
   bool is_teardown() const;
+  const sort_key& key() const;
   std::string file_location() const;
+  const std::string& filename() const;
+  int line_num() const;
   test_type_t test_type() const;
+  basic_shared* shared() const;
   std::string user_typename() const;
   std::string repeat_typename() const;
   void set_skipped();
@@ -84,11 +119,22 @@ class basic_test
   // Get the helper
   const run_helper& helper() const;
 
+  // Result transfer, i.e. from a worker process
+  void encode_results(std::string& out) const;
+  bool decode_results(const char* data, std::size_t size);
+  void set_aborted(const std::string& s, const std::string& ename,
+    tdog::i64_t start, tdog::i64_t dur, event_type_t t = ET_ERROR);
+  void post_event(const std::string& s, event_type_t t);
+
+  // Time limit watcher, i.e. the watchdog
+  void set_watcher(limit_watcher* w, std::size_t key);
+
   // Name equality
   bool name_equals(const std::string& name, bool precise) const;
 
-  // The public run method
-  void run(tdog::i64_t glimit = 0, tdog::i64_t gwarn = 0);
+  // The public run method. Where counters is true,
+  // hardware counts are taken around the test body.
+  void run(tdog::i64_t glimit = 0, tdog::i64_t gwarn = 0, bool counters = false);
 };
 
 } // namespace
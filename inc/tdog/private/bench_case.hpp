@@ -0,0 +1,92 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : bench_case.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_BENCH_CASE_H
+#define TDOG_BENCH_CASE_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "basic_test.hpp"
+
+#include <string>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS bench_case
+//---------------------------------------------------------------------------
+template <class CONTYPE>
+class bench_case : public basic_test
+{
+  private:
+
+  // Allowed to create new, but not copy.
+  bench_case(bench_case const&);
+  bench_case& operator=(bench_case const&);
+
+  // Calls the body by qualified name, so
+  // that it may be inlined into the loop.
+  class batch : public bench_batch
+  {
+    private:
+
+    CONTYPE& m_container;
+
+    public:
+
+    batch(CONTYPE& c) : m_container(c) {}
+
+    virtual void run(tdog::i64_t cnt)
+    {
+      for(tdog::i64_t n = 0; n < cnt; ++n)
+      {
+        m_container.CONTYPE::tdog_impl();
+      }
+    }
+  };
+
+  protected:
+
+  // Implement virtual method
+  virtual void _run_unprotected()
+  {
+    // As test_case, but the helper runs the body
+    // in timed batches. Exceptions are caught by
+    // basic_test, as for other tests.
+    CONTYPE container(&m_helper);
+    batch b(container);
+
+    m_helper.run_benchmark(b);
+  }
+
+  public:
+
+  // Construction
+  bench_case(const std::string& tname, // <- test name
+    const std::string& fname,   // <- filename
+    int lnum)   // <- line number
+    : basic_test(tname, TT_BENCHMARK, fname, lnum) {}
+
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
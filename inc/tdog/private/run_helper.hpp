@@ -39,19 +39,265 @@ enum event_type_t
   ET_WARN       // <- user warning
 };
 
+// Pointer to static text, i.e. a string literal built
+// by an assert macro. Held by reference, not copied.
+struct static_str
+{
+  const char* ptr;
+  explicit static_str(const char* p) : ptr(p) {}
+};
+
+// Message passed to asserts. Holds either static
+// text from an assert macro, or a user message.
+class assert_msg
+{
+  private:
+
+  const char* m_lit;
+  std::string m_str;
+
+  public:
+
+  assert_msg(static_str s) : m_lit(s.ptr) {}
+  assert_msg(const char* s) : m_lit(0), m_str(s != 0 ? s : "") {}
+  assert_msg(const std::string& s) : m_lit(0), m_str(s) {}
+
+  const char* literal() const { return m_lit; }
+  std::string str() const { return (m_lit != 0) ? std::string(m_lit) : m_str; }
+};
+
+// Passes with the same text from the same line are held as a
+// single item with a repeat count, so that asserts in a loop do
+// not grow the log. Where a run of passes repeats as a whole, i.e.
+// a loop of several asserts, it is held once and the first item
+// gives its length and no. of cycles. Reporters write each item
+// "repeat" times, and each block "cycles" times, when verbose.
 struct event_item
 {
-  std::string msg_str;    // <- message string
+  std::string msg_str;    // <- message string, or...
+  const char* msg_lit;    // <- static message text (if not null)
   event_type_t item_type; // <- type of item
   int line_num;           // <- line no. where msg was generated
+  int repeat;             // <- no. of consecutive identical events
+  int block;              // <- no. of items in block starting here, or 0
+  int cycles;             // <- no. of times block occurs in order
 
-  // Constructor
+  // Constructors
   event_item(const std::string& mstr = std::string(), event_type_t t = ET_PASS,
-    int lnum = 0) : msg_str(mstr), item_type(t), line_num(lnum) {}
+    int lnum = 0, int rep = 1) : msg_str(mstr), msg_lit(0), item_type(t),
+    line_num(lnum), repeat(rep), block(0), cycles(1) {}
+  event_item(static_str mlit, event_type_t t, int lnum)
+    : msg_lit(mlit.ptr), item_type(t), line_num(lnum), repeat(1),
+    block(0), cycles(1) {}
+
+  // Message string, built on demand
+  std::string msg() const { return (msg_lit != 0) ? std::string(msg_lit) : msg_str; }
 };
 
 typedef std::vector<event_item> event_vector;
 
+// Benchmark figures, per iteration of the test body. Times
+// are in ns, taken from samples of "batch" iterations each.
+// The samples themselves are kept for baseline comparison.
+struct bench_result
+{
+  tdog::i64_t batch;    // <- iterations per sample
+  int samples;          // <- no. of timed samples
+  double median_ns;     // <- median time
+  double p90_ns;        // <- 90th percentile
+  double p99_ns;        // <- 99th percentile
+  double mad_ns;        // <- median absolute deviation
+  std::vector<double> sample_ns;  // <- sorted samples
+
+  bench_result() : batch(0), samples(0), median_ns(0), p90_ns(0),
+    p99_ns(0), mad_ns(0) {}
+
+  // True if figures were taken
+  bool valid() const { return samples > 0; }
+
+  // Iterations per second, from the median
+  double ops_per_sec() const { return (median_ns > 0) ? 1.0e9 / median_ns : 0; }
+};
+
+// Hardware counter deltas over a test run. Each is -1
+// where the counter could not be read, i.e. not permitted.
+struct hw_counts
+{
+  tdog::i64_t cycles;         // <- CPU cycles
+  tdog::i64_t instructions;   // <- instructions retired
+  tdog::i64_t cache_misses;   // <- last level cache misses
+  tdog::i64_t branch_misses;  // <- mispredicted branches
+
+  hw_counts() : cycles(-1), instructions(-1), cache_misses(-1),
+    branch_misses(-1) {}
+
+  // True if any counter was read
+  bool valid() const { return cycles >= 0 || instructions >= 0 ||
+    cache_misses >= 0 || branch_misses >= 0; }
+};
+
+// Heap allocations made by the test thread, where the library
+// is built with TDOG_ALLOC_TRACKING. Otherwise, each is -1.
+struct alloc_counts
+{
+  tdog::i64_t count;        // <- no. of allocations
+  tdog::i64_t bytes;        // <- total bytes allocated
+  tdog::i64_t peak_bytes;   // <- peak live bytes, from start
+
+  alloc_counts() : count(-1), bytes(-1), peak_bytes(-1) {}
+
+  // True if allocations were counted
+  bool valid() const { return count >= 0; }
+};
+
+// Runs a benchmark body a number of times. Implemented
+// by bench_case, so that the loop calls the body directly.
+class bench_batch
+{
+  public:
+
+  virtual ~bench_batch() {}
+  virtual void run(tdog::i64_t cnt) = 0;
+};
+
+// Takes the address of a value, so that the compiler
+// cannot discard the computation which produced it.
+void bench_escape(const volatile void* ptr);
+
+// See TDOG_DO_NOT_OPTIMIZE()
+template <typename T>
+inline void do_not_optimize(const T& val)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&val) : "memory");
+#else
+  bench_escape(&val);
+#endif
+}
+
+// Element types which are equal exactly where their bytes are,
+// so that arrays of them may be compared as memory. Floating
+// point types are not, as 0.0 == -0.0 and NaN != NaN. May be
+// specialised for user types without padding, i.e. packed structs.
+template <typename T>
+struct bytewise_comparable { static const bool value = false; };
+
+template <typename T>
+struct bytewise_comparable<const T> : bytewise_comparable<T> {};
+
+template <typename T>
+struct bytewise_comparable<T*> { static const bool value = true; };
+
+#define TDOG_BYTEWISE_TYPE(T) \
+  template <> struct bytewise_comparable<T> { static const bool value = true; }
+
+TDOG_BYTEWISE_TYPE(char);
+TDOG_BYTEWISE_TYPE(signed char);
+TDOG_BYTEWISE_TYPE(unsigned char);
+TDOG_BYTEWISE_TYPE(wchar_t);
+TDOG_BYTEWISE_TYPE(short);
+TDOG_BYTEWISE_TYPE(unsigned short);
+TDOG_BYTEWISE_TYPE(int);
+TDOG_BYTEWISE_TYPE(unsigned int);
+TDOG_BYTEWISE_TYPE(long);
+TDOG_BYTEWISE_TYPE(unsigned long);
+#if defined(TDOG_CSTDINT) || defined(__GNUC__) || defined(_MSC_VER)
+TDOG_BYTEWISE_TYPE(long long);
+TDOG_BYTEWISE_TYPE(unsigned long long);
+#endif
+
+#undef TDOG_BYTEWISE_TYPE
+
+// True where arrays of TA and TB may be compared as memory
+template <typename TA, typename TB>
+struct bytewise_pair { static const bool value = false; };
+
+template <typename T>
+struct bytewise_pair<T, T> { static const bool value = bytewise_comparable<T>::value; };
+
+template <typename T>
+struct bytewise_pair<const T, T> : bytewise_pair<T, T> {};
+
+template <typename T>
+struct bytewise_pair<T, const T> : bytewise_pair<T, T> {};
+
+template <typename T>
+struct bytewise_pair<const T, const T> : bytewise_pair<T, T> {};
+
+// Overload selection on a constant
+template <bool B>
+struct bool_tag {};
+
+// Offset of the first byte which differs, or npos where
+// none do. Uses AVX2 or SSE2 where the CPU supports it.
+std::size_t mem_mismatch(const void* a, const void* b, std::size_t bytes);
+
+// Tolerance of floating point array compares. Values are within
+// tolerance where: |act - exp| <= tol (absolute), |act - exp| <=
+// tol * |exp| (relative), or are no more than tol representable
+// values apart (ULP). Equal values, including infinities, are
+// always within, and NaN never is.
+enum tol_t
+{
+  TOL_ABS = 0,
+  TOL_REL,
+  TOL_ULP
+};
+
+// Result of a floating point array compare. The statistics are
+// given only where there are mismatches, and worst is the index
+// of the largest error in the mode of the compare. Where either
+// value is NaN, the ULP distance is the maximum, i.e. ~0.
+struct float_diff
+{
+  std::size_t mismatches;
+  std::size_t worst;
+  double max_abs;
+  double max_rel;
+  tdog::u64_t max_ulp;
+
+  float_diff() : mismatches(0), worst(0), max_abs(0), max_rel(0), max_ulp(0) {}
+};
+
+// Compare arrays of cnt elements. Uses SSE2 where available.
+float_diff float_compare(const double* exp, const double* act,
+  std::size_t cnt, tol_t mode, double tol);
+float_diff float_compare(const float* exp, const float* act,
+  std::size_t cnt, tol_t mode, double tol);
+
+// Result of a file compare. Where the contents differ, offset is
+// that of the first differing byte (or the end of the shorter),
+// with its line and column counted from 1.
+struct file_diff
+{
+  std::string error;
+  tdog::i64_t offset;
+  tdog::i64_t line;
+  tdog::i64_t column;
+  tdog::i64_t exp_size;
+  tdog::i64_t act_size;
+
+  file_diff() : offset(-1), line(0), column(0), exp_size(0), act_size(0) {}
+};
+
+// Compare file contents with another file, or with a buffer. Files
+// are mapped a window at a time, so that memory use does not
+// depend on their size. Error is set if a file cannot be read.
+file_diff file_compare(const std::string& exp_file, const std::string& act_file);
+file_diff file_compare(const std::string& exp_file, const void* act, std::size_t size);
+
+// Told of the time limit of a running test whenever it changes, on
+// the test's own thread, so that a thread watching the test does not
+// read the limit while the test may be writing it. Key is as given
+// to run_helper::set_watcher().
+class limit_watcher
+{
+  public:
+
+  virtual ~limit_watcher() {}
+  virtual void limit_changed(std::size_t key, tdog::i64_t ms) = 0;
+};
+
 //---------------------------------------------------------------------------
 // CLASS run_helper
 //---------------------------------------------------------------------------
@@ -64,33 +310,81 @@ class run_helper
   int m_assert_cnt;
   int m_assert_fails;
   tdog::i64_t m_start_time;
+  tdog::i64_t m_start_mono;
   tdog::i64_t m_duration;
+  tdog::i64_t m_check_last;
+  int m_check_stride;
+  int m_check_count;
   tdog::i64_t m_time_limit;
   tdog::i64_t m_global_limit;
   tdog::i64_t m_warning_limit;
   bool m_time_warn_flag;
   bool m_continue_on_fail;
+  bool m_bench_quiet;
   std::string m_author;
+  bench_result m_bench;
+  hw_counts m_counts;
+  alloc_counts m_allocs;
 
   // Hold list of events
   event_vector m_event_log;
 
-  // We use this to hold a list
-  // mapping our own integer tag
-  // specifiers to standard printf ones
-  struct itag
+  // Pass being logged, by line and text
+  struct pass_key
   {
-    std::string tag;
-    std::string spec;
-    itag(const std::string& t, const std::string& s)
-      : tag(t), spec(s) {}
+    int line;
+    const char* lit;
+    std::string str;
+
+    pass_key(int l, const char* p, const std::string& s = std::string())
+      : line(l), lit(p), str(s) {}
+    bool matches(const event_item& e) const;
   };
 
-  std::vector<itag> m_itag_vect;
+  // Block of passes repeating at the tail of the log, from
+  // m_cycle_start (npos if none). Its next cycle has matched
+  // m_cycle_cnt of item m_cycle_pos so far. Items before
+  // m_pass_floor are not counted into by later passes.
+  std::size_t m_pass_floor;
+  std::size_t m_cycle_start;
+  std::size_t m_cycle_pos;
+  int m_cycle_cnt;
+
+  // Output of printf(), reused so as
+  // to keep its capacity between calls
+  std::string m_fmt_buf;
+
+  // Watcher of time limit, or null
+  limit_watcher* m_watcher;
+  std::size_t m_watch_key;
+
+  // Results changed, other than while running
+  void _changed();
+
+  // Tell watcher of limit in force
+  void _limit_changed();
 
   // Event state with message
+  void _update_status(event_type_t t, const std::string& ename);
   void _print_event(std::string s, event_type_t t, int lnum = 0,
     const std::string& ename = std::string());
+  void _print_event(static_str s, event_type_t t, int lnum);
+
+  // Add pass to event log, counting repeats, or another item
+  void _log_pass(const pass_key& k);
+  void _log_item(const event_item& e);
+
+  // Repeating block of passes, matched in order
+  bool _find_cycle();
+  bool _cycle_pass(const pass_key& k);
+  void _end_cycle();
+
+  // Time limit check after an event. Samples the
+  // clock less often when events are frequent.
+  bool _sample_time_limit(int lnum);
+
+  // True if benchmark sampling should go on
+  bool _bench_continue();
 
   // Underlying common print statement implementations.
   void _printf_int(const std::string& s, tdog::i64_t val, int lnum = 0);
@@ -101,7 +395,7 @@ class run_helper
 
   // Internal assert - has return value (derivatives
   // do not). Derived asserts should call this.
-  bool _assert_impl(bool condition, bool eq, const std::string& s, int lnum);
+  bool _assert_impl(bool condition, bool eq, const assert_msg& s, int lnum);
 
   // Compare used by assert_stric
   template <typename T>
@@ -122,14 +416,44 @@ class run_helper
   int fail_cnt() const;
   tdog::i64_t start_time() const;
   tdog::i64_t duration() const;
+  tdog::i64_t duration_ns() const;
+  tdog::i64_t limit_in_force() const;
   bool has_ran() const;
   bool has_failed() const;
   bool has_passed() const;
+  bool running() const;
+
+  // Tests whose results changed after sequence no. seq, in any
+  // runner, other than while running. Sets seq to the current
+  // no. Returns false if too many to be held, i.e. all changed.
+  static bool changed_since(tdog::u64_t& seq,
+    std::vector<const run_helper*>& out);
   std::string author() const;
+  const bench_result& bench() const;
+  const hw_counts& counts() const;
+  const alloc_counts& allocs() const;
 
   // Access to test log
   const event_vector& event_log() const;
 
+  // Result transfer, i.e. from a worker process
+  void encode(std::string& out) const;
+  bool decode(const char* data, std::size_t size);
+  void set_aborted(const std::string& s, const std::string& ename,
+    tdog::i64_t start, tdog::i64_t dur, event_type_t t = ET_ERROR);
+
+  // Event added once the test has run, i.e. by the runner
+  // on comparing results. Updates status as for a test.
+  void post_event(const std::string& s, event_type_t t);
+
+  // Hardware counts and allocations, taken around the test run
+  void set_counts(const hw_counts& c);
+  void set_allocs(const alloc_counts& a);
+
+  // Watcher told of limit_in_force() from now on, until
+  // reset with null. Must be set from the test's thread.
+  void set_watcher(limit_watcher* w, std::size_t key);
+
   // ---------------------------
   // TEST CASE CALLS
   // ---------------------------
@@ -141,6 +465,10 @@ class run_helper
   void set_continue_on_fail(bool flag);
   void sleep(int ms);
 
+  // Time the body in calibrated batches after a warmup,
+  // and hold the figures. Used by TDOG_BENCHMARK().
+  void run_benchmark(bench_batch& body);
+
   // Check time not execeed.
   // Will log error if true.
   bool check_time_limit(int lnum = 0);
@@ -191,17 +519,31 @@ class run_helper
   // TEST ASSERT STATEMENTS
   // ---------------------------
 
-  void assert_true(bool condition, bool eq, const std::string& s, int lnum);
+  // Messages given by assert macros are static text, which
+  // is not copied into a string unless the assert fails.
+  void assert_true(bool condition, bool eq, const assert_msg& s, int lnum);
   void assert_double_equal(const double& exp, const double& act,
-    bool eq, const double& delta, const std::string& s, int lnum);
+    bool eq, const double& delta, const assert_msg& s, int lnum);
   void assert_stric_equal(const std::string& exp, const std::string& act,
-    bool eq, const std::string& s, int lnum);
+    bool eq, const assert_msg& s, int lnum);
   void assert_stric_equal(const std::wstring& exp, const std::wstring& act,
-    bool eq, const std::string& s, int lnum);
+    bool eq, const assert_msg& s, int lnum);
+
+  // File contents equal to those of another file, or a buffer
+  void assert_file_equal(const std::string& exp_file, const std::string& act_file,
+    const assert_msg& s, int lnum);
+  void assert_file_equal(const std::string& exp_file, const void* act,
+    std::size_t size, const assert_msg& s, int lnum);
+
+  // Allocations made by the calling thread since the mark, which are
+  // not to exceed the given count or bytes. A limit of -1 is ignored.
+  alloc_counts alloc_mark() const;
+  void assert_alloc(const alloc_counts& mark, tdog::i64_t max_cnt,
+    tdog::i64_t max_bytes, const assert_msg& s, int lnum);
 
   // Generic types need to be defined in header
   template<typename TA, typename TB>
-  void assert_equal(TA exp, TB act, bool eq, const std::string& s, int lnum) {
+  void assert_equal(TA exp, TB act, bool eq, const assert_msg& s, int lnum) {
     if ( !_assert_impl( (exp == act), eq, s, lnum ) ) {
       if (eq) printf("-exp = %g", exp, 0);
       else printf("-nxp = %g", exp, 0);
@@ -209,49 +551,113 @@ class run_helper
     }
   }
   template<typename TA, typename TB>
-  void assert_less_than(TA act, TB lim, bool eq, const std::string& s, int lnum) {
+  void assert_less_than(TA act, TB lim, bool eq, const assert_msg& s, int lnum) {
     if ( !_assert_impl( ((act < lim) || (eq && act == lim)), true, s, lnum ) ) {
       printf("-act = %g", act, 0);
       printf("-lim = %g", lim, 0);
     }
   }
   template<typename TA, typename TB>
-  void assert_greater_than(TA act, TB lim, bool eq, const std::string& s, int lnum) {
+  void assert_greater_than(TA act, TB lim, bool eq, const assert_msg& s, int lnum) {
     if ( !_assert_impl( ((act > lim) || (eq && act == lim)), true, s, lnum ) ) {
       printf("-act = %g", act, 0);
       printf("-lim = %g", lim, 0);
     }
   }
 
+  // Index of first element which differs, or cnt if none.
+  // Element types which allow it are compared as memory.
+  template<typename TA, typename TB>
+  static std::size_t _array_mismatch(TA* const exp, TB* const act,
+    std::size_t cnt, bool_tag<false>) {
+    for(std::size_t n = 0; n < cnt; ++n)
+      if (exp[n] != act[n]) return n;
+    return cnt;
+  }
+  template<typename TA, typename TB>
+  static std::size_t _array_mismatch(TA* const exp, TB* const act,
+    std::size_t cnt, bool_tag<true>) {
+    std::size_t pos = mem_mismatch(exp, act, cnt * sizeof(TA));
+    return (pos != std::string::npos) ? pos / sizeof(TA) : cnt;
+  }
+
+  // Writes index of first difference, and
+  // the bytes around it where given.
+  void _print_mismatch(std::size_t idx, const void* exp, const void* act,
+    std::size_t esize, std::size_t cnt);
+
+  // Common to file asserts
+  void _assert_file(const file_diff& d, const assert_msg& s, int lnum);
+
+  // Common to floating point array asserts
+  void _assert_close(bool valid, const float_diff& d, double exp, double act,
+    tol_t mode, double tol, const char* fmt, const assert_msg& s, int lnum);
+
   // Array assert equal
   // We can do some pointer checking with this
   template<typename TA, typename TB>
   void assert_array_equal(TA* const exp, TB* const act, bool eq,
-    std::size_t cnt, const std::string& s, int lnum = 0) {
+    std::size_t cnt, const assert_msg& s, int lnum = 0) {
 
     int rslt = 0;
     if ((exp != act) && (exp == 0 || act == 0)) rslt = -1;
     if (cnt != 0 && (exp == 0 || act == 0)) rslt = -1;
 
-    for(std::size_t n = 0; (n < cnt && rslt == 0); ++n)
-      if (exp[n] != act[n]) rslt = 1;
+    typedef bool_tag<bytewise_pair<TA, TB>::value> tag_t;
+    std::size_t idx = cnt;
+    if (rslt == 0 && exp != act) idx = _array_mismatch(exp, act, cnt, tag_t());
+    if (idx < cnt) rslt = 1;
 
      if (rslt == -1) {
        _assert_impl(false, true, s, lnum); // <- force fail irrespective of eq
        _printf_str("-error: invalid null pointer", "", 0);
-     } else {
-       _assert_impl((rslt == 0), eq, s, lnum);
+     } else
+     if (!_assert_impl((rslt == 0), eq, s, lnum) && eq) {
+       _print_mismatch(idx, exp, act, bytewise_pair<TA, TB>::value ? sizeof(TA) : 0, cnt);
      }
   }
 
   // Container assert equal
   template<typename TA, typename TB>
   void assert_array_equal(const TA& exp, const TB& act, bool eq, std::size_t cnt,
-    const std::string& s, int lnum = 0) {
-    bool rslt = true;
-    for(std::size_t n = 0; (n < cnt && rslt); ++n)
-      if (exp[n] != act[n]) rslt = false;
-    _assert_impl(rslt, eq, s, lnum);
+    const assert_msg& s, int lnum = 0) {
+    std::size_t idx = cnt;
+    for(std::size_t n = 0; (n < cnt && idx == cnt); ++n)
+      if (exp[n] != act[n]) idx = n;
+    if (!_assert_impl((idx == cnt), eq, s, lnum) && eq) _print_mismatch(idx, 0, 0, 0, cnt);
+  }
+  void assert_array_equal(const std::vector<bool>& exp, const std::vector<bool>& act,
+    bool eq, std::size_t cnt, const assert_msg& s, int lnum = 0) {
+    assert_array_equal<std::vector<bool>, std::vector<bool> >(exp, act, eq, cnt, s, lnum);
+  }
+
+  // Floating point arrays to within tolerance. A single assert is
+  // given, which reports the number of mismatches and the worst.
+  void assert_array_close(const double* exp, const double* act, std::size_t cnt,
+    tol_t mode, double tol, const assert_msg& s, int lnum);
+  void assert_array_close(const float* exp, const float* act, std::size_t cnt,
+    tol_t mode, double tol, const assert_msg& s, int lnum);
+  template<typename T>
+  void assert_array_close(const std::vector<T>& exp, const std::vector<T>& act,
+    std::size_t cnt, tol_t mode, double tol, const assert_msg& s, int lnum) {
+    if (exp.size() < cnt || act.size() < cnt) {
+      _assert_impl(false, true, s, lnum);
+      _printf_str("-error: size less than count", "", 0);
+    } else
+    if (cnt != 0) assert_array_close(&exp[0], &act[0], cnt, mode, tol, s, lnum);
+    else _assert_impl(true, true, s, lnum);
+  }
+
+  // Vectors are contiguous, so are compared as arrays
+  template<typename T>
+  void assert_array_equal(const std::vector<T>& exp, const std::vector<T>& act,
+    bool eq, std::size_t cnt, const assert_msg& s, int lnum = 0) {
+    if (exp.size() < cnt || act.size() < cnt) {
+      _assert_impl(false, true, s, lnum); // <- force fail irrespective of eq
+      _printf_str("-error: size less than count", "", 0);
+    } else
+    if (cnt != 0) assert_array_equal(&exp[0], &act[0], eq, cnt, s, lnum);
+    else _assert_impl(true, eq, s, lnum);
   }
 
 };
@@ -0,0 +1,212 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : shared_fixture.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_SHARED_FIXTURE_H
+#define TDOG_SHARED_FIXTURE_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "basic_test.hpp"
+#include "suite_manager.hpp"
+
+#include <string>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// A fixture object shared by the tests of a suite. The runner creates it
+// before the first test which uses it, and destroys it after the last, so
+// that it exists once however many tests use it. Tests are given const
+// access only, as they may run concurrently. Where tests run in worker
+// processes, each worker has a copy of the object as it was when the
+// worker was forked.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS basic_shared
+//---------------------------------------------------------------------------
+class basic_shared
+{
+  private:
+
+  std::string m_name;
+  bool m_ready;
+
+  // No copy
+  basic_shared(const basic_shared&);
+  basic_shared& operator=(const basic_shared&);
+
+  protected:
+
+  // Construct and call setup(), returning its result.
+  // Destroy calls teardown() where setup() succeeded.
+  // Either may throw.
+  virtual bool _create() = 0;
+  virtual void _destroy() = 0;
+
+  public:
+
+  // Named after the type in the current suite
+  basic_shared(const std::string& utype)
+    : m_name(suite_manager::current()), m_ready(false)
+  {
+    const std::size_t NSZ = std::string(NSSEP).size();
+    if (m_name.substr(0, NSZ) == NSSEP) m_name.erase(0, NSZ);
+    if (!m_name.empty()) m_name += NSSEP;
+    m_name += utype;
+  }
+
+  virtual ~basic_shared() {}
+
+  const std::string& name() const { return m_name; }
+
+  // True where created and set up
+  bool ready() const { return m_ready; }
+
+  // Called by the runner. Create returns false
+  // if setup() fails, and either may throw.
+  bool create()
+  {
+    destroy();
+    m_ready = _create();
+    return m_ready;
+  }
+
+  void destroy()
+  {
+    if (m_ready)
+    {
+      m_ready = false;
+      _destroy();
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// CLASS shared_fixture
+//---------------------------------------------------------------------------
+template <class T>
+class shared_fixture : public basic_shared
+{
+  private:
+
+  T* m_obj;
+
+  protected:
+
+  virtual bool _create()
+  {
+    m_obj = new T();
+
+    try
+    {
+      if (m_obj->setup()) return true;
+    }
+    catch(...)
+    {
+      delete m_obj;
+      m_obj = 0;
+      throw;
+    }
+
+    delete m_obj;
+    m_obj = 0;
+    return false;
+  }
+
+  virtual void _destroy()
+  {
+    // Deleted even if teardown() throws
+    T* p = m_obj;
+    m_obj = 0;
+
+    try
+    {
+      p->teardown();
+    }
+    catch(...)
+    {
+      delete p;
+      throw;
+    }
+
+    delete p;
+  }
+
+  public:
+
+  shared_fixture(const std::string& utype)
+    : basic_shared(utype), m_obj(0) {}
+
+  virtual ~shared_fixture()
+  {
+    delete m_obj;
+  }
+
+  // Valid only where ready()
+  const T& get() const { return *m_obj; }
+};
+
+//---------------------------------------------------------------------------
+// CLASS shared_test
+//---------------------------------------------------------------------------
+template <class CONTYPE>
+class shared_test : public basic_test
+{
+  private:
+
+  // Allowed to create new, but not copy.
+  shared_test(shared_test const&);
+  shared_test& operator=(shared_test const&);
+
+  protected:
+
+  // Implement virtual method
+  virtual void _run_unprotected()
+  {
+    // As test_case, but is an error where
+    // the shared fixture was not set up.
+    if (!m_shared->ready())
+    {
+      m_helper.raise_error("Shared fixture " + m_shared->name() + " not set up", 0, "");
+      return;
+    }
+
+    CONTYPE container(&m_helper);
+    container.tdog_impl();
+  }
+
+  public:
+
+  // Construction
+  shared_test(const std::string& tname, // <- test name
+    basic_shared* shared, // <- shared fixture
+    const std::string& fname,   // <- filename
+    int lnum,   // <- line number
+    const std::string& utype)   // <- user typename
+    : basic_test(tname, TT_SHARED, fname, lnum, utype)
+  {
+    m_shared = shared;
+  }
+
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
@@ -50,6 +50,11 @@ namespace tdog {
 class basic_test;
 class basic_reporter;
 class test_list;
+class stat_index;
+class bench_baseline;
+class watchdog;
+class hang_exit;
+struct result_info;
 
 //---------------------------------------------------------------------------
 // CLASS runner
@@ -74,6 +79,7 @@ class runner
   std::string m_project_version;
   std::string m_project_desc;
   report_style_t m_report_style;
+  bool m_async_report;
   std::string m_report_charset;
   std::string m_html_stylesheet;
   bool m_sorted;
@@ -83,14 +89,25 @@ class runner
   bool m_has_suites;
   tdog::i64_t m_global_time_limit;
   tdog::i64_t m_global_time_warn;
+  int m_parallelism;
+  bool m_isolated;
+  std::string m_history_file;
+  std::string m_baseline_file;
+  bool m_baseline_update;
+  bool m_hw_counters;
+  bool m_watchdog_stacks;
+  bool m_watchdog_exit;
   int m_run_rslt;
   bool m_immutable;
   mutable bool m_decl_flag;
   std::vector<std::string> m_decl_errors;
+  bool m_loaded;
+  std::string m_hostname;
 
   // Use pointer so we don't need to
   // expose test_list include file.
   test_list* m_list_ptr;
+  stat_index* m_stats_ptr;
 
   struct auto_report
   {
@@ -102,6 +119,14 @@ class runner
   bool _exists(const std::string& s, const std::vector<std::string>& v) const;
   std::vector<std::string> _split_names(std::string names) const;
   basic_reporter* _create_reporter(report_style_t style) const;
+  void _run_group(const std::vector<basic_test*>& group,
+    const std::vector<tdog::i64_t>& costs, watchdog* wd);
+  void _end_reports(basic_reporter* reporter, bool deferred);
+  void _adopt_results(const result_info& info, const std::vector<basic_test*>& tests);
+  bool _check_baseline(bench_baseline& base, basic_test* tc) const;
+
+  // Ends the run when a test hangs
+  friend class hang_exit;
 
   // Allowed to create new, but not copy.
   runner(runner const&);
@@ -112,7 +137,8 @@ class runner
   // Make this protected, because we
   // want to unit test it in a fixture
   template <typename T> bool _run_parse(int argc, const T* argv[],
-    std::string& run_out, std::string& dis_out) const;
+    std::string& run_out, std::string& dis_out, int* jobs_out = 0,
+    bool* iso_out = 0, std::string* hist_out = 0, std::string* base_out = 0) const;
 
   public:
 
@@ -608,6 +634,15 @@ std::vector<std::string> declaration_errors(bool lf = false) const;
   * /trun:* /tdis:test1,suite2::test2
   * \endcode
   *
+  * The "--tjobs N" (or "/tjobs:N") option sets the maximum number of tests
+  * executed concurrently, where a value of 0 uses the number of processors.
+  * See set_parallelism(). The "--tisolate" option runs tests in isolated worker
+  * processes. See set_isolated(). The "--thistory file" (or "/thistory:file")
+  * option gives a file of test durations used to schedule concurrent tests.
+  * See set_history_file(). The "--tbaseline file" (or "/tbaseline:file")
+  * option gives a file of benchmark timings against which benchmarks are
+  * compared. See set_baseline_file().
+  *
   * This method is also overloaded with the wchar_t type for use with a
   * Windows main function.
   *
@@ -693,6 +728,231 @@ std::vector<std::string> declaration_errors(bool lf = false) const;
  */
   void set_global_time_warning(tdog::i64_t ms);
 
+/**
+ * \brief Returns the maximum number of test cases which may be executed
+ * concurrently.
+ * \details The default is 1, where tests are executed serially in the
+ * calling thread.
+ * \return Number of concurrent test cases
+ * \sa set_parallelism()
+ */
+  int parallelism() const;
+
+/**
+ * \brief Sets the maximum number of test cases which may be executed
+ * concurrently.
+ * \details Where the value is greater than 1, the run will execute test
+ * cases on a pool of worker threads. The run order guarantees given for
+ * setup and teardown tests still apply. A test named "setup" (or "_setup") will
+ * complete before any following test in its suite is started, and a test named
+ * "teardown" will not start until all those before it have finished. Setup and
+ * teardown tests are themselves always executed alone.
+ *
+ * Test reports are written in the usual run order irrespective of the
+ * order in which tests actually complete.
+ *
+ * Tests executed concurrently must not share state without their own
+ * synchronization. A value of 0 will use the number of processors
+ * on the system. The value may also be given on the command line
+ * using "--tjobs N". See run_cmdline().
+ *
+ * Example:
+ *
+ * \code
+ * tdog::runner::global().set_parallelism(8);
+ * \endcode
+ * \param[in] n Number of concurrent test cases
+ * \sa parallelism(), run()
+ */
+  void set_parallelism(int n);
+
+/**
+ * \brief Returns whether test cases are executed in isolated worker
+ * processes.
+ * \details The default is false.
+ * \return Boolean result
+ * \sa set_isolated()
+ */
+  bool isolated() const;
+
+/**
+ * \brief Sets whether test cases are executed in isolated worker processes.
+ * \details Where true, the runner will fork worker processes to execute
+ * test cases, with each worker taking a share of the tests. Results are
+ * passed back to the runner as each test completes. A test which crashes, or
+ * otherwise terminates its process, will be reported as an error giving the
+ * signal name (i.e. "SIGSEGV") without affecting the remainder of the run.
+ *
+ * The number of worker processes is given by parallelism(). Setup and
+ * teardown tests are executed in the runner process itself, so that changes
+ * made by setup tests are seen by the tests which follow them. Note that
+ * changes made to memory by tests executed in workers will not be seen by
+ * the runner process or by other tests.
+ *
+ * Process isolation is supported on POSIX platforms only. Elsewhere the
+ * setting has no effect, and isolated() will return false. The option may
+ * also be given on the command line using "--tisolate". See run_cmdline().
+ * \param[in] flag Isolated flag
+ * \sa isolated(), set_parallelism()
+ */
+  void set_isolated(bool flag);
+
+/**
+ * \brief Returns the test duration history filename.
+ * \details The default is an empty string.
+ * \return Filename string
+ * \sa set_history_file()
+ */
+  std::string history_file() const;
+
+/**
+ * \brief Sets the name of a file used to record test durations between runs.
+ * \details Where tests are executed concurrently, they are scheduled so that
+ * those which took longest in previous runs are started first. Workers which
+ * become idle take tests queued for other workers, so that the run finishes
+ * as close as possible to the time the longest worker would take alone.
+ *
+ * Where a filename is given, the file is read before the run, and is
+ * rewritten afterwards with the durations of the tests that ran. Durations
+ * of tests not run are retained. If the file does not yet exist, tests
+ * are scheduled in run order and the file will be created.
+ *
+ * The file is plain text, with one test per line giving the duration in
+ * milliseconds followed by the full test name. An empty string disables
+ * the history. The filename may also be given on the command line using
+ * "--thistory file". See run_cmdline().
+ * \param[in] filename History filename
+ * \sa history_file(), set_parallelism()
+ */
+  void set_history_file(const std::string& filename);
+
+/**
+ * \brief Returns the benchmark baseline filename.
+ * \details The default is an empty string.
+ * \return Filename string
+ * \sa set_baseline_file()
+ */
+  std::string baseline_file() const;
+
+/**
+ * \brief Sets the name of a file of benchmark timings against which
+ * benchmarks are compared.
+ * \details Where a filename is given, each benchmark which passes is
+ * compared with the timings held for it in the file, using a statistical
+ * test (Mann-Whitney U) on the distribution of its timed samples, rather
+ * than a fixed threshold.
+ *
+ * A slowdown which is significant (p < 0.001) and of at least 2% in the
+ * median time will fail the test. A slowdown which is significant only
+ * at p < 0.05, or which is smaller than 2%, is given as a warning, so that
+ * the test passes with status TS_PASS_WARN.
+ *
+ * Benchmarks with no timings in the file are recorded, and the file is
+ * rewritten after the run. Timings of other tests are retained. If the
+ * file does not yet exist, it will be created. To replace the timings
+ * held, see set_baseline_update().
+ *
+ * An empty string disables the comparison. The filename may also be given
+ * on the command line using "--tbaseline file". See run_cmdline().
+ * \param[in] filename Baseline filename
+ * \sa baseline_file(), set_baseline_update(), TDOG_BENCHMARK()
+ */
+  void set_baseline_file(const std::string& filename);
+
+/**
+ * \brief Returns whether benchmark baselines are updated.
+ * \details The default is false.
+ * \return Update flag
+ * \sa set_baseline_update()
+ */
+  bool baseline_update() const;
+
+/**
+ * \brief Sets whether benchmark baselines are updated.
+ * \details Where true, benchmarks are not compared with the baseline
+ * file. Instead, the timings of each benchmark which passes replace
+ * those held. This is typically used when a known change in performance
+ * is to be accepted.
+ * \param[in] flag Update flag
+ * \sa baseline_update(), set_baseline_file()
+ */
+  void set_baseline_update(bool flag);
+
+/**
+ * \brief Returns whether hardware counters are taken around each test.
+ * \details The default is false.
+ * \return Boolean result
+ * \sa set_hw_counters()
+ */
+  bool hw_counters() const;
+
+/**
+ * \brief Sets whether hardware counters are taken around each test.
+ * \details Where true, the CPU cycles, instructions retired, last level cache
+ * misses and mispredicted branches are counted over each test case, in
+ * user space only, and are given in verbose reports. Totals may be obtained
+ * using statistic_count() with CNT_CYCLES, CNT_INSTRUCTIONS, CNT_CACHE_MISSES
+ * and CNT_BRANCH_MISSES.
+ *
+ * Counters are read using perf_event_open() on Linux. Elsewhere, or where
+ * the system does not permit it (i.e. where "perf_event_paranoid" is set
+ * above 2, or in some containers), tests run as normal without counts. The
+ * setting does not fail in either case.
+ * \param[in] flag Counters flag
+ * \sa hw_counters(), statistic_count()
+ */
+  void set_hw_counters(bool flag);
+
+/**
+ * \brief Returns whether the watchdog takes stack snapshots of hung tests.
+ * \details The default is true.
+ * \return Boolean result
+ * \sa set_watchdog_stacks()
+ */
+  bool watchdog_stacks() const;
+
+/**
+ * \brief Sets whether the watchdog takes stack snapshots of hung tests.
+ * \details A test which runs past its time limit by more than a grace
+ * period, without calling an assert or print, is reported as hung on
+ * STDERR. See set_watchdog_exit() for what follows.
+ *
+ * Where true, the report of a hung test includes a backtrace of its thread.
+ * This is taken by briefly signalling the thread with SIGUSR2, which will
+ * interrupt any sleep or blocking call in the test. The handler is
+ * installed only while the snapshot is taken, after which any handler of
+ * the signal installed by the application is restored. Snapshots are
+ * supported with glibc only. Elsewhere the setting has no effect.
+ * \param[in] flag Snapshot flag
+ * \sa watchdog_stacks(), set_watchdog_exit(), TDOG_SET_TEST_TIMEOUT()
+ */
+  void set_watchdog_stacks(bool flag);
+
+/**
+ * \brief Returns whether the watchdog ends the run when a test hangs.
+ * \details The default is true.
+ * \return Boolean result
+ * \sa set_watchdog_exit()
+ */
+  bool watchdog_exit() const;
+
+/**
+ * \brief Sets whether the watchdog ends the run when a test hangs.
+ * \details Tests run in isolated worker processes are always terminated
+ * when they hang, and recorded as failed. See set_isolated(). A test run in
+ * the runner process, however, cannot be stopped safely.
+ *
+ * Where true, the hung test is recorded as failed, with the message
+ * "time constraint exceeded". The reports of the run are then written for
+ * the results gathered so far, and the process exits with code 124.
+ *
+ * Where false, the run continues only once the hung test returns, at which
+ * point it fails. This may be never.
+ * \param[in] flag Exit flag
+ * \sa watchdog_exit(), set_watchdog_stacks(), TDOG_SET_TEST_TIMEOUT()
+ */
+  void set_watchdog_exit(bool flag);
+
 /**
  * @}
  * @name Generating test reports
@@ -766,6 +1026,37 @@ std::vector<std::string> declaration_errors(bool lf = false) const;
  */
   void set_default_report(report_style_t style);
 
+/**
+ * \brief Returns whether the report written to STDOUT is generated on a
+ * separate thread.
+ * \details The default is false.
+ * \return Boolean result
+ * \sa set_async_report()
+ */
+  bool async_report() const;
+
+/**
+ * \brief Sets whether the report written to STDOUT is generated on a
+ * separate thread.
+ * \details Normally, the report entry for each test is formatted and
+ * written to STDOUT by the runner before the next test starts. Where a large
+ * number of short tests are run, or where a verbose report is used, this may
+ * add significantly to the duration of the run.
+ *
+ * Where true, completed tests are instead passed to a dedicated reporter
+ * thread, which formats and writes them while the next tests execute. The
+ * content and order of the report is unchanged, and the report is complete
+ * and flushed before run() returns. Note, however, that output written
+ * directly to STDOUT by test implementation code may appear at a different
+ * position relative to the report.
+ *
+ * This setting does not affect reports written to file, which are generated
+ * after the run.
+ * \param[in] flag Asynchronous report flag
+ * \sa async_report(), set_default_report()
+ */
+  void set_async_report(bool flag);
+
 /**
  * \brief Generates a test report pertaining to the test run performed and
  * writes it to the supplied output stream.
@@ -881,6 +1172,89 @@ std::vector<std::string> declaration_errors(bool lf = false) const;
  */
   void add_report(report_style_t style, const std::string& filename);
 
+/**
+ * \brief Saves the results of the last test run to a binary file.
+ * \details The file holds the name, declaration and results of each
+ * registered test, including its event log, together with the project
+ * properties and run times. It is compact, and can be written after every
+ * run at little cost.
+ *
+ * Reports can then be generated from the file later, without running the
+ * tests again, using load_results() or the "tdogrpt" tool. For example, a
+ * CI job may save the results of every run, but generate an HTML report only
+ * where the run has failed.
+ *
+ * \code
+ * int rslt = tdog::runner::global().run();
+ * tdog::runner::global().save_results("./test-results.tdr");
+ * \endcode
+ *
+ * This method should be called after the test run.
+ * \param[in] filename Output filename
+ * \return True on success
+ * \sa load_results(), generate_report()
+ */
+  bool save_results(const std::string& filename) const;
+
+/**
+ * \brief Loads test results from a file written by save_results().
+ * \details Tests currently registered with the runner are replaced by those
+ * in the file, together with their results. The project name, version and
+ * description, and run times, are also restored. Reports may then be written
+ * with generate_report(), and statistics obtained, as if the tests had just
+ * been executed.
+ *
+ * Where the saved run was aborted by test declaration errors, these are also
+ * restored, so that reports show the run as aborted. The host name given in
+ * reports is that on which the run was executed. See run_hostname().
+ *
+ * Tests loaded from file have no implementation, and should not be run. The
+ * result is false if the file cannot be read, or is not valid, in which case
+ * the runner is left unchanged.
+ * \param[in] filename Input filename
+ * \return True on success
+ * \sa save_results(), merge_results(), generate_report()
+ */
+  bool load_results(const std::string& filename);
+
+/**
+ * \brief Loads and merges test results from several files written by
+ * save_results().
+ * \details This is intended where a test run is split into shards, i.e.
+ * across machines or processes, with each shard saving its own results.
+ * Each shard typically registers every test, but runs only its share, so
+ * that each test is taken from the file in which it was run. Where a test
+ * ran in more than one shard, the result in the last file given is used.
+ * Tests which ran in none are taken as disabled, skipped or not run.
+ *
+ * The result is a single ordered set of results, from which any report may
+ * be generated. The project properties are taken from the first file, and the
+ * run times span those of all files. Files are memory mapped, and only the
+ * name and status of each test is read before the results to be kept are
+ * chosen.
+ *
+ * \code
+ * std::vector<std::string> shards;
+ * shards.push_back("./shard-0.tdr");
+ * shards.push_back("./shard-1.tdr");
+ *
+ * tdog::runner tr(tdog::RS_NONE);
+ *
+ * if (tr.merge_results(shards))
+ * {
+ *   tr.generate_report(std::cout, tdog::RS_XML);
+ * }
+ * \endcode
+ *
+ * The result is false if any file cannot be read, or is not valid, in
+ * which case the runner is left unchanged. Merged results may be written
+ * to a single file with save_results(). See also the "tdogrpt" tool.
+ * \param[in] filenames Input filenames
+ * \return True on success
+ * \sa load_results(), save_results()
+ */
+  bool merge_results(const std::vector<std::string>& filenames);
+
 /**
  * \brief Returns the test report character set encoding.
  * \details This is a short string specifying a valid character set encoding
@@ -988,7 +1362,15 @@ std::vector<std::string> declaration_errors(bool lf = false) const;
  * - tdog::CNT_ASSERT_TOTAL - Total number of assert statements
  * - tdog::CNT_ASSERT_FAILED - Number of assert failures
  * - tdog::CNT_DURATION - Duration in milliseconds
+ * - tdog::CNT_CYCLES - CPU cycles
+ * - tdog::CNT_INSTRUCTIONS - Instructions retired
+ * - tdog::CNT_CACHE_MISSES - Last level cache misses
+ * - tdog::CNT_BRANCH_MISSES - Mispredicted branches
  * .
+ * The hardware counts are taken only where enabled with
+ * runner::set_hw_counters(), and are totals of those tests for which
+ * counts were available. Otherwise, they are 0.
+ *
  * Either a test case or suite name may be specified, and will match tests
  * according to the following rules:
  *
@@ -1018,6 +1400,11 @@ std::vector<std::string> declaration_errors(bool lf = false) const;
  *
  * All return values will be zero if no test run was performed prior to calling
  * this method, otherwise they will be an applicable count value or duration.
+ *
+ * Statistics are aggregated for each suite as tests complete, so that the
+ * cost of a call does not grow with the number of tests. Results changed
+ * by another runner, where tests are shared between runners, are not seen
+ * until this runner's tests or their results are next changed.
  * \param[in] type Required statistic of type
  * \param[in] name Test case or suite name, or "*" for all
  * \return Statistical value
@@ -1083,6 +1470,16 @@ std::vector<std::string> declaration_errors(bool lf = false) const;
  */
   tdog::i64_t duration() const;
 
+/**
+ * \brief Returns the name of the host on which the last test run was executed.
+ * \details Where results were loaded with load_results() or merge_results(),
+ * this is the host which saved them, otherwise it is that of this process.
+ * It is the name given in reports.
+ * \return Host name
+ * \sa load_results()
+ */
+  std::string run_hostname() const;
+
 /**
  * @}
  */
@@ -72,7 +72,11 @@ enum stat_count_t
   CNT_PASS_RATE,       //!< Percentage of tests that passed
   CNT_ASSERT_TOTAL,    //!< Total number of assert statements
   CNT_ASSERT_FAILED,   //!< Number of assert failures
-  CNT_DURATION         //!< Duration of in milliseconds
+  CNT_DURATION,        //!< Duration of in milliseconds
+  CNT_CYCLES,          //!< CPU cycles (see runner::set_hw_counters())
+  CNT_INSTRUCTIONS,    //!< Instructions retired
+  CNT_CACHE_MISSES,    //!< Last level cache misses
+  CNT_BRANCH_MISSES    //!< Mispredicted branches
 };
 
 /**
@@ -101,7 +105,9 @@ enum test_type_t
   TT_TEST,      //!< Vanilla test case
   TT_REPEATED,  //!< Reteated test
   TT_FIXTURE,   //!< Fixture, a test with setup and teardown routines
-  TT_PROTECTED  //!< Used to test protected methods of a class
+  TT_PROTECTED, //!< Used to test protected methods of a class
+  TT_BENCHMARK, //!< Microbenchmark, timed over many iterations
+  TT_SHARED     //!< Test using a fixture shared by its suite
 };
 
 } // namespace
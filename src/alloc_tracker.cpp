@@ -0,0 +1,222 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : alloc_tracker.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "alloc_tracker.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(TDOG_ALLOC_TRACKING)
+  #if defined(_MSC_VER)
+    #define TDOG_TLS __declspec(thread)
+  #else
+    #define TDOG_TLS __thread
+  #endif
+
+  // Dynamic exception specifications are
+  // not permitted in later standards.
+  #if __cplusplus >= 201103L
+    #define TDOG_NEW_THROW
+    #define TDOG_NEW_NOTHROW noexcept
+  #else
+    #define TDOG_NEW_THROW throw(std::bad_alloc)
+    #define TDOG_NEW_NOTHROW throw()
+  #endif
+#endif // TDOG_ALLOC_TRACKING
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+#if defined(TDOG_ALLOC_TRACKING)
+
+// Block header, holding the size. Sized so
+// that the block keeps malloc() alignment.
+const std::size_t ALLOC_HEADER = 16;
+
+// Counts of calling thread in current frame
+static TDOG_TLS tdog::i64_t g_count = 0;
+static TDOG_TLS tdog::i64_t g_bytes = 0;
+static TDOG_TLS tdog::i64_t g_live = 0;
+static TDOG_TLS tdog::i64_t g_peak = 0;
+
+#endif // TDOG_ALLOC_TRACKING
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+#if defined(TDOG_ALLOC_TRACKING)
+static void* _alloc(std::size_t sz)
+{
+  // Allocate and count. Null on failure.
+  char* p = static_cast<char*>(std::malloc(sz + ALLOC_HEADER));
+  if (p == 0) return 0;
+
+  *reinterpret_cast<std::size_t*>(p) = sz;
+
+  ++g_count;
+  g_bytes += static_cast<tdog::i64_t>(sz);
+  g_live += static_cast<tdog::i64_t>(sz);
+  if (g_live > g_peak) g_peak = g_live;
+
+  return p + ALLOC_HEADER;
+}
+//---------------------------------------------------------------------------
+static void* _alloc_throw(std::size_t sz)
+{
+  // As _alloc(), but calls the new handler until
+  // it succeeds, or throws where there is none.
+  void* p;
+
+  while((p = _alloc(sz)) == 0)
+  {
+    std::new_handler h = std::set_new_handler(0);
+    std::set_new_handler(h);
+
+    if (h == 0) throw std::bad_alloc();
+    h();
+  }
+
+  return p;
+}
+//---------------------------------------------------------------------------
+static void _free(void* ptr)
+{
+  // Free block allocated by _alloc()
+  if (ptr != 0)
+  {
+    char* p = static_cast<char*>(ptr) - ALLOC_HEADER;
+    g_live -= static_cast<tdog::i64_t>(*reinterpret_cast<std::size_t*>(p));
+    std::free(p);
+  }
+}
+#endif
+//---------------------------------------------------------------------------
+// GLOBAL OPERATORS
+//---------------------------------------------------------------------------
+#if defined(TDOG_ALLOC_TRACKING)
+void* operator new(std::size_t sz) TDOG_NEW_THROW
+{
+  return _alloc_throw(sz);
+}
+//---------------------------------------------------------------------------
+void* operator new[](std::size_t sz) TDOG_NEW_THROW
+{
+  return _alloc_throw(sz);
+}
+//---------------------------------------------------------------------------
+void* operator new(std::size_t sz, const std::nothrow_t&) TDOG_NEW_NOTHROW
+{
+  return _alloc(sz);
+}
+//---------------------------------------------------------------------------
+void* operator new[](std::size_t sz, const std::nothrow_t&) TDOG_NEW_NOTHROW
+{
+  return _alloc(sz);
+}
+//---------------------------------------------------------------------------
+void operator delete(void* ptr) TDOG_NEW_NOTHROW
+{
+  _free(ptr);
+}
+//---------------------------------------------------------------------------
+void operator delete[](void* ptr) TDOG_NEW_NOTHROW
+{
+  _free(ptr);
+}
+//---------------------------------------------------------------------------
+void operator delete(void* ptr, const std::nothrow_t&) TDOG_NEW_NOTHROW
+{
+  _free(ptr);
+}
+//---------------------------------------------------------------------------
+void operator delete[](void* ptr, const std::nothrow_t&) TDOG_NEW_NOTHROW
+{
+  _free(ptr);
+}
+#if defined(__cpp_sized_deallocation)
+//---------------------------------------------------------------------------
+void operator delete(void* ptr, std::size_t) TDOG_NEW_NOTHROW
+{
+  _free(ptr);
+}
+//---------------------------------------------------------------------------
+void operator delete[](void* ptr, std::size_t) TDOG_NEW_NOTHROW
+{
+  _free(ptr);
+}
+#endif // __cpp_sized_deallocation
+#endif
+//---------------------------------------------------------------------------
+// CLASS alloc_tracker : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+bool alloc_tracker::enabled()
+{
+#if defined(TDOG_ALLOC_TRACKING)
+  return true;
+#else
+  return false;
+#endif
+}
+//---------------------------------------------------------------------------
+alloc_counts alloc_tracker::current()
+{
+  // Counts of calling thread in the current frame
+  alloc_counts rslt;
+
+#if defined(TDOG_ALLOC_TRACKING)
+  rslt.count = g_count;
+  rslt.bytes = g_bytes;
+  rslt.peak_bytes = g_peak;
+#endif
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
+void alloc_tracker::begin(alloc_frame& saved)
+{
+  // Save enclosing frame, and count from zero
+#if defined(TDOG_ALLOC_TRACKING)
+  saved.count = g_count;
+  saved.bytes = g_bytes;
+  saved.live = g_live;
+  saved.peak = g_peak;
+
+  g_count = 0;
+  g_bytes = 0;
+  g_live = 0;
+  g_peak = 0;
+#else
+  saved = alloc_frame();
+#endif
+}
+//---------------------------------------------------------------------------
+alloc_counts alloc_tracker::end(const alloc_frame& saved)
+{
+  // Counts of frame, which are added to the enclosing one.
+  // Its peak is reached with the enclosing live bytes.
+  alloc_counts rslt = current();
+
+#if defined(TDOG_ALLOC_TRACKING)
+  tdog::i64_t peak = saved.live + g_peak;
+
+  g_count += saved.count;
+  g_bytes += saved.bytes;
+  g_live += saved.live;
+  g_peak = (peak > saved.peak) ? peak : saved.peak;
+#else
+  (void)saved;
+#endif
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
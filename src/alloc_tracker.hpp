@@ -0,0 +1,85 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : alloc_tracker.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_ALLOC_TRACKER_H
+#define TDOG_ALLOC_TRACKER_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+#include "tdog/private/run_helper.hpp"
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Heap allocation accounting. Where the library is built with the macro
+// TDOG_ALLOC_TRACKING defined, it replaces the global operator new and
+// delete (and their array and nothrow forms) with versions which count
+// allocations, bytes and live bytes for the calling thread. Each block
+// carries a small header holding its size, so that delete can account
+// for it. Memory is obtained with malloc().
+//
+// Counts are thread local, so that tests running concurrently do not see
+// each other's allocations, but memory freed by a thread other than that
+// which allocated it is accounted to the thread freeing it.
+//
+// A frame starts counting from zero for the calling thread. On ending it,
+// its counts are added to those of the enclosing frame, so that a test run
+// by a local runner within another test is also counted by the outer one.
+//
+// Without the macro, the operators are not replaced, enabled() is false
+// and no counts are given.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+// Saved state of enclosing frame
+struct alloc_frame
+{
+  tdog::i64_t count;
+  tdog::i64_t bytes;
+  tdog::i64_t live;
+  tdog::i64_t peak;
+
+  alloc_frame() : count(0), bytes(0), live(0), peak(0) {}
+};
+
+//---------------------------------------------------------------------------
+// CLASS alloc_tracker
+//---------------------------------------------------------------------------
+class alloc_tracker
+{
+  public:
+
+  // True if built with TDOG_ALLOC_TRACKING
+  static bool enabled();
+
+  // Counts of calling thread in the current frame.
+  // Invalid (-1) where tracking is not enabled.
+  static alloc_counts current();
+
+  // Start frame for calling thread, saving the state of
+  // the enclosing one. End returns the counts of the frame.
+  static void begin(alloc_frame& saved);
+  static alloc_counts end(const alloc_frame& saved);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
@@ -0,0 +1,147 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : async_reporter.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "async_reporter.hpp"
+#include "util.hpp"
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+// Queue capacity. When full, the runner waits.
+const std::size_t ASYNC_QUEUE_SIZE = 4096;
+
+// Empty polls before the reporter thread starts
+// to sleep, rather than yield, between polls.
+const int ASYNC_SPIN_MAX = 64;
+
+//---------------------------------------------------------------------------
+// CLASS async_reporter : PRIVATE MEMBERS
+//---------------------------------------------------------------------------
+void async_reporter::_stop()
+{
+  // Push end marker and wait for thread to drain queue
+  if (m_running)
+  {
+    while(!m_ring.push(0)) msleep(1);
+    m_thread.join();
+    m_running = false;
+  }
+}
+//---------------------------------------------------------------------------
+// CLASS async_reporter : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+async_reporter::async_reporter(basic_reporter* inner)
+  : basic_reporter(&inner->owner(), inner->verbose()),
+  m_ring(ASYNC_QUEUE_SIZE)
+{
+  // Constructor
+  m_inner = inner;
+  m_os = 0;
+  m_running = false;
+}
+//---------------------------------------------------------------------------
+async_reporter::~async_reporter()
+{
+  // Destructor
+  _stop();
+  delete m_inner;
+}
+//---------------------------------------------------------------------------
+bool async_reporter::needs_results() const
+{
+  return m_inner->needs_results();
+}
+//---------------------------------------------------------------------------
+void async_reporter::gen_plan(const std::vector<basic_test*>& order)
+{
+  m_inner->gen_plan(order);
+}
+//---------------------------------------------------------------------------
+void async_reporter::clear()
+{
+  basic_reporter::clear();
+  m_inner->clear();
+}
+//---------------------------------------------------------------------------
+void async_reporter::gen_start(std::ostream& os)
+{
+  // Write header here, so that it precedes
+  // any test output, then start thread.
+  _stop();
+  m_inner->gen_start(os);
+  m_os = &os;
+  m_running = m_thread.start(*this);
+}
+//---------------------------------------------------------------------------
+void async_reporter::gen_test(std::ostream& os, const basic_test* tc)
+{
+  // Queue the test for the reporter thread
+  if (!m_running || &os != m_os)
+  {
+    // Write synchronously, but first
+    // let thread finish what it has.
+    _stop();
+    m_inner->gen_test(os, tc);
+    return;
+  }
+
+  // Wait if full. The thread is writing.
+  int spin = 0;
+
+  while(!m_ring.push(tc))
+  {
+    msleep(++spin < ASYNC_SPIN_MAX ? 0 : 1);
+  }
+}
+//---------------------------------------------------------------------------
+void async_reporter::gen_end(std::ostream& os)
+{
+  // Drain queue, then write footer
+  _stop();
+  m_inner->gen_end(os);
+  os.flush();
+}
+//---------------------------------------------------------------------------
+void async_reporter::run(std::size_t)
+{
+  // Reporter thread. Formats each test in the order
+  // queued, until the null end marker is received.
+  int spin = 0;
+  const basic_test* tc = 0;
+
+  while(true)
+  {
+    if (m_ring.pop(tc))
+    {
+      if (tc == 0) break;
+
+      spin = 0;
+
+      try
+      {
+        m_inner->gen_test(*m_os, tc);
+      }
+      catch(...)
+      {
+        // Must not throw
+      }
+    }
+    else
+    {
+      // Yield at first, then sleep so that an idle
+      // thread does not compete with the tests.
+      msleep(++spin < ASYNC_SPIN_MAX ? 0 : 1);
+    }
+  }
+}
+//---------------------------------------------------------------------------
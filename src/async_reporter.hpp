@@ -0,0 +1,85 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : async_reporter.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_ASYNC_REPORTER_H
+#define TDOG_ASYNC_REPORTER_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "basic_reporter.hpp"
+#include "thread_pool.hpp"
+#include "spsc_ring.hpp"
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Wraps another reporter so that formatting and writing the live report
+// happens on a dedicated thread, rather than between tests. The runner
+// only pushes the completed test onto a lock-free queue. Tests are not
+// modified once reported, so the reporter thread may read them freely.
+// The order of output is unchanged, and gen_end() waits for the queue
+// to drain before the footer is written and the stream flushed.
+//
+// Only one thread may call gen_test(), as the queue has a single
+// producer. The runner reports from its own thread only.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS async_reporter
+//---------------------------------------------------------------------------
+class async_reporter : public basic_reporter, public pool_task
+{
+  private:
+
+  basic_reporter* m_inner;
+  std::ostream* m_os;
+  spsc_ring<const basic_test*> m_ring;
+  task_thread m_thread;
+  bool m_running;
+
+  void _stop();
+
+  // No copy
+  async_reporter(const async_reporter&);
+  async_reporter& operator=(const async_reporter&);
+
+  public:
+
+  // Takes ownership of inner
+  async_reporter(basic_reporter* inner);
+  virtual ~async_reporter();
+
+  // Forwarded to inner
+  virtual bool needs_results() const;
+  virtual void gen_plan(const std::vector<basic_test*>& order);
+  virtual void clear();
+
+  virtual void gen_start(std::ostream& os);
+  virtual void gen_test(std::ostream& os, const basic_test* tc);
+  virtual void gen_end(std::ostream& os);
+
+  // Reporter thread
+  virtual void run(std::size_t idx);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
@@ -11,6 +11,7 @@
 //---------------------------------------------------------------------------
 #include "basic_reporter.hpp"
 #include "tdog/runner.hpp"
+#include "util.hpp"
 
 #include <stdexcept>
 
@@ -78,6 +79,17 @@ void basic_reporter::clear()
   _impl_clear();
 }
 //---------------------------------------------------------------------------
+bool basic_reporter::needs_results() const
+{
+  // Most can write as tests complete
+  return false;
+}
+//---------------------------------------------------------------------------
+void basic_reporter::gen_plan(const std::vector<basic_test*>&)
+{
+  // Does nothing by default
+}
+//---------------------------------------------------------------------------
 bool basic_reporter::verbose() const
 {
   // Accessor
@@ -118,6 +130,8 @@ std::string basic_reporter::test_type_str(test_type_t t)
     case TT_REPEATED: return "REPEATED";
     case TT_FIXTURE: return "FIXTURE";
     case TT_PROTECTED: return "PROTECTED";
+    case TT_BENCHMARK: return "BENCHMARK";
+    case TT_SHARED: return "SHARED";
     default: return std::string();
   }
 }
@@ -152,3 +166,60 @@ std::string basic_reporter::status_str(status_t t)
   }
 }
 //---------------------------------------------------------------------------
+std::string basic_reporter::bench_time_str(double ns)
+{
+  // Time per iteration in suitable units
+  if (ns < 1.0e3) return double_to_str(ns, "%.2f ns");
+  if (ns < 1.0e6) return double_to_str(ns / 1.0e3, "%.2f us");
+  if (ns < 1.0e9) return double_to_str(ns / 1.0e6, "%.2f ms");
+
+  return double_to_str(ns / 1.0e9, "%.2f s");
+}
+//---------------------------------------------------------------------------
+std::string basic_reporter::bench_str(const bench_result& b)
+{
+  // Summary line of benchmark figures
+  std::string rslt = "median " + bench_time_str(b.median_ns);
+  rslt += ", p90 " + bench_time_str(b.p90_ns);
+  rslt += ", p99 " + bench_time_str(b.p99_ns);
+  rslt += ", MAD " + bench_time_str(b.mad_ns);
+  rslt += ", " + double_to_str(b.ops_per_sec(), "%.0f") + " ops/sec";
+  rslt += " (" + int_to_str(b.samples) + " x " + int_to_str(b.batch) + ")";
+  return rslt;
+}
+//---------------------------------------------------------------------------
+std::string basic_reporter::counts_str(const hw_counts& c)
+{
+  // Summary line of hardware counts. Those
+  // which could not be read are given as n/a.
+  const tdog::i64_t vals[] = { c.cycles, c.instructions, c.cache_misses, c.branch_misses };
+  const char* const names[] = { "cycles ", "instructions ", "cache misses ", "branch misses " };
+
+  std::string rslt;
+
+  for(int n = 0; n < 4; ++n)
+  {
+    if (n != 0) rslt += ", ";
+    rslt += names[n];
+    rslt += (vals[n] >= 0) ? int_to_str(vals[n]) : std::string("n/a");
+
+    if (n == 1 && c.cycles > 0 && c.instructions >= 0)
+    {
+      // Instructions per cycle
+      rslt += " (IPC " + double_to_str(static_cast<double>(c.instructions) /
+        c.cycles, "%.2f") + ")";
+    }
+  }
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
+std::string basic_reporter::allocs_str(const alloc_counts& a)
+{
+  // Summary line of heap allocations
+  std::string rslt = "count " + int_to_str(a.count);
+  rslt += ", bytes " + int_to_str(a.bytes);
+  rslt += ", peak bytes " + int_to_str(a.peak_bytes);
+  return rslt;
+}
+//---------------------------------------------------------------------------
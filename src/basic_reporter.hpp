@@ -19,6 +19,7 @@
 
 #include <string>
 #include <ostream>
+#include <vector>
 
 //---------------------------------------------------------------------------
 // DOCUMENTATION
@@ -72,6 +73,15 @@ class basic_reporter
   int indent_step() const;
   void set_indent_step(int step);
 
+  // True if the reporter can only write once all results
+  // are known. The runner does not use it during the run, but
+  // calls generate_report() at the end instead.
+  virtual bool needs_results() const;
+
+  // Called before gen_start() with all tests to be reported,
+  // in order. Allows stats to be known before they are written.
+  virtual void gen_plan(const std::vector<basic_test*>& order);
+
   // Report generator methods
   // Must be defined in concrete classes
   virtual void clear();
@@ -83,6 +93,16 @@ class basic_reporter
   static std::string test_type_str(test_type_t t);
   static std::string event_str(event_type_t t);
   static std::string status_str(status_t t);
+
+  // Benchmark figures, i.e. "median 12.50 ns, p90 ..."
+  static std::string bench_time_str(double ns);
+  static std::string bench_str(const bench_result& b);
+
+  // Hardware counts, i.e. "cycles 1200, instructions ..."
+  static std::string counts_str(const hw_counts& c);
+
+  // Heap allocations, i.e. "count 12, bytes 4096, peak bytes 1024"
+  static std::string allocs_str(const alloc_counts& a);
 };
 
 } // namespace
@@ -13,6 +13,8 @@
 #include "tdog/private/suite_manager.hpp"
 #include "tdog/runner.hpp"
 #include "tdog_exception.hpp"
+#include "perf_counters.hpp"
+#include "alloc_tracker.hpp"
 #include "util.hpp"
 
 #include <stdexcept>
@@ -27,23 +29,40 @@ using namespace tdog;
 const std::size_t NSZ = std::string(NSSEP).size();
 
 //---------------------------------------------------------------------------
-// CLASS basic_test : PUBLIC MEMBERS
+// INTERNAL ROUTINES
 //---------------------------------------------------------------------------
-basic_test::basic_test(const std::string& tname, // <- test name
-    test_type_t ttype,  // <- test type
-    const std::string& fname,   // <- filename
-    int lnum,   // <- line number
-    const std::string& utype,   // <- user typename
-    const std::string& rtype)   // <- repeated test typename
+static bool _has_prefix(const std::string& tname, const char* pfx)
+{
+  // True if test name begins with pfx, ignoring
+  // case and any leading underscores.
+  std::string temp = ascii_lower(tname);
+  std::size_t psz = std::string(pfx).size();
+
+  if (temp.size() >= psz)
+  {
+    while (temp.substr(0, 1) == "_") temp.erase(0, 1);
+    return (temp.substr(0, psz) == pfx);
+  }
+
+  return false;
+}
+
+//---------------------------------------------------------------------------
+// CLASS basic_test : PRIVATE MEMBERS
+//---------------------------------------------------------------------------
+void basic_test::_init(const std::string& sname, const std::string& tname,
+  test_type_t ttype, const std::string& fname, int lnum,
+  const std::string& utype, const std::string& rtype)
 {
   // Initialize members
   m_test_name = trim_str(tname);
-  m_suite_name = suite_manager::current();
+  m_suite_name = sname;
   m_filename = trim_str(fname);
   m_test_type = ttype;
   m_line_num = lnum;
   m_user_typename = utype;
   m_repeat_typename = rtype;
+  m_shared = 0;
 
   // Clean up leading separator
   if (m_suite_name.substr(0, NSZ) == NSSEP)
@@ -65,8 +84,42 @@ basic_test::basic_test(const std::string& tname, // <- test name
 
   m_full_name_ptr = m_full_name.c_str();
 
+  // Sort key
+  m_sort_key.rank = 1;
+  if (_has_prefix(m_test_name, "setup")) m_sort_key.rank = 0;
+  else if (_has_prefix(m_test_name, "teardown")) m_sort_key.rank = 2;
+  m_sort_key.suite_lower = ascii_lower(m_suite_name);
+  m_sort_key.name_lower = ascii_lower(m_test_name);
+
   // Temporary debug
   // printf("FULL NAME = %s\n", m_full_name_ptr);
+}
+//---------------------------------------------------------------------------
+// CLASS basic_test : PROTECTED MEMBERS
+//---------------------------------------------------------------------------
+basic_test::basic_test(const std::string& sname, // <- suite name
+    const std::string& tname, // <- test name
+    test_type_t ttype,  // <- test type
+    const std::string& fname,   // <- filename
+    int lnum,   // <- line number
+    const std::string& utype,   // <- user typename
+    const std::string& rtype)   // <- repeated test typename
+{
+  // Explicit suite, and not registered
+  _init(sname, tname, ttype, fname, lnum, utype, rtype);
+}
+//---------------------------------------------------------------------------
+// CLASS basic_test : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+basic_test::basic_test(const std::string& tname, // <- test name
+    test_type_t ttype,  // <- test type
+    const std::string& fname,   // <- filename
+    int lnum,   // <- line number
+    const std::string& utype,   // <- user typename
+    const std::string& rtype)   // <- repeated test typename
+{
+  // Suite is that currently open
+  _init(suite_manager::current(), tname, ttype, fname, lnum, utype, rtype);
 
   if (suite_manager::auto_reg())
   {
@@ -80,19 +133,19 @@ basic_test::~basic_test()
   // Destructor
 }
 //---------------------------------------------------------------------------
-std::string basic_test::test_name() const
+const std::string& basic_test::test_name() const
 {
   // Accessor to test name
   return m_test_name;
 }
 //---------------------------------------------------------------------------
-std::string basic_test::suite_name() const
+const std::string& basic_test::suite_name() const
 {
   // Accessor to suite name
   return m_suite_name;
 }
 //---------------------------------------------------------------------------
-std::string basic_test::full_name() const
+const std::string& basic_test::full_name() const
 {
   // The suite::test_name as a c-style string.
   return m_full_name;
@@ -108,27 +161,19 @@ const char* basic_test::full_name_cstr()
 bool basic_test::is_setup() const
 {
   // True if a setup() test
-  if (m_test_name.size() > 4)
-  {
-    std::string temp = ascii_lower(m_test_name);
-    while (temp.substr(0, 1) == "_") temp.erase(0, 1);
-    return (temp.substr(0, 5) == "setup");
-  }
-
-  return false;
+  return (m_sort_key.rank == 0);
 }
 //---------------------------------------------------------------------------
 bool basic_test::is_teardown() const
 {
   // True if a teardown() test
-  if (m_test_name.size() > 7)
-  {
-    std::string temp = ascii_lower(m_test_name);
-    while (temp.substr(0, 1) == "_") temp.erase(0, 1);
-    return (temp.substr(0, 8) == "teardown");
-  }
-
-  return false;
+  return (m_sort_key.rank == 2);
+}
+//---------------------------------------------------------------------------
+const basic_test::sort_key& basic_test::key() const
+{
+  // Precomputed sort key
+  return m_sort_key;
 }
 //---------------------------------------------------------------------------
 std::string basic_test::file_location() const
@@ -145,11 +190,29 @@ std::string basic_test::file_location() const
   return rslt;
 }
 //---------------------------------------------------------------------------
+const std::string& basic_test::filename() const
+{
+  // File name where test is declared
+  return m_filename;
+}
+//---------------------------------------------------------------------------
+int basic_test::line_num() const
+{
+  // Line number where test is declared
+  return m_line_num;
+}
+//---------------------------------------------------------------------------
 test_type_t basic_test::test_type() const
 {
   return m_test_type;
 }
 //---------------------------------------------------------------------------
+basic_shared* basic_test::shared() const
+{
+  // Suite shared fixture, or null
+  return m_shared;
+}
+//---------------------------------------------------------------------------
 std::string basic_test::user_typename() const
 {
   return m_user_typename;
@@ -183,6 +246,37 @@ const run_helper& basic_test::helper() const
   return m_helper;
 }
 //---------------------------------------------------------------------------
+void basic_test::encode_results(std::string& out) const
+{
+  // Handled by the helper
+  m_helper.encode(out);
+}
+//---------------------------------------------------------------------------
+bool basic_test::decode_results(const char* data, std::size_t size)
+{
+  // Handled by the helper
+  return m_helper.decode(data, size);
+}
+//---------------------------------------------------------------------------
+void basic_test::set_aborted(const std::string& s, const std::string& ename,
+  tdog::i64_t start, tdog::i64_t dur, event_type_t t)
+{
+  // Handled by the helper
+  m_helper.set_aborted(s, ename, start, dur, t);
+}
+//---------------------------------------------------------------------------
+void basic_test::post_event(const std::string& s, event_type_t t)
+{
+  // Handled by the helper
+  m_helper.post_event(s, t);
+}
+//---------------------------------------------------------------------------
+void basic_test::set_watcher(limit_watcher* w, std::size_t key)
+{
+  // Handled by the helper
+  m_helper.set_watcher(w, key);
+}
+//---------------------------------------------------------------------------
 bool basic_test::name_equals(const std::string& name, bool precise) const
 {
   // True if name matches the test full name, or...
@@ -230,15 +324,25 @@ bool basic_test::name_equals(const std::string& name, bool precise) const
   return (m_full_name == tn);
 }
 //---------------------------------------------------------------------------
-void basic_test::run(tdog::i64_t glimit, tdog::i64_t gwarn)
+void basic_test::run(tdog::i64_t glimit, tdog::i64_t gwarn, bool counters)
 {
   // Run the test, wrapping it into try-catch block.
+  // Counters are opened before the timer starts, and
+  // give no counts where they cannot be opened.
+  perf_counters pc;
+  bool pc_open = (counters && pc.open());
+
+  // Allocations, where built in
+  alloc_frame af;
+  alloc_tracker::begin(af);
+
   try
   {
     if (m_helper.start_test(glimit, gwarn))
     {
       // Call the wrapper of the wapper
       // of the thing that does the thing.
+      if (pc_open) pc.start();
       _run_unprotected();
     }
   }
@@ -325,6 +429,17 @@ void basic_test::run(tdog::i64_t glimit, tdog::i64_t gwarn)
     m_helper.raise_error("unknown exception thrown in test", 0);
   }
 
+  if (pc_open)
+  {
+    hw_counts hc;
+    pc.stop(hc);
+    m_helper.set_counts(hc);
+  }
+
+  alloc_counts ac = alloc_tracker::end(af);
+
    m_helper.stop_test();
+
+  if (m_helper.has_ran()) m_helper.set_allocs(ac);
 }
 //---------------------------------------------------------------------------
@@ -0,0 +1,199 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : bench_baseline.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "bench_baseline.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+// Standard scores for one-sided p of 0.001 and 0.05
+const double Z_FAIL = 3.090;
+const double Z_WARN = 1.645;
+
+// Smallest slowdown in median to fail
+const double MIN_SHIFT = 0.02;
+
+// Fewer samples than this are not compared
+const std::size_t MIN_SAMPLES = 5;
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+static double _median(std::vector<double> v)
+{
+  // Median of unsorted values. Not empty.
+  std::sort(v.begin(), v.end());
+  std::size_t h = v.size() / 2;
+  return (v.size() % 2 != 0) ? v[h] : (v[h - 1] + v[h]) / 2;
+}
+//---------------------------------------------------------------------------
+// CLASS bench_baseline : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+std::size_t bench_baseline::size() const
+{
+  return m_map.size();
+}
+//---------------------------------------------------------------------------
+const std::vector<double>* bench_baseline::get(const std::string& name) const
+{
+  std::map<std::string, std::vector<double> >::const_iterator it = m_map.find(name);
+  if (it != m_map.end()) return &it->second;
+  return 0;
+}
+//---------------------------------------------------------------------------
+void bench_baseline::set(const std::string& name, const std::vector<double>& samples)
+{
+  if (!name.empty() && !samples.empty()) m_map[name] = samples;
+}
+//---------------------------------------------------------------------------
+void bench_baseline::clear()
+{
+  m_map.clear();
+}
+//---------------------------------------------------------------------------
+bool bench_baseline::load(const std::string& filename)
+{
+  // Load from file. Malformed lines are skipped.
+  std::ifstream fs(filename.c_str());
+  if (!fs.is_open()) return false;
+
+  std::string line;
+
+  while(std::getline(fs, line))
+  {
+    line = trim_str(line);
+    if (line.empty() || line[0] == '#') continue;
+
+    std::size_t pos = line.find('\t');
+    if (pos == 0 || pos == std::string::npos) continue;
+
+    std::vector<double> samples;
+    std::istringstream ss(line.substr(pos + 1));
+    double v;
+
+    while(ss >> v)
+    {
+      if (v >= 0) samples.push_back(v);
+    }
+
+    set(trim_str(line.substr(0, pos)), samples);
+  }
+
+  return true;
+}
+//---------------------------------------------------------------------------
+bool bench_baseline::save(const std::string& filename) const
+{
+  // Write in name order
+  std::ofstream fs(filename.c_str());
+  if (!fs.is_open()) return false;
+
+  fs << "# TDOG benchmark baseline (ns per iteration)\n";
+
+  std::map<std::string, std::vector<double> >::const_iterator it;
+
+  for(it = m_map.begin(); it != m_map.end(); ++it)
+  {
+    fs << it->first << '\t';
+
+    for(std::size_t n = 0; n < it->second.size(); ++n)
+    {
+      if (n != 0) fs << ' ';
+      fs << double_to_str(it->second[n], "%.3f");
+    }
+
+    fs << '\n';
+  }
+
+  fs.close();
+  return !fs.fail();
+}
+//---------------------------------------------------------------------------
+bench_baseline::verdict bench_baseline::compare(const std::vector<double>& base,
+  const std::vector<double>& cur)
+{
+  // Mann-Whitney U, where the alternative is
+  // that the current samples are the slower.
+  verdict rslt;
+  std::size_t n1 = base.size();
+  std::size_t n2 = cur.size();
+
+  if (n1 < MIN_SAMPLES || n2 < MIN_SAMPLES) return rslt;
+
+  // Pool samples, marking those of current
+  std::vector< std::pair<double, int> > all;
+  all.reserve(n1 + n2);
+
+  for(std::size_t n = 0; n < n1; ++n) all.push_back(std::make_pair(base[n], 0));
+  for(std::size_t n = 0; n < n2; ++n) all.push_back(std::make_pair(cur[n], 1));
+
+  std::sort(all.begin(), all.end());
+
+  // Rank sum of current, with tied values
+  // given their mean rank
+  double r2 = 0;
+  double ties = 0;
+  std::size_t sz = all.size();
+
+  for(std::size_t i = 0; i < sz; )
+  {
+    std::size_t j = i + 1;
+    while(j < sz && all[j].first == all[i].first) ++j;
+
+    double rank = (i + 1 + j) / 2.0;
+    double t = static_cast<double>(j - i);
+    ties += t * t * t - t;
+
+    for(std::size_t k = i; k < j; ++k)
+    {
+      if (all[k].second != 0) r2 += rank;
+    }
+
+    i = j;
+  }
+
+  double dn1 = static_cast<double>(n1);
+  double dn2 = static_cast<double>(n2);
+  double dn = dn1 + dn2;
+
+  double u = r2 - dn2 * (dn2 + 1) / 2;
+  double var = dn1 * dn2 / 12 * ((dn + 1) - ties / (dn * (dn - 1)));
+
+  if (var <= 0) return rslt;
+
+  // Continuity corrected
+  rslt.z = (u - dn1 * dn2 / 2 - 0.5) / std::sqrt(var);
+
+  double mb = _median(base);
+  if (mb > 0) rslt.shift = _median(cur) / mb - 1;
+
+  if (rslt.z >= Z_FAIL && rslt.shift >= MIN_SHIFT)
+  {
+    rslt.type = ET_FAIL;
+  }
+  else
+  if (rslt.z >= Z_WARN && rslt.shift > 0)
+  {
+    rslt.type = ET_WARN;
+  }
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
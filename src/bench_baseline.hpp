@@ -0,0 +1,99 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : bench_baseline.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_BENCH_BASELINE_H
+#define TDOG_BENCH_BASELINE_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/private/run_helper.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Benchmark timings recorded by earlier runs, keyed on full test name.
+// For each test, the samples (ns per iteration) are held, rather than
+// the figures taken from them, so that later runs can be compared with
+// the distribution. Persisted as a text file, with one test per line in
+// the form:
+//
+// <full test name><TAB><sample ns> <sample ns> ...
+//
+// Blank lines, and those starting with '#', are ignored.
+//
+// Runs are compared using a one-sided Mann-Whitney U test, with the
+// normal approximation corrected for ties. A slowdown significant at
+// p < 0.001, and of at least 2% in the median, is a regression. One
+// significant only at p < 0.05, or smaller, is borderline.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS bench_baseline
+//---------------------------------------------------------------------------
+class bench_baseline
+{
+  private:
+
+  std::map<std::string, std::vector<double> > m_map;
+
+  public:
+
+  // Outcome of compare()
+  struct verdict
+  {
+    event_type_t type;  // <- ET_PASS, ET_WARN or ET_FAIL
+    double z;           // <- U statistic as standard score
+    double shift;       // <- change in median, i.e. 0.1 is 10% slower
+    verdict() : type(ET_PASS), z(0), shift(0) {}
+  };
+
+  // Number of tests held
+  std::size_t size() const;
+
+  // Recorded samples, or null if unknown
+  const std::vector<double>* get(const std::string& name) const;
+
+  // Record samples
+  void set(const std::string& name, const std::vector<double>& samples);
+
+  // Remove all
+  void clear();
+
+  // Load from file, merging with existing. Returns
+  // false if the file could not be opened.
+  bool load(const std::string& filename);
+
+  // Write to file. Returns false on failure.
+  bool save(const std::string& filename) const;
+
+  // Compare samples of a run with a baseline. Too few
+  // samples in either gives ET_PASS.
+  static verdict compare(const std::vector<double>& base,
+    const std::vector<double>& cur);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
@@ -0,0 +1,123 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : byte_codec.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "byte_codec.hpp"
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+//---------------------------------------------------------------------------
+// CLASS byte_writer : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+void byte_writer::put_u8(tdog::u8_t v)
+{
+  m_out += static_cast<char>(v);
+}
+//---------------------------------------------------------------------------
+void byte_writer::put_u32(tdog::u32_t v)
+{
+  // Little-endian
+  for(int n = 0; n < 4; ++n)
+  {
+    m_out += static_cast<char>(v & 0xFF);
+    v >>= 8;
+  }
+}
+//---------------------------------------------------------------------------
+void byte_writer::put_i32(tdog::i32_t v)
+{
+  put_u32(static_cast<tdog::u32_t>(v));
+}
+//---------------------------------------------------------------------------
+void byte_writer::put_i64(tdog::i64_t v)
+{
+  // Little-endian
+  tdog::u64_t u = static_cast<tdog::u64_t>(v);
+
+  for(int n = 0; n < 8; ++n)
+  {
+    m_out += static_cast<char>(u & 0xFF);
+    u >>= 8;
+  }
+}
+//---------------------------------------------------------------------------
+void byte_writer::put_str(const std::string& s)
+{
+  // Length prefixed
+  put_u32(static_cast<tdog::u32_t>(s.size()));
+  m_out += s;
+}
+//---------------------------------------------------------------------------
+// CLASS byte_reader : PRIVATE MEMBERS
+//---------------------------------------------------------------------------
+bool byte_reader::_take(std::size_t n)
+{
+  // True if n bytes available. Once
+  // overrun, all subsequent reads fail.
+  if (m_ok && remain() < n) m_ok = false;
+  return m_ok;
+}
+//---------------------------------------------------------------------------
+// CLASS byte_reader : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+tdog::u8_t byte_reader::get_u8()
+{
+  if (!_take(1)) return 0;
+  return static_cast<tdog::u8_t>(*m_pos++);
+}
+//---------------------------------------------------------------------------
+tdog::u32_t byte_reader::get_u32()
+{
+  if (!_take(4)) return 0;
+
+  tdog::u32_t rslt = 0;
+
+  for(int n = 3; n >= 0; --n)
+  {
+    rslt = (rslt << 8) | static_cast<tdog::u8_t>(m_pos[n]);
+  }
+
+  m_pos += 4;
+  return rslt;
+}
+//---------------------------------------------------------------------------
+tdog::i32_t byte_reader::get_i32()
+{
+  return static_cast<tdog::i32_t>(get_u32());
+}
+//---------------------------------------------------------------------------
+tdog::i64_t byte_reader::get_i64()
+{
+  if (!_take(8)) return 0;
+
+  tdog::u64_t rslt = 0;
+
+  for(int n = 7; n >= 0; --n)
+  {
+    rslt = (rslt << 8) | static_cast<tdog::u8_t>(m_pos[n]);
+  }
+
+  m_pos += 8;
+  return static_cast<tdog::i64_t>(rslt);
+}
+//---------------------------------------------------------------------------
+std::string byte_reader::get_str()
+{
+  std::size_t sz = get_u32();
+  if (!_take(sz)) return std::string();
+
+  std::string rslt(m_pos, sz);
+  m_pos += sz;
+  return rslt;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : byte_codec.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_BYTE_CODEC_H
+#define TDOG_BYTE_CODEC_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+
+#include <string>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Simple binary encoding used to pass test results between processes.
+// Integers are written little-endian irrespective of platform, and
+// strings are written as a 32-bit length followed by the bytes.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS byte_writer
+//---------------------------------------------------------------------------
+class byte_writer
+{
+  private:
+
+  std::string& m_out;
+
+  public:
+
+  // Appends to string
+  byte_writer(std::string& out) : m_out(out) {}
+
+  void put_u8(tdog::u8_t v);
+  void put_u32(tdog::u32_t v);
+  void put_i32(tdog::i32_t v);
+  void put_i64(tdog::i64_t v);
+  void put_str(const std::string& s);
+};
+
+//---------------------------------------------------------------------------
+// CLASS byte_reader
+//---------------------------------------------------------------------------
+class byte_reader
+{
+  private:
+
+  const char* m_pos;
+  const char* m_end;
+  bool m_ok;
+
+  bool _take(std::size_t n);
+
+  public:
+
+  // Reads from buffer, which must exist for life of reader
+  byte_reader(const char* data, std::size_t size)
+    : m_pos(data), m_end(data + size), m_ok(true) {}
+
+  // False if any read has overrun the data
+  bool ok() const { return m_ok; }
+
+  // Bytes remaining
+  std::size_t remain() const { return static_cast<std::size_t>(m_end - m_pos); }
+
+  tdog::u8_t get_u8();
+  tdog::u32_t get_u32();
+  tdog::i32_t get_i32();
+  tdog::i64_t get_i64();
+  std::string get_str();
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : duration_history.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "duration_history.hpp"
+#include "util.hpp"
+
+#include <cstdlib>
+#include <fstream>
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+//---------------------------------------------------------------------------
+// CLASS duration_history : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+std::size_t duration_history::size() const
+{
+  return m_map.size();
+}
+//---------------------------------------------------------------------------
+tdog::i64_t duration_history::get(const std::string& name) const
+{
+  std::map<std::string, tdog::i64_t>::const_iterator it = m_map.find(name);
+  if (it != m_map.end()) return it->second;
+  return -1;
+}
+//---------------------------------------------------------------------------
+void duration_history::set(const std::string& name, tdog::i64_t ms)
+{
+  if (!name.empty() && ms >= 0) m_map[name] = ms;
+}
+//---------------------------------------------------------------------------
+void duration_history::clear()
+{
+  m_map.clear();
+}
+//---------------------------------------------------------------------------
+bool duration_history::load(const std::string& filename)
+{
+  // Load from file. Malformed lines are skipped.
+  std::ifstream fs(filename.c_str());
+  if (!fs.is_open()) return false;
+
+  std::string line;
+
+  while(std::getline(fs, line))
+  {
+    line = trim_str(line);
+    if (line.empty() || line[0] == '#') continue;
+
+    std::size_t pos = line.find_first_not_of("0123456789");
+    if (pos == 0 || pos == std::string::npos) continue;
+
+    std::string name = trim_str(line.substr(pos));
+    set(name, std::atol(line.substr(0, pos).c_str()));
+  }
+
+  return true;
+}
+//---------------------------------------------------------------------------
+bool duration_history::save(const std::string& filename) const
+{
+  // Write in name order
+  std::ofstream fs(filename.c_str());
+  if (!fs.is_open()) return false;
+
+  fs << "# TDOG test duration history (ms)\n";
+
+  std::map<std::string, tdog::i64_t>::const_iterator it;
+
+  for(it = m_map.begin(); it != m_map.end(); ++it)
+  {
+    fs << static_cast<long>(it->second) << '\t' << it->first << '\n';
+  }
+
+  fs.close();
+  return !fs.fail();
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,78 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : duration_history.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_DURATION_HISTORY_H
+#define TDOG_DURATION_HISTORY_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+
+#include <string>
+#include <map>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Durations of test cases recorded by earlier runs, keyed on full test
+// name. Used to schedule the longest tests first when running tests
+// concurrently. Persisted as a text file, with one test per line in
+// the form:
+//
+// <duration ms><TAB><full test name>
+//
+// Blank lines, and those starting with '#', are ignored.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS duration_history
+//---------------------------------------------------------------------------
+class duration_history
+{
+  private:
+
+  std::map<std::string, tdog::i64_t> m_map;
+
+  public:
+
+  // Number of tests held
+  std::size_t size() const;
+
+  // Recorded duration in ms, or -1 if unknown
+  tdog::i64_t get(const std::string& name) const;
+
+  // Record duration in ms
+  void set(const std::string& name, tdog::i64_t ms);
+
+  // Remove all
+  void clear();
+
+  // Load from file, merging with existing. Returns
+  // false if the file could not be opened.
+  bool load(const std::string& filename);
+
+  // Write to file. Returns false on failure.
+  bool save(const std::string& filename) const;
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
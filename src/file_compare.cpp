@@ -0,0 +1,136 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : file_compare.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/private/run_helper.hpp"
+#include "file_window.hpp"
+
+#include <algorithm>
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+// Files are mapped (or read) this much at a time. A multiple
+// of 64 KB, so that window offsets are aligned as file_window
+// requires.
+const std::size_t FILE_CHUNK = 4 * 1024 * 1024;
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+static bool _locate(file_window& exp, file_diff& d)
+{
+  // Line and column of offset, counting newlines
+  // before it a window at a time
+  tdog::u64_t pos = static_cast<tdog::u64_t>(d.offset);
+  tdog::u64_t line_start = 0;
+  d.line = 1;
+
+  for(tdog::u64_t off = 0; off < pos; off += FILE_CHUNK)
+  {
+    std::size_t len = static_cast<std::size_t>(std::min<tdog::u64_t>(FILE_CHUNK, pos - off));
+    const char* p = exp.view(off, len);
+    if (p == 0) return false;
+
+    for(const char* q = p; (q = std::find(q, p + len, '\n')) != p + len; ++q)
+    {
+      ++d.line;
+      line_start = off + (q - p) + 1;
+    }
+  }
+
+  d.column = static_cast<tdog::i64_t>(pos - line_start) + 1;
+  return true;
+}
+//---------------------------------------------------------------------------
+static file_diff _compare(file_window& exp, file_window& act)
+{
+  // Compare a window at a time, up to the shorter
+  file_diff rslt;
+  rslt.exp_size = static_cast<tdog::i64_t>(exp.size());
+  rslt.act_size = static_cast<tdog::i64_t>(act.size());
+
+  tdog::u64_t common = std::min(exp.size(), act.size());
+
+  for(tdog::u64_t off = 0; off < common; off += FILE_CHUNK)
+  {
+    std::size_t len = static_cast<std::size_t>(std::min<tdog::u64_t>(FILE_CHUNK, common - off));
+    const char* pe = exp.view(off, len);
+    const char* pa = act.view(off, len);
+
+    if (pe == 0 || pa == 0)
+    {
+      rslt.error = "read failed";
+      return rslt;
+    }
+
+    std::size_t pos = mem_mismatch(pe, pa, len);
+
+    if (pos != std::string::npos)
+    {
+      rslt.offset = static_cast<tdog::i64_t>(off + pos);
+      break;
+    }
+  }
+
+  if (rslt.offset < 0 && exp.size() != act.size())
+  {
+    rslt.offset = static_cast<tdog::i64_t>(common);
+  }
+
+  if (rslt.offset >= 0 && !_locate(exp, rslt))
+  {
+    rslt.error = "read failed";
+  }
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
+// ROUTINES
+//---------------------------------------------------------------------------
+file_diff tdog::file_compare(const std::string& exp_file, const std::string& act_file)
+{
+  file_window exp, act;
+
+  if (!exp.open(exp_file, true))
+  {
+    file_diff rslt;
+    rslt.error = "cannot open file " + exp_file;
+    return rslt;
+  }
+
+  if (!act.open(act_file, true))
+  {
+    file_diff rslt;
+    rslt.error = "cannot open file " + act_file;
+    return rslt;
+  }
+
+  return _compare(exp, act);
+}
+//---------------------------------------------------------------------------
+file_diff tdog::file_compare(const std::string& exp_file, const void* act,
+  std::size_t size)
+{
+  file_window exp, buf;
+
+  if (!exp.open(exp_file, true))
+  {
+    file_diff rslt;
+    rslt.error = "cannot open file " + exp_file;
+    return rslt;
+  }
+
+  buf.open(act, size);
+  return _compare(exp, buf);
+}
+//---------------------------------------------------------------------------
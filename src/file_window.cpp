@@ -0,0 +1,187 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : file_window.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "file_window.hpp"
+
+#include <fstream>
+
+#if defined(_MSC_VER) || defined(WINDOWS) || defined(_WINDOWS) || \
+  defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64)
+  #define TDOG_WINDOWS
+  #include <windows.h>
+#else
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif // defined(_MSC_VER) ...
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+//---------------------------------------------------------------------------
+// CLASS file_window : PRIVATE MEMBERS
+//---------------------------------------------------------------------------
+void file_window::_unmap()
+{
+  // Release window, unless it is our buffer
+  if (m_view != 0 && m_view_len != 0 && (m_copy.empty() || m_view != &m_copy[0]))
+  {
+#if defined(TDOG_WINDOWS)
+    UnmapViewOfFile(m_view);
+#else
+    munmap(const_cast<char*>(m_view), m_view_len);
+#endif
+  }
+
+  m_view = 0;
+  m_view_len = 0;
+}
+//---------------------------------------------------------------------------
+// CLASS file_window : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+file_window::file_window()
+  : m_buf(0), m_size(0), m_sequential(false), m_view(0), m_view_len(0)
+{
+  // Constructor. Handles are null if not open.
+  m_fh = 0;
+  m_mh = 0;
+  m_fd = -1;
+}
+//---------------------------------------------------------------------------
+file_window::~file_window()
+{
+  // Destructor
+  close();
+}
+//---------------------------------------------------------------------------
+bool file_window::open(const std::string& filename, bool sequential)
+{
+  // Open file, but map nothing yet
+  close();
+  m_name = filename;
+  m_sequential = sequential;
+
+#if defined(TDOG_WINDOWS)
+  HANDLE fh = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+
+  if (fh == INVALID_HANDLE_VALUE) return false;
+  m_fh = fh;
+
+  DWORD hi = 0;
+  DWORD lo = GetFileSize(fh, &hi);
+
+  if (lo == INVALID_FILE_SIZE && GetLastError() != NO_ERROR)
+  {
+    close();
+    return false;
+  }
+
+  m_size = (static_cast<tdog::u64_t>(hi) << 32) | lo;
+
+  // Cannot map empty file
+  if (m_size != 0) m_mh = CreateFileMapping(fh, 0, PAGE_READONLY, 0, 0, 0);
+#else
+  m_fd = ::open(filename.c_str(), O_RDONLY);
+  if (m_fd < 0) return false;
+
+  struct stat st;
+
+  if (fstat(m_fd, &st) != 0)
+  {
+    close();
+    return false;
+  }
+
+  m_size = static_cast<tdog::u64_t>(st.st_size);
+#endif
+
+  return true;
+}
+//---------------------------------------------------------------------------
+void file_window::open(const void* buf, std::size_t size)
+{
+  // Wrap buffer
+  close();
+  m_buf = static_cast<const char*>(buf);
+  m_size = size;
+}
+//---------------------------------------------------------------------------
+void file_window::close()
+{
+  // Release window and file
+  _unmap();
+
+#if defined(TDOG_WINDOWS)
+  if (m_mh != 0) CloseHandle(static_cast<HANDLE>(m_mh));
+  if (m_fh != 0) CloseHandle(static_cast<HANDLE>(m_fh));
+#else
+  if (m_fd >= 0) ::close(m_fd);
+#endif
+
+  m_fh = 0;
+  m_mh = 0;
+  m_fd = -1;
+
+  m_name.clear();
+  m_buf = 0;
+  m_size = 0;
+  std::vector<char>().swap(m_copy);
+}
+//---------------------------------------------------------------------------
+const char* file_window::view(tdog::u64_t offset, std::size_t len)
+{
+  // Map window, or read it where it cannot be mapped
+  if (m_buf != 0) return m_buf + offset;
+
+  // Replace previous window
+  _unmap();
+
+  // Nothing to map
+  if (len == 0) return "";
+
+#if defined(TDOG_WINDOWS)
+  if (m_mh != 0)
+  {
+    m_view = static_cast<const char*>(MapViewOfFile(static_cast<HANDLE>(m_mh), FILE_MAP_READ,
+      static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset & 0xFFFFFFFF), len));
+  }
+#else
+  void* p = mmap(0, len, PROT_READ, MAP_PRIVATE, m_fd, static_cast<off_t>(offset));
+
+  if (p != MAP_FAILED)
+  {
+  #if defined(MADV_SEQUENTIAL)
+    if (m_sequential) madvise(p, len, MADV_SEQUENTIAL);
+  #endif
+    m_view = static_cast<const char*>(p);
+  }
+#endif
+
+  if (m_view == 0)
+  {
+    // Not mapped. Read into buffer instead.
+    std::ifstream fs(m_name.c_str(), std::ios::binary);
+    fs.seekg(static_cast<std::streamoff>(offset));
+
+    m_copy.resize(len);
+    if (!fs.read(&m_copy[0], static_cast<std::streamsize>(len))) return 0;
+
+    m_view = &m_copy[0];
+  }
+
+  m_view_len = len;
+  return m_view;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : file_window.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_FILE_WINDOW_H
+#define TDOG_FILE_WINDOW_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+#include "tdog/types.hpp"
+
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Read only view of a file, one window at a time. Only one window is
+// held, so that memory use is bounded, and a window may span the whole
+// file. Where a window cannot be mapped, i.e. the file is empty or the
+// platform does not support it, it is read into a buffer instead. May
+// also wrap a memory buffer, so that files and buffers are read the
+// same way.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS file_window
+//---------------------------------------------------------------------------
+class file_window
+{
+  private:
+
+  std::string m_name;
+  const char* m_buf;
+  tdog::u64_t m_size;
+  bool m_sequential;
+  const char* m_view;
+  std::size_t m_view_len;
+  std::vector<char> m_copy;
+  void* m_fh;
+  void* m_mh;
+  int m_fd;
+
+  // No copy
+  file_window(const file_window&);
+  file_window& operator=(const file_window&);
+
+  // Release window, if mapped
+  void _unmap();
+
+  public:
+
+  file_window();
+  ~file_window();
+
+  // Opens file, but maps nothing until view() is called. Where
+  // sequential is true, windows are advised for sequential read.
+  bool open(const std::string& filename, bool sequential = false);
+  void open(const void* buf, std::size_t size);
+  void close();
+
+  tdog::u64_t size() const { return m_size; }
+
+  // Window of len bytes at offset, where offset is a multiple of 64 KB,
+  // i.e. the Windows allocation granularity, as mapping requires.
+  // Replaces the previous window. Null if it cannot be read.
+  const char* view(tdog::u64_t offset, std::size_t len);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
@@ -0,0 +1,250 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : float_compare.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/private/run_helper.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// SSE2 is part of x86-64, and is assumed
+// where the compiler targets it.
+#if defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define TDOG_SSE2
+#endif
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+#if defined(TDOG_SSE2)
+
+// Set bits in a 4-bit mask
+static const int BIT_COUNT[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+#endif // TDOG_SSE2
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+template <bool REL>
+static inline bool _within(double e, double a, double tol)
+{
+  // Absolute or relative tolerance. The vector
+  // kernels use the same arithmetic, so agree.
+  return a == e || std::fabs(a - e) <= (REL ? tol * std::fabs(e) : tol);
+}
+//---------------------------------------------------------------------------
+static tdog::i64_t _ordered(double v)
+{
+  // Bits as an integer which orders as the value
+  // does, with -0 and +0 the same
+  tdog::u64_t u;
+  std::memcpy(&u, &v, sizeof(u));
+
+  tdog::i64_t m = static_cast<tdog::i64_t>(u & ~(static_cast<tdog::u64_t>(1) << 63));
+  return (u >> 63) ? -m : m;
+}
+//---------------------------------------------------------------------------
+static tdog::i64_t _ordered(float v)
+{
+  // As above
+  tdog::u32_t u;
+  std::memcpy(&u, &v, sizeof(u));
+
+  tdog::i64_t m = static_cast<tdog::i64_t>(u & 0x7FFFFFFFu);
+  return (u >> 31) ? -m : m;
+}
+//---------------------------------------------------------------------------
+template <typename T>
+static tdog::u64_t _ulp_dist(T e, T a)
+{
+  // Representable values between, or the
+  // maximum where either is NaN
+  if (e != e || a != a) return ~static_cast<tdog::u64_t>(0);
+
+  tdog::i64_t oe = _ordered(e);
+  tdog::i64_t oa = _ordered(a);
+
+  if (oa >= oe) return static_cast<tdog::u64_t>(oa) - static_cast<tdog::u64_t>(oe);
+  return static_cast<tdog::u64_t>(oe) - static_cast<tdog::u64_t>(oa);
+}
+//---------------------------------------------------------------------------
+template <typename T>
+static std::size_t _count_ulp(const T* e, const T* a, std::size_t cnt, double tol)
+{
+  // Mismatches in ULP mode
+  std::size_t rslt = 0;
+
+  for(std::size_t n = 0; n < cnt; ++n)
+  {
+    bool nan = (e[n] != e[n] || a[n] != a[n]);
+    rslt += (nan || static_cast<double>(_ulp_dist(e[n], a[n])) > tol);
+  }
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
+template <bool REL, typename T>
+static std::size_t _count_scalar(const T* e, const T* a, std::size_t cnt, double tol)
+{
+  // Mismatches in absolute or relative mode
+  std::size_t rslt = 0;
+
+  for(std::size_t n = 0; n < cnt; ++n)
+  {
+    rslt += !_within<REL>(e[n], a[n], tol);
+  }
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
+#if defined(TDOG_SSE2)
+template <bool REL>
+static inline int _within_mask(__m128d ve, __m128d va, __m128d vt)
+{
+  // Two lane form of _within(), with a bit set for each within
+  const __m128d SIGN = _mm_set1_pd(-0.0);
+  __m128d lim = REL ? _mm_mul_pd(vt, _mm_andnot_pd(SIGN, ve)) : vt;
+  __m128d diff = _mm_andnot_pd(SIGN, _mm_sub_pd(va, ve));
+
+  return _mm_movemask_pd(_mm_or_pd(_mm_cmpeq_pd(va, ve), _mm_cmple_pd(diff, lim)));
+}
+//---------------------------------------------------------------------------
+template <bool REL>
+static std::size_t _count_sse2(const double* e, const double* a,
+  std::size_t cnt, double tol)
+{
+  // 2 doubles at a time, with remainder scalar
+  const __m128d vt = _mm_set1_pd(tol);
+  std::size_t rslt = 0;
+  std::size_t n = 0;
+
+  for(; n + 2 <= cnt; n += 2)
+  {
+    int m = _within_mask<REL>(_mm_loadu_pd(e + n), _mm_loadu_pd(a + n), vt);
+    rslt += 2 - BIT_COUNT[m];
+  }
+
+  return rslt + _count_scalar<REL>(e + n, a + n, cnt - n, tol);
+}
+//---------------------------------------------------------------------------
+template <bool REL>
+static std::size_t _count_sse2(const float* e, const float* a,
+  std::size_t cnt, double tol)
+{
+  // 4 floats at a time, widened to double so
+  // as to agree with the scalar remainder
+  const __m128d vt = _mm_set1_pd(tol);
+  std::size_t rslt = 0;
+  std::size_t n = 0;
+
+  for(; n + 4 <= cnt; n += 4)
+  {
+    __m128 fe = _mm_loadu_ps(e + n);
+    __m128 fa = _mm_loadu_ps(a + n);
+
+    int lo = _within_mask<REL>(_mm_cvtps_pd(fe), _mm_cvtps_pd(fa), vt);
+    int hi = _within_mask<REL>(_mm_cvtps_pd(_mm_movehl_ps(fe, fe)),
+      _mm_cvtps_pd(_mm_movehl_ps(fa, fa)), vt);
+
+    rslt += 4 - BIT_COUNT[lo | (hi << 2)];
+  }
+
+  return rslt + _count_scalar<REL>(e + n, a + n, cnt - n, tol);
+}
+#endif
+//---------------------------------------------------------------------------
+template <typename T>
+static std::size_t _count(const T* e, const T* a, std::size_t cnt,
+  tol_t mode, double tol)
+{
+  // Mismatches in the given mode. ULP mode compares integer
+  // representations, so is scalar without 64-bit vector compares.
+  if (mode == TOL_ULP) return _count_ulp(e, a, cnt, tol);
+
+#if defined(TDOG_SSE2)
+  if (mode == TOL_REL) return _count_sse2<true>(e, a, cnt, tol);
+  return _count_sse2<false>(e, a, cnt, tol);
+#else
+  if (mode == TOL_REL) return _count_scalar<true>(e, a, cnt, tol);
+  return _count_scalar<false>(e, a, cnt, tol);
+#endif
+}
+//---------------------------------------------------------------------------
+template <typename T>
+static void _stats(const T* e, const T* a, std::size_t cnt, tol_t mode,
+  float_diff& d)
+{
+  // Largest errors, and the index of the worst in the given mode.
+  // Only called on failure, so need not be fast. Errors from NaN
+  // are taken to be infinite.
+  const double INF = std::numeric_limits<double>::infinity();
+  double worst = -1;
+
+  for(std::size_t n = 0; n < cnt; ++n)
+  {
+    double ev = e[n];
+    double av = a[n];
+
+    double ab = (av == ev) ? 0 : std::fabs(av - ev);
+    if (ab != ab) ab = INF;
+
+    double rl = (ab == 0) ? 0 : ((ev != 0) ? ab / std::fabs(ev) : INF);
+    if (rl != rl) rl = INF;
+
+    tdog::u64_t ul = _ulp_dist(e[n], a[n]);
+
+    if (ab > d.max_abs) d.max_abs = ab;
+    if (rl > d.max_rel) d.max_rel = rl;
+    if (ul > d.max_ulp) d.max_ulp = ul;
+
+    double m = (mode == TOL_ABS) ? ab : ((mode == TOL_REL) ? rl : static_cast<double>(ul));
+
+    if (m > worst)
+    {
+      worst = m;
+      d.worst = n;
+    }
+  }
+}
+//---------------------------------------------------------------------------
+template <typename T>
+static float_diff _compare(const T* e, const T* a, std::size_t cnt,
+  tol_t mode, double tol)
+{
+  // Count mismatches, and where there are
+  // any, make a second pass for statistics
+  float_diff rslt;
+  rslt.mismatches = _count(e, a, cnt, mode, tol);
+
+  if (rslt.mismatches != 0) _stats(e, a, cnt, mode, rslt);
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
+// ROUTINES
+//---------------------------------------------------------------------------
+float_diff tdog::float_compare(const double* exp, const double* act,
+  std::size_t cnt, tol_t mode, double tol)
+{
+  return _compare(exp, act, cnt, mode, tol);
+}
+//---------------------------------------------------------------------------
+float_diff tdog::float_compare(const float* exp, const float* act,
+  std::size_t cnt, tol_t mode, double tol)
+{
+  return _compare(exp, act, cnt, mode, tol);
+}
+//---------------------------------------------------------------------------
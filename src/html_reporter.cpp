@@ -42,6 +42,7 @@ const char* const FAIL_DETAILS = "Output: Test Failures";
 const char* const ERROR_DETAILS = "Output: Test Errors";
 const char* const PASS_DETAILS = "Output: Test Passes";
 const char* const SKIPPED_TESTS = "Skipped or Disabled Tests";
+const char* const BENCH_RESULTS = "Benchmark Results";
 const char* const SKIPPED_NOTES = "The following tests were not executed:";
 const char* const END_TIME_LEADER = "End Time: ";
 const char* const DURATION_LEADER = "Run Duration: ";
@@ -51,6 +52,12 @@ const char* const TAB_AUTHOR = "Author";
 const char* const TAB_START_TIME = "Start Time";
 const char* const TAB_DURATION = "Duration";
 const char* const TAB_RESULT = "Result";
+const char* const BENCH_TAB_MEDIAN = "Median";
+const char* const BENCH_TAB_P90 = "P90";
+const char* const BENCH_TAB_P99 = "P99";
+const char* const BENCH_TAB_MAD = "MAD";
+const char* const BENCH_TAB_OPS = "Ops/sec";
+const char* const BENCH_TAB_SAMPLES = "Samples";
 const char* const STAT_TAB_METRIC = "Statistic";
 const char* const STAT_TAB_VALUE = "Value";
 const char* const STAT_TAB_RAN = "Ran";
@@ -81,6 +88,8 @@ void html_reporter::_impl_clear()
   m_fail_trace.clear();
   m_error_trace.clear();
   m_skipped_tests.clear();
+  m_bench_names.clear();
+  m_bench_results.clear();
 }
 //---------------------------------------------------------------------------
 std::ostream& html_reporter::_generate_css(std::ostream& os)
@@ -356,7 +365,7 @@ void html_reporter::gen_start(std::ostream& os)
   }
 
   // Name and platform OS
-  temp_str = xml_esc(tdog::hostname());
+  temp_str = xml_esc(owner().run_hostname());
   os << _indent() << "<strong>" << PROJECT_HOST_LEADER << "</strong>";
   os << temp_str << "<br/>\n";
 
@@ -602,6 +611,13 @@ void html_reporter::gen_test(std::ostream& os, const basic_test* tc)
     os << _indent() << _td_str(iso_time(helper.start_time())) << "\n";
     os << _indent() << _td_str(duration_str(helper.duration())) << "\n";
 
+    if (helper.bench().valid())
+    {
+      // Written in own table at end
+      m_bench_names.push_back(xml_esc(tc->full_name()));
+      m_bench_results.push_back(helper.bench());
+    }
+
     // Color pass/fail value
     status_t stat = helper.status();
     os << _indent() << _td_str(status_str(stat), !helper.has_passed(), _cond_classid(stat));
@@ -751,6 +767,41 @@ void html_reporter::gen_end(std::ostream& os)
 
   os << _indent(-1) << "</p>\n";
 
+  if (!m_bench_results.empty())
+  {
+    // Benchmark figures, per iteration
+    os << _indent() << _page_anchor("bench_results") << "\n";
+    os << _indent() << "<h2>" << BENCH_RESULTS << "</h2>\n";
+
+    os << _indent(+1) << "<table style=\"width:75%; max-width:100em\">\n";
+    os << _indent(+1) << "<tr>\n";
+    os << _indent() << _th_str(TAB_TEST_NAME) << "\n";
+    os << _indent() << _th_str(BENCH_TAB_MEDIAN, "10%") << "\n";
+    os << _indent() << _th_str(BENCH_TAB_P90, "10%") << "\n";
+    os << _indent() << _th_str(BENCH_TAB_P99, "10%") << "\n";
+    os << _indent() << _th_str(BENCH_TAB_MAD, "10%") << "\n";
+    os << _indent() << _th_str(BENCH_TAB_OPS, "12%") << "\n";
+    os << _indent() << _th_str(BENCH_TAB_SAMPLES, "12%") << "\n";
+    os << _indent(-1) << "</tr>\n";
+
+    for(std::size_t n = 0; n < m_bench_results.size(); ++n)
+    {
+      const bench_result& b = m_bench_results[n];
+
+      os << _indent(+1) << "<tr>\n";
+      os << _indent() << _td_str(m_bench_names[n]) << "\n";
+      os << _indent() << _td_str(bench_time_str(b.median_ns)) << "\n";
+      os << _indent() << _td_str(bench_time_str(b.p90_ns)) << "\n";
+      os << _indent() << _td_str(bench_time_str(b.p99_ns)) << "\n";
+      os << _indent() << _td_str(bench_time_str(b.mad_ns)) << "\n";
+      os << _indent() << _td_str(double_to_str(b.ops_per_sec(), "%.0f")) << "\n";
+      os << _indent() << _td_str(int_to_str(b.samples) + " x " + int_to_str(b.batch)) << "\n";
+      os << _indent(-1) << "</tr>\n";
+    }
+
+    os << _indent(-1) << "</table>\n";
+  }
+
   if (!m_decl_flag)
   {
     // Additional content
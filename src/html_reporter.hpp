@@ -50,6 +50,8 @@ class html_reporter : public basic_reporter
   std::vector<std::string> m_fail_trace;
   std::vector<std::string> m_error_trace;
   std::vector<std::string> m_skipped_tests;
+  std::vector<std::string> m_bench_names;
+  std::vector<bench_result> m_bench_results;
 
   void _impl_clear();
   std::ostream& _generate_css(std::ostream& os);
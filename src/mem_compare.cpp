@@ -0,0 +1,187 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : mem_compare.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/private/run_helper.hpp"
+
+#include <cstring>
+
+// SSE2 is part of x86-64, and is assumed where the compiler
+// targets it. AVX2 is used only where the CPU reports it, so
+// is compiled separately with a target attribute.
+#if defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define TDOG_SSE2
+#endif
+
+#if defined(TDOG_SSE2) && (defined(__x86_64__) || defined(__i386__)) && \
+  (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+  #include <immintrin.h>
+  #define TDOG_AVX2
+  #define TDOG_AVX2_FUNC __attribute__((target("avx2")))
+#elif defined(TDOG_SSE2) && defined(_MSC_VER) && _MSC_VER >= 1800
+  #include <immintrin.h>
+  #include <intrin.h>
+  #define TDOG_AVX2
+  #define TDOG_AVX2_FUNC
+#endif
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+// Compare routine for the CPU
+typedef std::size_t (*mismatch_fn)(const unsigned char*, const unsigned char*,
+  std::size_t);
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+static std::size_t _first_bit(unsigned int m)
+{
+  // Index of lowest set bit, where m != 0
+#if defined(__GNUC__)
+  return static_cast<std::size_t>(__builtin_ctz(m));
+#else
+  std::size_t n = 0;
+  while((m & 1) == 0) { m >>= 1; ++n; }
+  return n;
+#endif
+}
+//---------------------------------------------------------------------------
+static std::size_t _mismatch_scalar(const unsigned char* a, const unsigned char* b,
+  std::size_t bytes)
+{
+  // Portable fallback, comparing a word at a time
+  std::size_t n = 0;
+  tdog::u64_t wa, wb;
+
+  for(; n + 8 <= bytes; n += 8)
+  {
+    std::memcpy(&wa, a + n, 8);
+    std::memcpy(&wb, b + n, 8);
+    if (wa != wb) break;
+  }
+
+  for(; n < bytes; ++n)
+  {
+    if (a[n] != b[n]) return n;
+  }
+
+  return std::string::npos;
+}
+//---------------------------------------------------------------------------
+#if defined(TDOG_SSE2)
+static std::size_t _mismatch_sse2(const unsigned char* a, const unsigned char* b,
+  std::size_t bytes)
+{
+  // 16 bytes at a time, with remainder scalar
+  std::size_t n = 0;
+
+  for(; n + 16 <= bytes; n += 16)
+  {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n));
+    unsigned int m = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+
+    if (m != 0xFFFF) return n + _first_bit(~m & 0xFFFF);
+  }
+
+  std::size_t r = _mismatch_scalar(a + n, b + n, bytes - n);
+  return (r != std::string::npos) ? n + r : r;
+}
+#endif
+//---------------------------------------------------------------------------
+#if defined(TDOG_AVX2)
+TDOG_AVX2_FUNC
+static std::size_t _mismatch_avx2(const unsigned char* a, const unsigned char* b,
+  std::size_t bytes)
+{
+  // 64 bytes at a time, then 32, with remainder by SSE2
+  std::size_t n = 0;
+
+  for(; n + 64 <= bytes; n += 64)
+  {
+    __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + n));
+    __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + n));
+    __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + n + 32));
+    __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + n + 32));
+    __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(a0, b0), _mm256_cmpeq_epi8(a1, b1));
+
+    if (static_cast<unsigned int>(_mm256_movemask_epi8(eq)) != 0xFFFFFFFFu) break;
+  }
+
+  for(; n + 32 <= bytes; n += 32)
+  {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + n));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + n));
+    unsigned int m = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+
+    if (m != 0xFFFFFFFFu) return n + _first_bit(~m);
+  }
+
+  std::size_t r = _mismatch_sse2(a + n, b + n, bytes - n);
+  return (r != std::string::npos) ? n + r : r;
+}
+//---------------------------------------------------------------------------
+static bool _has_avx2()
+{
+  // True if CPU and OS support AVX2
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) return false;
+
+  // OSXSAVE and AVX, then OS saves YMM state
+  __cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+  if ((_xgetbv(0) & 6) != 6) return false;
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+//---------------------------------------------------------------------------
+static mismatch_fn _select()
+{
+  // Best routine for this CPU
+#if defined(TDOG_AVX2)
+  if (_has_avx2()) return _mismatch_avx2;
+#endif
+
+#if defined(TDOG_SSE2)
+  return _mismatch_sse2;
+#else
+  return _mismatch_scalar;
+#endif
+}
+//---------------------------------------------------------------------------
+// ROUTINES
+//---------------------------------------------------------------------------
+std::size_t tdog::mem_mismatch(const void* a, const void* b, std::size_t bytes)
+{
+  // First byte which differs, or npos. The routine is
+  // chosen on first use. Threads racing here will
+  // store the same value.
+  static mismatch_fn s_mismatch = 0;
+
+  if (a == b || bytes == 0) return std::string::npos;
+  if (s_mismatch == 0) s_mismatch = _select();
+
+  return s_mismatch(static_cast<const unsigned char*>(a),
+    static_cast<const unsigned char*>(b), bytes);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,120 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : name_matcher.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "name_matcher.hpp"
+#include "tdog/private/basic_test.hpp"
+#include "tdog/private/suite_manager.hpp"
+#include "util.hpp"
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+//---------------------------------------------------------------------------
+// CLASS name_matcher : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+name_matcher::name_matcher()
+{
+  // Default constructor
+  m_all = false;
+}
+//---------------------------------------------------------------------------
+name_matcher::name_matcher(const std::string& pattern)
+{
+  // Single pattern
+  m_all = false;
+  add(pattern);
+}
+//---------------------------------------------------------------------------
+name_matcher::name_matcher(const std::vector<std::string>& patterns)
+{
+  // Pattern list
+  m_all = false;
+
+  for(std::size_t n = 0; n < patterns.size(); ++n)
+  {
+    add(patterns[n]);
+  }
+}
+//---------------------------------------------------------------------------
+void name_matcher::add(const std::string& pattern)
+{
+  // Parse as for basic_test::name_equals()
+  const std::size_t NSZ = std::string(NSSEP).size();
+  const std::string XSFX = std::string(NSSEP) + "*";
+
+  std::string tn = trim_str(pattern);
+
+  if (tn.empty()) return;
+
+  if (tn == "*" || tn == XSFX)
+  {
+    m_all = true;
+    return;
+  }
+
+  if (tn.size() > NSZ && tn.substr(0, NSZ) == NSSEP)
+  {
+    // Remove leading "::"
+    tn.erase(0, NSZ);
+  }
+
+  if (is_suffix(tn, NSSEP))
+  {
+    // Tests directly in suite
+    tn.erase(tn.size() - NSZ, NSZ);
+    m_suites.insert(tn);
+  }
+  else
+  if (is_suffix(tn, XSFX))
+  {
+    // Suite and nested suites
+    tn.erase(tn.size() - XSFX.size(), XSFX.size());
+    m_trees.insert(tn);
+  }
+  else
+  {
+    m_names.insert(tn);
+  }
+}
+//---------------------------------------------------------------------------
+bool name_matcher::empty() const
+{
+  return (!m_all && m_names.empty() && m_suites.empty() && m_trees.empty());
+}
+//---------------------------------------------------------------------------
+bool name_matcher::matches(const basic_test* tc) const
+{
+  // True if test matches any pattern
+  if (m_all) return true;
+
+  const std::string& sname = tc->suite_name();
+
+  if (!m_names.empty() && m_names.count(tc->full_name()) != 0) return true;
+  if (!m_suites.empty() && m_suites.count(sname) != 0) return true;
+
+  if (!m_trees.empty())
+  {
+    // Suite itself, then each parent. The default
+    // suite is not a parent, as "::*" matches all.
+    std::size_t pos = sname.size();
+
+    while(pos != std::string::npos && pos > 0)
+    {
+      if (m_trees.count(sname.substr(0, pos)) != 0) return true;
+      pos = (pos > 1) ? sname.rfind(NSSEP, pos - 1) : std::string::npos;
+    }
+  }
+
+  return false;
+}
+//---------------------------------------------------------------------------
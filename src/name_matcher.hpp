@@ -0,0 +1,86 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : name_matcher.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_NAME_MATCHER_H
+#define TDOG_NAME_MATCHER_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <set>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// A list of test name patterns, parsed once so that each test can be
+// matched without string parsing. A test matches if it would match any
+// of the patterns according to basic_test::name_equals() with precise
+// false. Patterns are split into:
+//  - "*" or "::*", matching everything,
+//  - full test names,
+//  - "suite::", matching tests directly in suite,
+//  - "suite::*", matching tests in suite or any nested under it.
+// The last of these is matched by looking up the test's suite name and
+// each of its parent suite names.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+// Forward declarations
+class basic_test;
+
+//---------------------------------------------------------------------------
+// CLASS name_matcher
+//---------------------------------------------------------------------------
+class name_matcher
+{
+  private:
+
+  bool m_all;
+  std::set<std::string> m_names;
+  std::set<std::string> m_suites;
+  std::set<std::string> m_trees;
+
+  public:
+
+  name_matcher();
+  name_matcher(const std::string& pattern);
+  name_matcher(const std::vector<std::string>& patterns);
+
+  // Add pattern
+  void add(const std::string& pattern);
+
+  // True if no patterns
+  bool empty() const;
+
+  // True if test matches any pattern
+  bool matches(const basic_test* tc) const;
+
+  // Parsed patterns, i.e. so that a query
+  // can be answered without matching each test
+  inline bool all() const { return m_all; }
+  inline const std::set<std::string>& names() const { return m_names; }
+  inline const std::set<std::string>& suites() const { return m_suites; }
+  inline const std::set<std::string>& trees() const { return m_trees; }
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
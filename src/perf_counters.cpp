@@ -0,0 +1,179 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : perf_counters.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "perf_counters.hpp"
+
+#if defined(__linux__)
+  #include <linux/perf_event.h>
+  #include <sys/syscall.h>
+  #include <sys/ioctl.h>
+  #include <unistd.h>
+  #include <cstring>
+  #if defined(__NR_perf_event_open)
+    #define TDOG_PERF
+  #endif
+#endif
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+#if defined(TDOG_PERF)
+
+// Counters in the order of hw_counts
+static const tdog::u64_t PERF_CONFIG[] =
+{
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_MISSES,
+  PERF_COUNT_HW_BRANCH_MISSES
+};
+
+#endif // TDOG_PERF
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+#if defined(TDOG_PERF)
+static int _perf_open(tdog::u64_t config)
+{
+  // Open disabled counter for calling thread,
+  // on any CPU. Returns -1 on failure.
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+//---------------------------------------------------------------------------
+static tdog::i64_t _perf_read(int fd)
+{
+  // Read counter value, scaled where multiplexed
+  // by the kernel. Returns -1 if not counted.
+  tdog::u64_t buf[3];
+
+  if (fd < 0 || read(fd, buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)))
+  {
+    return -1;
+  }
+
+  if (buf[2] == 0) return -1;
+
+  if (buf[2] < buf[1])
+  {
+    return static_cast<tdog::i64_t>(static_cast<double>(buf[0]) * buf[1] / buf[2]);
+  }
+
+  return static_cast<tdog::i64_t>(buf[0]);
+}
+#endif
+//---------------------------------------------------------------------------
+// CLASS perf_counters : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+perf_counters::perf_counters()
+  : m_started(false)
+{
+  for(int n = 0; n < HW_COUNT; ++n)
+  {
+    m_fd[n] = -1;
+  }
+}
+//---------------------------------------------------------------------------
+perf_counters::~perf_counters()
+{
+  close();
+}
+//---------------------------------------------------------------------------
+bool perf_counters::supported()
+{
+#if defined(TDOG_PERF)
+  return true;
+#else
+  return false;
+#endif
+}
+//---------------------------------------------------------------------------
+bool perf_counters::open()
+{
+  // Open what we can. Not permitted, or not
+  // present, leaves the descriptor at -1.
+  close();
+  bool rslt = false;
+
+#if defined(TDOG_PERF)
+  for(int n = 0; n < HW_COUNT; ++n)
+  {
+    m_fd[n] = _perf_open(PERF_CONFIG[n]);
+    if (m_fd[n] >= 0) rslt = true;
+  }
+#endif
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
+void perf_counters::close()
+{
+#if defined(TDOG_PERF)
+  for(int n = 0; n < HW_COUNT; ++n)
+  {
+    if (m_fd[n] >= 0) ::close(m_fd[n]);
+    m_fd[n] = -1;
+  }
+#endif
+
+  m_started = false;
+}
+//---------------------------------------------------------------------------
+void perf_counters::start()
+{
+  // Reset and enable
+#if defined(TDOG_PERF)
+  for(int n = 0; n < HW_COUNT; ++n)
+  {
+    if (m_fd[n] >= 0)
+    {
+      ioctl(m_fd[n], PERF_EVENT_IOC_RESET, 0);
+      ioctl(m_fd[n], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  m_started = true;
+#endif
+}
+//---------------------------------------------------------------------------
+void perf_counters::stop(hw_counts& out)
+{
+  // Disable and read
+  out = hw_counts();
+
+#if defined(TDOG_PERF)
+  if (!m_started) return;
+
+  for(int n = 0; n < HW_COUNT; ++n)
+  {
+    if (m_fd[n] >= 0) ioctl(m_fd[n], PERF_EVENT_IOC_DISABLE, 0);
+  }
+
+  out.cycles = _perf_read(m_fd[0]);
+  out.instructions = _perf_read(m_fd[1]);
+  out.cache_misses = _perf_read(m_fd[2]);
+  out.branch_misses = _perf_read(m_fd[3]);
+  m_started = false;
+#endif
+}
+//---------------------------------------------------------------------------
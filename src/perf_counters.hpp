@@ -0,0 +1,80 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : perf_counters.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_PERF_COUNTERS_H
+#define TDOG_PERF_COUNTERS_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+#include "tdog/private/run_helper.hpp"
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Hardware counters (cycles, instructions, cache misses and branch misses)
+// for the calling thread, read with perf_event_open() on Linux. Counters
+// count user space only, so that they are permitted at the default
+// perf_event_paranoid level. Each counter is opened separately, so that
+// one which the CPU lacks does not prevent the others. Where the kernel
+// multiplexes counters, values are scaled by the time each was running.
+//
+// Elsewhere, or where perf is not permitted (i.e. in a container without
+// the syscall), open() returns false and no counts are given.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS perf_counters
+//---------------------------------------------------------------------------
+class perf_counters
+{
+  private:
+
+  static const int HW_COUNT = 4;
+  int m_fd[HW_COUNT];
+  bool m_started;
+
+  // No copy
+  perf_counters(const perf_counters&);
+  perf_counters& operator=(const perf_counters&);
+
+  public:
+
+  perf_counters();
+  ~perf_counters();
+
+  // True if platform supports it
+  static bool supported();
+
+  // Open counters for the calling thread. Returns
+  // false if none could be opened.
+  bool open();
+  void close();
+
+  // Count between start() and stop(). Counters
+  // which could not be read are given as -1.
+  void start();
+  void stop(hw_counts& out);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
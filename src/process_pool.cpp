@@ -0,0 +1,468 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : process_pool.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "process_pool.hpp"
+#include "tdog/private/basic_test.hpp"
+#include "byte_codec.hpp"
+#include "work_queue.hpp"
+#include "watchdog.hpp"
+#include "util.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+#if defined(_MSC_VER) || defined(WINDOWS) || defined(_WINDOWS) || \
+  defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64)
+  #define TDOG_WINDOWS
+#else
+  #include <errno.h>
+  #include <unistd.h>
+  #include <poll.h>
+  #include <signal.h>
+  #include <sys/types.h>
+  #include <sys/wait.h>
+#endif // defined(_MSC_VER) ...
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+// Size of frame header, holding
+// test index and payload length.
+const std::size_t FRAME_HEAD_SZ = 8;
+
+// Command telling worker to exit
+const tdog::u32_t CMD_STOP = 0xFFFFFFFF;
+
+// No current item
+const std::size_t NO_ITEM = static_cast<std::size_t>(-1);
+
+#if !defined(TDOG_WINDOWS)
+
+// State of a worker process
+struct worker_state
+{
+  pid_t pid;
+  int fd;                 // <- results from worker
+  int cmd;                // <- commands to worker
+  std::size_t current;    // <- index of item being run
+  tdog::i64_t item_start; // <- time current item started
+  std::string buf;        // <- unparsed data from worker
+
+  worker_state() : pid(0), fd(-1), cmd(-1), current(NO_ITEM), item_start(0) {}
+};
+
+#endif // TDOG_WINDOWS
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+#if !defined(TDOG_WINDOWS)
+static bool _write_all(int fd, const std::string& s)
+{
+  // Write everything, or return false
+  const char* p = s.data();
+  std::size_t sz = s.size();
+
+  while(sz > 0)
+  {
+    ssize_t w = write(fd, p, sz);
+
+    if (w < 0)
+    {
+      if (errno == EINTR) continue;
+      return false;
+    }
+
+    p += w;
+    sz -= static_cast<std::size_t>(w);
+  }
+
+  return true;
+}
+//---------------------------------------------------------------------------
+static bool _read_all(int fd, char* p, std::size_t sz)
+{
+  // Read exactly sz bytes, or return false
+  while(sz > 0)
+  {
+    ssize_t r = read(fd, p, sz);
+
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return false;
+
+    p += r;
+    sz -= static_cast<std::size_t>(r);
+  }
+
+  return true;
+}
+//---------------------------------------------------------------------------
+static void _run_inline(std::size_t id, work_queue& queue,
+  const std::vector<basic_test*>& group, tdog::i64_t glimit, tdog::i64_t gwarn,
+  bool counters)
+{
+  // Fallback where we cannot fork. Run
+  // remaining items in this process.
+  std::size_t idx;
+
+  while(queue.take(id, idx))
+  {
+    group[idx]->run(glimit, gwarn, counters);
+  }
+}
+//---------------------------------------------------------------------------
+static void _child_main(int cmd, int fd, const std::vector<basic_test*>& group,
+  tdog::i64_t glimit, tdog::i64_t gwarn, bool counters, bool stacks)
+{
+  // Worker process. Runs each item it is sent
+  // until told to stop. Never returns. A test
+  // which hangs past its limit ends the process.
+  std::string payload, frame;
+  char cbuf[4];
+  watchdog wd(true, stacks);
+
+  while(_read_all(cmd, cbuf, sizeof(cbuf)))
+  {
+    byte_reader br(cbuf, sizeof(cbuf));
+    tdog::u32_t idx = br.get_u32();
+    if (idx == CMD_STOP || idx >= group.size()) break;
+
+    basic_test* tc = group[idx];
+
+    {
+      watchdog::guard wg(&wd, tc);
+      tc->run(glimit, gwarn, counters);
+    }
+
+    payload.clear();
+    tc->encode_results(payload);
+
+    frame.clear();
+    byte_writer bw(frame);
+    bw.put_u32(idx);
+    bw.put_u32(static_cast<tdog::u32_t>(payload.size()));
+    frame += payload;
+
+    if (!_write_all(fd, frame)) break;
+  }
+
+  // Any output written directly by tests
+  std::cout.flush();
+  std::fflush(0);
+
+  close(cmd);
+  close(fd);
+  _exit(0);
+}
+//---------------------------------------------------------------------------
+static bool _spawn(std::vector<worker_state>& ws, std::size_t id,
+  const std::vector<basic_test*>& group, tdog::i64_t glimit, tdog::i64_t gwarn,
+  bool counters, bool stacks)
+{
+  // Fork worker, which will wait for commands
+  int rfds[2], cfds[2];
+  if (pipe(rfds) != 0) return false;
+
+  if (pipe(cfds) != 0)
+  {
+    close(rfds[0]);
+    close(rfds[1]);
+    return false;
+  }
+
+  // Don't want buffered output written twice
+  std::cout.flush();
+  std::fflush(0);
+
+  pid_t pid = fork();
+
+  if (pid < 0)
+  {
+    close(rfds[0]);
+    close(rfds[1]);
+    close(cfds[0]);
+    close(cfds[1]);
+    return false;
+  }
+
+  if (pid == 0)
+  {
+    // Close pipes belonging to other workers, otherwise
+    // they will not see end-of-file if the parent dies.
+    for(std::size_t n = 0; n < ws.size(); ++n)
+    {
+      if (ws[n].fd >= 0) close(ws[n].fd);
+      if (ws[n].cmd >= 0) close(ws[n].cmd);
+    }
+
+    close(rfds[0]);
+    close(cfds[1]);
+    _child_main(cfds[0], rfds[1], group, glimit, gwarn, counters, stacks);
+  }
+
+  close(rfds[1]);
+  close(cfds[0]);
+
+  worker_state& w = ws[id];
+  w.pid = pid;
+  w.fd = rfds[0];
+  w.cmd = cfds[1];
+  w.current = NO_ITEM;
+  w.buf.clear();
+  return true;
+}
+//---------------------------------------------------------------------------
+static void _dispatch(worker_state& w, std::size_t id, work_queue& queue)
+{
+  // Send worker its next item, stealing from other
+  // queues if need be, or tell it to stop. If the
+  // worker has gone, we will see it on its result pipe.
+  std::string cmd;
+  byte_writer bw(cmd);
+  std::size_t idx;
+
+  if (queue.take(id, idx))
+  {
+    w.current = idx;
+    w.item_start = msec_time();
+    bw.put_u32(static_cast<tdog::u32_t>(idx));
+  }
+  else
+  {
+    w.current = NO_ITEM;
+    bw.put_u32(CMD_STOP);
+  }
+
+  _write_all(w.cmd, cmd);
+}
+//---------------------------------------------------------------------------
+static void _parse_frames(worker_state& w, std::size_t id, work_queue& queue,
+  const std::vector<basic_test*>& group)
+{
+  // Decode complete results from the buffer,
+  // and give the worker something else to do
+  while(w.buf.size() >= FRAME_HEAD_SZ)
+  {
+    byte_reader br(w.buf.data(), FRAME_HEAD_SZ);
+    std::size_t idx = br.get_u32();
+    std::size_t len = br.get_u32();
+
+    if (w.buf.size() < FRAME_HEAD_SZ + len) break;
+
+    if (idx == w.current)
+    {
+      basic_test* tc = group[idx];
+
+      if (!tc->decode_results(w.buf.data() + FRAME_HEAD_SZ, len))
+      {
+        tc->set_aborted("invalid result data received from test process",
+          "protocol", w.item_start, msec_time() - w.item_start);
+      }
+
+      _dispatch(w, id, queue);
+    }
+
+    w.buf.erase(0, FRAME_HEAD_SZ + len);
+  }
+}
+//---------------------------------------------------------------------------
+static void _reap(worker_state& w, const std::vector<basic_test*>& group)
+{
+  // Worker has closed its pipe. If it was part way
+  // through an item, record it as an error.
+  close(w.fd);
+  close(w.cmd);
+  w.fd = -1;
+  w.cmd = -1;
+
+  int st = 0;
+  while(waitpid(w.pid, &st, 0) < 0 && errno == EINTR) {}
+
+  if (w.current != NO_ITEM)
+  {
+    std::string msg, ename;
+
+    if (WIFEXITED(st) && WEXITSTATUS(st) == watchdog::EXIT_TIMEOUT)
+    {
+      // Hung test stopped by the worker's watchdog
+      group[w.current]->set_aborted("time constraint exceeded, test process "
+        "terminated by watchdog", "", w.item_start, msec_time() - w.item_start,
+        ET_FAIL);
+
+      w.current = NO_ITEM;
+      return;
+    }
+
+    if (WIFSIGNALED(st))
+    {
+      ename = process_pool::signal_name(WTERMSIG(st));
+      msg = "test process terminated by signal " + ename;
+    }
+    else
+    {
+      ename = "exit";
+      msg = "test process exited unexpectedly with status " +
+        int_to_str(WEXITSTATUS(st));
+    }
+
+    group[w.current]->set_aborted(msg, ename, w.item_start,
+      msec_time() - w.item_start);
+
+    w.current = NO_ITEM;
+  }
+}
+#endif // TDOG_WINDOWS
+//---------------------------------------------------------------------------
+// CLASS process_pool : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+process_pool::process_pool(int workers, bool stacks)
+{
+  m_workers = (workers > 1) ? workers : 1;
+  m_stacks = stacks;
+}
+//---------------------------------------------------------------------------
+bool process_pool::supported()
+{
+#if defined(TDOG_WINDOWS)
+  return false;
+#else
+  return true;
+#endif
+}
+//---------------------------------------------------------------------------
+void process_pool::run(const std::vector<basic_test*>& group, tdog::i64_t glimit,
+  tdog::i64_t gwarn, bool counters, const std::vector<tdog::i64_t>& costs)
+{
+  // Run tests in worker processes
+#if defined(TDOG_WINDOWS)
+  (void)costs;
+
+  for(std::size_t n = 0; n < group.size(); ++n)
+  {
+    group[n]->run(glimit, gwarn, counters);
+  }
+#else
+  if (group.empty()) return;
+
+  std::size_t wcnt = static_cast<std::size_t>(m_workers);
+  if (wcnt > group.size()) wcnt = group.size();
+
+  // Items are handed out one at a time, so each
+  // worker's queue is only a preference for where
+  // it starts. Idle workers steal from busy ones.
+  work_queue queue(wcnt);
+  queue.seed(group.size(), costs);
+
+  // Writing to a dead worker must not kill us
+  void (*old_pipe)(int) = signal(SIGPIPE, SIG_IGN);
+
+  std::vector<worker_state> ws(wcnt);
+
+  for(std::size_t n = 0; n < wcnt; ++n)
+  {
+    if (_spawn(ws, n, group, glimit, gwarn, counters, m_stacks))
+    {
+      _dispatch(ws[n], n, queue);
+    }
+  }
+
+  std::vector<pollfd> pfds;
+  std::vector<std::size_t> pmap;
+  char rbuf[4096];
+
+  while(true)
+  {
+    pfds.clear();
+    pmap.clear();
+
+    for(std::size_t n = 0; n < wcnt; ++n)
+    {
+      if (ws[n].fd >= 0)
+      {
+        pollfd p;
+        p.fd = ws[n].fd;
+        p.events = POLLIN;
+        p.revents = 0;
+        pfds.push_back(p);
+        pmap.push_back(n);
+      }
+    }
+
+    if (pfds.empty()) break;
+
+    if (poll(&pfds[0], pfds.size(), -1) < 0)
+    {
+      if (errno == EINTR) continue;
+      break;
+    }
+
+    for(std::size_t k = 0; k < pfds.size(); ++k)
+    {
+      if (pfds[k].revents == 0) continue;
+
+      std::size_t id = pmap[k];
+      worker_state& w = ws[id];
+      ssize_t r = read(w.fd, rbuf, sizeof(rbuf));
+
+      if (r > 0)
+      {
+        w.buf.append(rbuf, static_cast<std::size_t>(r));
+        _parse_frames(w, id, queue, group);
+      }
+      else
+      if (r == 0 || (errno != EINTR && errno != EAGAIN))
+      {
+        bool crashed = (w.current != NO_ITEM);
+        _reap(w, group);
+
+        // Replace worker if there is more to do
+        if (crashed && _spawn(ws, id, group, glimit, gwarn, counters, m_stacks))
+        {
+          _dispatch(w, id, queue);
+        }
+      }
+    }
+  }
+
+  // Anything left where we could not fork
+  _run_inline(0, queue, group, glimit, gwarn, counters);
+
+  signal(SIGPIPE, old_pipe);
+#endif
+}
+//---------------------------------------------------------------------------
+std::string process_pool::signal_name(int sig)
+{
+  // Common signal names
+#if !defined(TDOG_WINDOWS)
+  switch(sig)
+  {
+    case SIGSEGV: return "SIGSEGV";
+    case SIGABRT: return "SIGABRT";
+    case SIGFPE: return "SIGFPE";
+    case SIGILL: return "SIGILL";
+    case SIGBUS: return "SIGBUS";
+    case SIGKILL: return "SIGKILL";
+    case SIGTERM: return "SIGTERM";
+    case SIGINT: return "SIGINT";
+    case SIGPIPE: return "SIGPIPE";
+    case SIGALRM: return "SIGALRM";
+    case SIGTRAP: return "SIGTRAP";
+    case SIGSYS: return "SIGSYS";
+    default: break;
+  }
+#endif
+
+  return "signal " + int_to_str(sig);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : process_pool.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_PROCESS_POOL_H
+#define TDOG_PROCESS_POOL_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Runs test cases in forked worker processes, so that a test which
+// crashes cannot take the runner down with it. The parent hands out
+// tests one at a time from a work_queue, and each worker writes the
+// results of its test back over a pipe when complete. Where a worker
+// dies, the test it was running is recorded as an error, and a new
+// worker is started in its place.
+//
+// Supported under POSIX only. Where supported() is false, run() will
+// execute the tests in the calling process.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+// Forward declarations
+class basic_test;
+
+//---------------------------------------------------------------------------
+// CLASS process_pool
+//---------------------------------------------------------------------------
+class process_pool
+{
+  private:
+
+  int m_workers;
+  bool m_stacks;
+
+  // No copy
+  process_pool(const process_pool&);
+  process_pool& operator=(const process_pool&);
+
+  public:
+
+  // Where stacks is true, workers report a stack
+  // snapshot of a hung test before they exit.
+  process_pool(int workers, bool stacks = true);
+
+  // True if platform supports it
+  static bool supported();
+
+  // Run tests, blocking until all are complete. The costs
+  // vector gives the expected duration of each test, or may
+  // be empty. Longest tests are started first. Where counters
+  // is true, hardware counts are taken in the workers.
+  void run(const std::vector<basic_test*>& group, tdog::i64_t glimit,
+    tdog::i64_t gwarn, bool counters,
+    const std::vector<tdog::i64_t>& costs = std::vector<tdog::i64_t>());
+
+  // Name of signal, i.e. "SIGSEGV"
+  static std::string signal_name(int sig);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : report_mux.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "report_mux.hpp"
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+// Buffer size for report files
+const std::size_t FILE_BUF_SZ = 65536;
+
+//---------------------------------------------------------------------------
+// CLASS report_mux : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+report_mux::report_mux()
+{
+  // Constructor
+}
+//---------------------------------------------------------------------------
+report_mux::~report_mux()
+{
+  // Destructor. Files are closed, and so
+  // flushed, before their buffers are freed.
+  for(std::size_t n = 0; n < m_sinks.size(); ++n)
+  {
+    delete m_sinks[n].reporter;
+    delete m_sinks[n].file;
+    delete m_sinks[n].buf;
+  }
+}
+//---------------------------------------------------------------------------
+void report_mux::add(basic_reporter* reporter, std::ostream& os)
+{
+  // Add reporter on stream
+  sink s;
+  s.reporter = reporter;
+  s.os = &os;
+  s.file = 0;
+  s.buf = 0;
+  m_sinks.push_back(s);
+}
+//---------------------------------------------------------------------------
+bool report_mux::add_file(basic_reporter* reporter, const std::string& filename)
+{
+  // Add reporter on file. The buffer
+  // must be set before the file is opened.
+  sink s;
+  s.reporter = reporter;
+  s.buf = new std::vector<char>(FILE_BUF_SZ);
+  s.file = new std::ofstream;
+  s.file->rdbuf()->pubsetbuf(&(*s.buf)[0], FILE_BUF_SZ);
+  s.file->open(filename.c_str());
+
+  if (!s.file->is_open())
+  {
+    delete s.reporter;
+    delete s.file;
+    delete s.buf;
+    return false;
+  }
+
+  s.os = s.file;
+  m_sinks.push_back(s);
+  return true;
+}
+//---------------------------------------------------------------------------
+std::size_t report_mux::size() const
+{
+  return m_sinks.size();
+}
+//---------------------------------------------------------------------------
+void report_mux::generate(const std::vector<basic_test*>& order)
+{
+  // One pass over the tests, feeding every reporter
+  std::size_t s_sz = m_sinks.size();
+  if (s_sz == 0) return;
+
+  for(std::size_t k = 0; k < s_sz; ++k)
+  {
+    m_sinks[k].reporter->gen_plan(order);
+    m_sinks[k].reporter->gen_start(*m_sinks[k].os);
+  }
+
+  for(std::size_t n = 0; n < order.size(); ++n)
+  {
+    for(std::size_t k = 0; k < s_sz; ++k)
+    {
+      m_sinks[k].reporter->gen_test(*m_sinks[k].os, order[n]);
+    }
+  }
+
+  for(std::size_t k = 0; k < s_sz; ++k)
+  {
+    m_sinks[k].reporter->gen_end(*m_sinks[k].os);
+    m_sinks[k].os->flush();
+  }
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : report_mux.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_REPORT_MUX_H
+#define TDOG_REPORT_MUX_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "basic_reporter.hpp"
+
+#include <string>
+#include <ostream>
+#include <fstream>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Generates any number of reports in a single pass over the test results.
+// Each reporter is paired with its own output stream, and those given by
+// file name are written through their own file buffer.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS report_mux
+//---------------------------------------------------------------------------
+class report_mux
+{
+  private:
+
+  struct sink
+  {
+    basic_reporter* reporter;
+    std::ostream* os;
+    std::ofstream* file;    // <- owned, or null
+    std::vector<char>* buf; // <- file buffer, or null
+  };
+
+  std::vector<sink> m_sinks;
+
+  // No copy
+  report_mux(const report_mux&);
+  report_mux& operator=(const report_mux&);
+
+  public:
+
+  report_mux();
+  ~report_mux();
+
+  // Add reporter writing to the given stream. Takes
+  // ownership of the reporter, but not the stream.
+  void add(basic_reporter* reporter, std::ostream& os);
+
+  // Add reporter writing to the named file. Takes ownership of
+  // the reporter. Returns false if the file cannot be opened,
+  // in which case the reporter is deleted.
+  bool add_file(basic_reporter* reporter, const std::string& filename);
+
+  // Number of reports
+  std::size_t size() const;
+
+  // Write all reports for the tests, given in report order
+  void generate(const std::vector<basic_test*>& order);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
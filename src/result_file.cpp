@@ -0,0 +1,596 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : result_file.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "result_file.hpp"
+#include "tdog/private/basic_test.hpp"
+#include "tdog/private/suite_manager.hpp"
+#include "byte_codec.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+// File identification
+const char* const RESULT_MAGIC = "TDOGRSLT";
+const std::size_t MAGIC_SIZE = 8;
+const tdog::u32_t RESULT_VERSION = 6;
+
+// Magic, version and four section offsets
+const std::size_t HEADER_SIZE = MAGIC_SIZE + 4 + 4 * 4;
+
+// Fixed record sizes
+const std::size_t TEST_REC_SIZE = 4 * 3 + 4 + 1 + 4 * 2 + 1 + 4 * 3 + 8 * 2 + 1 + 4 * 3 +
+  8 * 4 + 8 * 3 + 8 + 4 + 8 * 4;
+const std::size_t EVENT_REC_SIZE = 1 + 4 * 4 + 4;
+
+// Position of status within test record
+const std::size_t TEST_STATUS_POS = 4 * 3 + 4 + 1 + 4 * 2;
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+
+// Test restored from file. Has nothing to run.
+class loaded_test : public basic_test
+{
+  protected:
+
+  virtual void _run_unprotected() {}
+
+  public:
+
+  loaded_test(const std::string& sname, const std::string& tname,
+    test_type_t ttype, const std::string& fname, int lnum,
+    const std::string& utype, const std::string& rtype)
+    : basic_test(sname, tname, ttype, fname, lnum, utype, rtype) {}
+};
+
+// Strings held once, by order of first use
+class string_writer
+{
+  private:
+
+  std::vector<const std::string*> m_order;
+  std::map<std::string, tdog::u32_t> m_index;
+
+  public:
+
+  tdog::u32_t index(const std::string& s)
+  {
+    std::map<std::string, tdog::u32_t>::iterator it = m_index.find(s);
+    if (it != m_index.end()) return it->second;
+
+    tdog::u32_t idx = static_cast<tdog::u32_t>(m_order.size());
+    it = m_index.insert(std::make_pair(s, idx)).first;
+    m_order.push_back(&it->first);
+    return idx;
+  }
+
+  void write(std::string& out) const
+  {
+    // Count, offsets, then strings
+    byte_writer bw(out);
+    bw.put_u32(static_cast<tdog::u32_t>(m_order.size()));
+
+    tdog::u32_t pos = 0;
+
+    for(std::size_t n = 0; n < m_order.size(); ++n)
+    {
+      bw.put_u32(pos);
+      pos += static_cast<tdog::u32_t>(4 + m_order[n]->size());
+    }
+
+    for(std::size_t n = 0; n < m_order.size(); ++n)
+    {
+      bw.put_str(*m_order[n]);
+    }
+  }
+};
+
+// Record chosen for a test when merging
+struct shard_pick
+{
+  std::size_t reader;
+  tdog::u32_t idx;
+  int rank;
+};
+
+//---------------------------------------------------------------------------
+static int _status_rank(status_t s)
+{
+  // Where a test is in more than one shard, that
+  // which got furthest is taken, i.e. a test which
+  // ran in one shard and was not run in the others.
+  switch(s)
+  {
+    case TS_DISABLED: return 1;
+    case TS_SKIPPED: return 2;
+    case TS_PASS_OK:
+    case TS_PASS_WARN:
+    case TS_FAILED:
+    case TS_ERROR: return 3;
+    default: return 0;
+  }
+}
+
+//---------------------------------------------------------------------------
+// CLASS result_reader : PRIVATE MEMBERS
+//---------------------------------------------------------------------------
+std::string result_reader::_str(tdog::u32_t idx)
+{
+  // String from table. Offsets are from
+  // the end of the offset array.
+  if (!m_ok || idx >= m_str_cnt)
+  {
+    m_ok = false;
+    return std::string();
+  }
+
+  std::size_t base = 4 + 4 * static_cast<std::size_t>(m_str_cnt);
+  byte_reader ob(m_strings + 4 + 4 * static_cast<std::size_t>(idx), 4);
+  std::size_t pos = base + ob.get_u32();
+
+  if (pos >= m_str_size)
+  {
+    m_ok = false;
+    return std::string();
+  }
+
+  byte_reader br(m_strings + pos, m_str_size - pos);
+  std::string rslt = br.get_str();
+  m_ok = br.ok();
+  return rslt;
+}
+//---------------------------------------------------------------------------
+// CLASS result_reader : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+result_reader::result_reader()
+{
+  // Constructor
+  m_tests = 0;
+  m_events = 0;
+  m_strings = 0;
+  m_str_size = 0;
+  m_test_cnt = 0;
+  m_event_cnt = 0;
+  m_str_cnt = 0;
+  m_ok = false;
+}
+//---------------------------------------------------------------------------
+bool result_reader::open(const std::string& filename)
+{
+  // Map file and check structure. Records
+  // are not read until they are needed.
+  m_ok = false;
+  m_test_cnt = 0;
+  if (!m_file.open(filename)) return false;
+
+  // Whole file in one window
+  std::size_t size = static_cast<std::size_t>(m_file.size());
+  if (size != m_file.size()) return false;
+
+  const char* data = m_file.view(0, size);
+  if (data == 0) return false;
+
+  if (size < HEADER_SIZE || std::memcmp(data, RESULT_MAGIC, MAGIC_SIZE) != 0)
+  {
+    return false;
+  }
+
+  byte_reader hr(data + MAGIC_SIZE, HEADER_SIZE - MAGIC_SIZE);
+  if (hr.get_u32() != RESULT_VERSION) return false;
+
+  std::size_t info_pos = hr.get_u32();
+  std::size_t test_pos = hr.get_u32();
+  std::size_t event_pos = hr.get_u32();
+  std::size_t str_pos = hr.get_u32();
+
+  if (info_pos > test_pos || test_pos > event_pos || event_pos > str_pos ||
+    str_pos > size) return false;
+
+  byte_reader sr(data + str_pos, size - str_pos);
+  m_str_cnt = sr.get_u32();
+  m_strings = data + str_pos;
+  m_str_size = size - str_pos;
+
+  byte_reader tr(data + test_pos, event_pos - test_pos);
+  m_test_cnt = tr.get_u32();
+  m_tests = data + test_pos + 4;
+
+  byte_reader er(data + event_pos, str_pos - event_pos);
+  m_event_cnt = er.get_u32();
+  m_events = data + event_pos + 4;
+
+  m_ok = sr.ok() && tr.ok() && er.ok() && sr.remain() / 4 >= m_str_cnt &&
+    tr.remain() / TEST_REC_SIZE >= m_test_cnt &&
+    er.remain() / EVENT_REC_SIZE >= m_event_cnt;
+
+  byte_reader ir(data + info_pos, test_pos - info_pos);
+  m_info.platos = _str(ir.get_u32());
+  m_info.project_name = _str(ir.get_u32());
+  m_info.project_version = _str(ir.get_u32());
+  m_info.project_desc = _str(ir.get_u32());
+  m_info.start_time = ir.get_i64();
+  m_info.end_time = ir.get_i64();
+  m_info.sorted = (ir.get_u8() != 0);
+  m_info.hostname = _str(ir.get_u32());
+
+  tdog::u32_t decl_cnt = ir.get_u32();
+  m_info.decl_errors.clear();
+
+  for(tdog::u32_t n = 0; n < decl_cnt && ir.ok(); ++n)
+  {
+    m_info.decl_errors.push_back(_str(ir.get_u32()));
+  }
+
+  m_ok &= ir.ok();
+  if (!m_ok) m_test_cnt = 0;
+
+  return m_ok;
+}
+//---------------------------------------------------------------------------
+const result_info& result_reader::info() const
+{
+  return m_info;
+}
+//---------------------------------------------------------------------------
+tdog::u32_t result_reader::size() const
+{
+  return m_test_cnt;
+}
+//---------------------------------------------------------------------------
+bool result_reader::ok() const
+{
+  return m_ok;
+}
+//---------------------------------------------------------------------------
+std::string result_reader::full_name(tdog::u32_t idx)
+{
+  // Name of test, without creating it
+  if (idx >= m_test_cnt) return std::string();
+
+  byte_reader tr(m_tests + idx * TEST_REC_SIZE, TEST_REC_SIZE);
+  std::string sname = _str(tr.get_u32());
+  std::string tname = _str(tr.get_u32());
+
+  if (sname.empty()) return tname;
+  return sname + NSSEP + tname;
+}
+//---------------------------------------------------------------------------
+status_t result_reader::status(tdog::u32_t idx) const
+{
+  // Status of test, without creating it
+  if (idx >= m_test_cnt) return TS_NOT_EXIST;
+
+  byte_reader tr(m_tests + idx * TEST_REC_SIZE + TEST_STATUS_POS, 1);
+  return static_cast<status_t>(tr.get_u8());
+}
+//---------------------------------------------------------------------------
+basic_test* result_reader::create(tdog::u32_t idx)
+{
+  // New test with its results. The results are rebuilt
+  // in transfer form, i.e. as from run_helper::encode().
+  if (!m_ok || idx >= m_test_cnt) return 0;
+
+  byte_reader tr(m_tests + idx * TEST_REC_SIZE, TEST_REC_SIZE);
+  std::string sname = _str(tr.get_u32());
+  std::string tname = _str(tr.get_u32());
+  std::string fname = _str(tr.get_u32());
+  int lnum = tr.get_i32();
+  test_type_t ttype = static_cast<test_type_t>(tr.get_u8());
+  std::string utype = _str(tr.get_u32());
+  std::string rtype = _str(tr.get_u32());
+
+  std::string blob;
+  byte_writer bw(blob);
+  bw.put_u8(tr.get_u8());             // <- status
+  bw.put_str(_str(tr.get_u32()));     // <- error name
+  bw.put_i32(tr.get_i32());           // <- assert count
+  bw.put_i32(tr.get_i32());           // <- assert fails
+  bw.put_i64(tr.get_i64());           // <- start time
+  bw.put_i64(tr.get_i64());           // <- duration ns
+  bw.put_u8(tr.get_u8());             // <- time warning
+  bw.put_str(_str(tr.get_u32()));     // <- author
+
+  tdog::u32_t ev_first = tr.get_u32();
+  tdog::u32_t ev_cnt = tr.get_u32();
+
+  if (!tr.ok() || ev_first > m_event_cnt || ev_cnt > m_event_cnt - ev_first)
+  {
+    m_ok = false;
+    return 0;
+  }
+
+  bw.put_u32(ev_cnt);
+  byte_reader xr(m_events + ev_first * EVENT_REC_SIZE, ev_cnt * EVENT_REC_SIZE);
+
+  for(tdog::u32_t k = 0; k < ev_cnt; ++k)
+  {
+    bw.put_u8(xr.get_u8());           // <- type
+    bw.put_i32(xr.get_i32());         // <- line number
+    bw.put_i32(xr.get_i32());         // <- repeat
+    bw.put_i32(xr.get_i32());         // <- block
+    bw.put_i32(xr.get_i32());         // <- cycles
+    bw.put_str(_str(xr.get_u32()));   // <- message
+  }
+
+  for(int k = 0; k < 4 + 3; ++k)
+  {
+    bw.put_i64(tr.get_i64());         // <- hardware counts, allocations
+  }
+
+  bw.put_i64(tr.get_i64());           // <- bench batch
+  bw.put_i32(tr.get_i32());           // <- bench samples
+
+  for(int k = 0; k < 4; ++k)
+  {
+    bw.put_i64(tr.get_i64());         // <- bench figures (ps)
+  }
+
+  bw.put_u32(0);                      // <- bench samples, not held
+
+  if (!m_ok || !xr.ok() || !tr.ok()) return 0;
+
+  basic_test* tc = new loaded_test(sname, tname, ttype, fname, lnum, utype, rtype);
+
+  if (!tc->decode_results(blob.data(), blob.size()))
+  {
+    delete tc;
+    m_ok = false;
+    return 0;
+  }
+
+  return tc;
+}
+//---------------------------------------------------------------------------
+// CLASS result_file : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+bool result_file::save(const std::string& filename, const result_info& info,
+  const std::vector<basic_test*>& tests)
+{
+  // Write run to file
+  string_writer sw;
+  std::string info_sec, test_sec, event_sec, str_sec;
+
+  byte_writer iw(info_sec);
+  iw.put_u32(sw.index(info.platos));
+  iw.put_u32(sw.index(info.project_name));
+  iw.put_u32(sw.index(info.project_version));
+  iw.put_u32(sw.index(info.project_desc));
+  iw.put_i64(info.start_time);
+  iw.put_i64(info.end_time);
+  iw.put_u8(info.sorted ? 1 : 0);
+  iw.put_u32(sw.index(info.hostname));
+  iw.put_u32(static_cast<tdog::u32_t>(info.decl_errors.size()));
+
+  for(std::size_t n = 0; n < info.decl_errors.size(); ++n)
+  {
+    iw.put_u32(sw.index(info.decl_errors[n]));
+  }
+
+  byte_writer tw(test_sec);
+  tw.put_u32(static_cast<tdog::u32_t>(tests.size()));
+
+  std::string events;
+  byte_writer ew(events);
+  tdog::u32_t ev_total = 0;
+  std::string blob;
+
+  for(std::size_t n = 0; n < tests.size(); ++n)
+  {
+    const basic_test* tc = tests[n];
+
+    // Results in transfer form. See run_helper::encode().
+    blob.clear();
+    tc->encode_results(blob);
+    byte_reader br(blob.data(), blob.size());
+
+    tw.put_u32(sw.index(tc->suite_name()));
+    tw.put_u32(sw.index(tc->test_name()));
+    tw.put_u32(sw.index(tc->filename()));
+    tw.put_i32(tc->line_num());
+    tw.put_u8(static_cast<tdog::u8_t>(tc->test_type()));
+    tw.put_u32(sw.index(tc->user_typename()));
+    tw.put_u32(sw.index(tc->repeat_typename()));
+
+    tw.put_u8(br.get_u8());             // <- status
+    tw.put_u32(sw.index(br.get_str())); // <- error name
+    tw.put_i32(br.get_i32());           // <- assert count
+    tw.put_i32(br.get_i32());           // <- assert fails
+    tw.put_i64(br.get_i64());           // <- start time
+    tw.put_i64(br.get_i64());           // <- duration ns
+    tw.put_u8(br.get_u8());             // <- time warning
+    tw.put_u32(sw.index(br.get_str())); // <- author
+
+    tdog::u32_t ev_cnt = br.get_u32();
+    tw.put_u32(ev_total);
+    tw.put_u32(ev_cnt);
+
+    for(tdog::u32_t k = 0; k < ev_cnt && br.ok(); ++k)
+    {
+      ew.put_u8(br.get_u8());             // <- type
+      ew.put_i32(br.get_i32());           // <- line number
+      ew.put_i32(br.get_i32());           // <- repeat
+      ew.put_i32(br.get_i32());           // <- block
+      ew.put_i32(br.get_i32());           // <- cycles
+      ew.put_u32(sw.index(br.get_str())); // <- message
+    }
+
+    for(int k = 0; k < 4 + 3; ++k)
+    {
+      tw.put_i64(br.get_i64());         // <- hardware counts, allocations
+    }
+
+    tw.put_i64(br.get_i64());           // <- bench batch
+    tw.put_i32(br.get_i32());           // <- bench samples
+
+    for(int k = 0; k < 4; ++k)
+    {
+      tw.put_i64(br.get_i64());         // <- bench figures (ps)
+    }
+
+    if (!br.ok()) return false;
+    ev_total += ev_cnt;
+  }
+
+  byte_writer(event_sec).put_u32(ev_total);
+  event_sec += events;
+  sw.write(str_sec);
+
+  // Header with section offsets
+  std::string head(RESULT_MAGIC, MAGIC_SIZE);
+  byte_writer hw(head);
+  tdog::u32_t pos = static_cast<tdog::u32_t>(HEADER_SIZE);
+  hw.put_u32(RESULT_VERSION);
+  hw.put_u32(pos);
+  pos += static_cast<tdog::u32_t>(info_sec.size());
+  hw.put_u32(pos);
+  pos += static_cast<tdog::u32_t>(test_sec.size());
+  hw.put_u32(pos);
+  pos += static_cast<tdog::u32_t>(event_sec.size());
+  hw.put_u32(pos);
+
+  std::ofstream fs(filename.c_str(), std::ios::binary | std::ios::trunc);
+  if (!fs.is_open()) return false;
+
+  fs << head << info_sec << test_sec << event_sec << str_sec;
+  fs.close();
+  return !fs.fail();
+}
+//---------------------------------------------------------------------------
+bool result_file::load(const std::string& filename, result_info& info,
+  std::vector<basic_test*>& tests)
+{
+  // Read run from file
+  result_reader rd;
+  if (!rd.open(filename)) return false;
+
+  info = rd.info();
+  std::size_t first = tests.size();
+
+  for(tdog::u32_t n = 0; n < rd.size(); ++n)
+  {
+    basic_test* tc = rd.create(n);
+
+    if (tc == 0)
+    {
+      // Discard partial
+      for(std::size_t k = first; k < tests.size(); ++k) delete tests[k];
+      tests.resize(first);
+      return false;
+    }
+
+    tests.push_back(tc);
+  }
+
+  return true;
+}
+//---------------------------------------------------------------------------
+bool result_file::merge(const std::vector<std::string>& filenames,
+  result_info& info, std::vector<basic_test*>& tests)
+{
+  // Merge shards. Only names and status are read while choosing
+  // which record to take for each test. Tests are then created
+  // from the chosen records, in order of first appearance.
+  std::vector<result_reader*> readers;
+  std::vector<shard_pick> picks;
+  std::map<std::string, std::size_t> index;
+  bool ok = !filenames.empty();
+
+  for(std::size_t r = 0; r < filenames.size() && ok; ++r)
+  {
+    readers.push_back(new result_reader());
+    result_reader& rd = *readers.back();
+    ok = rd.open(filenames[r]);
+
+    if (ok)
+    {
+      // Run spans all shards
+      const result_info& ri = rd.info();
+
+      if (r == 0)
+      {
+        info = ri;
+      }
+      else
+      {
+        if (ri.start_time != 0 && (info.start_time == 0 || ri.start_time < info.start_time))
+        {
+          info.start_time = ri.start_time;
+        }
+
+        if (ri.end_time > info.end_time) info.end_time = ri.end_time;
+
+        // Errors of any shard abort the run
+        for(std::size_t n = 0; n < ri.decl_errors.size(); ++n)
+        {
+          if (std::find(info.decl_errors.begin(), info.decl_errors.end(),
+            ri.decl_errors[n]) == info.decl_errors.end())
+          {
+            info.decl_errors.push_back(ri.decl_errors[n]);
+          }
+        }
+      }
+    }
+
+    for(tdog::u32_t n = 0; n < rd.size() && ok; ++n)
+    {
+      shard_pick p;
+      p.reader = r;
+      p.idx = n;
+      p.rank = _status_rank(rd.status(n));
+
+      std::string name = rd.full_name(n);
+      ok = rd.ok();
+
+      std::map<std::string, std::size_t>::iterator it = index.find(name);
+
+      if (it == index.end())
+      {
+        index.insert(std::make_pair(name, picks.size()));
+        picks.push_back(p);
+      }
+      else
+      if (p.rank >= picks[it->second].rank)
+      {
+        // Later shard wins a tie
+        picks[it->second] = p;
+      }
+    }
+  }
+
+  std::size_t first = tests.size();
+
+  for(std::size_t n = 0; n < picks.size() && ok; ++n)
+  {
+    basic_test* tc = readers[picks[n].reader]->create(picks[n].idx);
+    if (tc != 0) tests.push_back(tc);
+    else ok = false;
+  }
+
+  if (!ok)
+  {
+    // Discard partial
+    for(std::size_t k = first; k < tests.size(); ++k) delete tests[k];
+    tests.resize(first);
+  }
+
+  for(std::size_t r = 0; r < readers.size(); ++r) delete readers[r];
+
+  return ok;
+}
+//---------------------------------------------------------------------------
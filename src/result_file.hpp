@@ -0,0 +1,159 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : result_file.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_RESULT_FILE_H
+#define TDOG_RESULT_FILE_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+#include "tdog/types.hpp"
+#include "file_window.hpp"
+
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Binary file holding the results of a test run, from which reports can
+// be generated later without the test executable. Integers are written
+// little-endian using byte_codec. Every string is held once in a string
+// table, and referred to elsewhere by index. Tests and events are fixed
+// size records, so that a reader can access any of them directly from a
+// memory mapped file.
+//
+//   header  : magic[8], u32 version, u32 info/tests/events/strings offsets
+//   info    : u32 platos/project name/version/desc, i64 start/end, u8 sorted,
+//             u32 hostname, u32 declaration error count, then u32 per error
+//   tests   : u32 count, then a record per test in run order
+//   events  : u32 count, then a record per event item
+//   strings : u32 count, u32 offset per string, then u32 length + bytes
+//
+// A test record holds its declaration, status, assert counts, start time,
+// duration in ns, the index and count of its items in the event table, its
+// hardware counts and allocations, and any benchmark figures, with times
+// held as integer ps. The benchmark
+// samples from which the figures were taken are not held.
+// The test results themselves pass through basic_test::encode_results() and
+// decode_results(), so that the file holds exactly what a worker would.
+//
+// Files written by separate shards of a run may be merged. Each test is
+// taken from the shard in which it got furthest, i.e. ran rather than
+// being left unrun, so that shards may each register every test but run
+// only their share. Only names and status are read from the mapped files
+// until the record for each test is chosen.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+// Forward declarations
+class basic_test;
+
+// Run properties held in the file
+struct result_info
+{
+  std::string platos;
+  std::string project_name;
+  std::string project_version;
+  std::string project_desc;
+  tdog::i64_t start_time;
+  tdog::i64_t end_time;
+  bool sorted;
+  std::string hostname;
+  std::vector<std::string> decl_errors;
+
+  result_info() : start_time(0), end_time(0), sorted(false) {}
+};
+
+//---------------------------------------------------------------------------
+// CLASS result_reader
+//---------------------------------------------------------------------------
+class result_reader
+{
+  private:
+
+  file_window m_file;
+  const char* m_tests;
+  const char* m_events;
+  const char* m_strings;
+  std::size_t m_str_size;
+  tdog::u32_t m_test_cnt;
+  tdog::u32_t m_event_cnt;
+  tdog::u32_t m_str_cnt;
+  bool m_ok;
+  result_info m_info;
+
+  std::string _str(tdog::u32_t idx);
+
+  // No copy
+  result_reader(const result_reader&);
+  result_reader& operator=(const result_reader&);
+
+  public:
+
+  result_reader();
+
+  // Maps file and checks its structure
+  bool open(const std::string& filename);
+
+  // Run properties, and number of tests
+  const result_info& info() const;
+  tdog::u32_t size() const;
+
+  // False if the file is invalid, or any
+  // record read so far has been invalid
+  bool ok() const;
+
+  // Record fields, without creating the test
+  std::string full_name(tdog::u32_t idx);
+  status_t status(tdog::u32_t idx) const;
+
+  // New test with its results, owned by
+  // the caller. Null if record is invalid.
+  basic_test* create(tdog::u32_t idx);
+};
+
+//---------------------------------------------------------------------------
+// CLASS result_file
+//---------------------------------------------------------------------------
+class result_file
+{
+  public:
+
+  // Write tests, in the order given, with their
+  // last results. Returns false on failure.
+  static bool save(const std::string& filename, const result_info& info,
+    const std::vector<basic_test*>& tests);
+
+  // Create tests from file, in the order saved, with
+  // their results. The caller takes ownership. Returns
+  // false if the file cannot be read, or is invalid.
+  static bool load(const std::string& filename, result_info& info,
+    std::vector<basic_test*>& tests);
+
+  // As load(), but merges the results of several
+  // files, written by separate shards of a run.
+  static bool merge(const std::vector<std::string>& filenames,
+    result_info& info, std::vector<basic_test*>& tests);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
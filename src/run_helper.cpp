@@ -11,29 +11,310 @@
 //---------------------------------------------------------------------------
 #include "tdog/private/run_helper.hpp"
 #include "tdog_exception.hpp"
+#include "alloc_tracker.hpp"
+#include "byte_codec.hpp"
+#include "thread_pool.hpp"
 #include "util.hpp"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
 //---------------------------------------------------------------------------
 // NON-CLASS
 //---------------------------------------------------------------------------
 using namespace tdog;
 
-// Use with m_duration
+// Use with m_duration, which is otherwise in ns
 const tdog::i64_t TDUR_NOT_RUN = -2;
 const tdog::i64_t TDUR_RUNNING = -1;
 
+// Time limit sampling. The clock is read on every event
+// unless events arrive more often than TCHECK_NS apart,
+// in which case the stride doubles up to TCHECK_MAX.
+const tdog::i64_t TCHECK_NS = 1000000;
+const int TCHECK_MAX = 256;
+
+// Benchmark timing. The batch size is grown until a batch takes
+// BENCH_SAMPLE_NS, and batches then run until BENCH_WARMUP_NS has
+// passed. Up to BENCH_SAMPLES are then timed, but sampling stops
+// early after BENCH_MAX_NS where a single iteration is slow.
+const tdog::i64_t BENCH_SAMPLE_NS = 1000000;
+const tdog::i64_t BENCH_WARMUP_NS = 20000000;
+const tdog::i64_t BENCH_MAX_NS = 2000000000;
+const tdog::i64_t BENCH_MAX_BATCH = 1000000000;
+const int BENCH_SAMPLES = 100;
+const int BENCH_MIN_SAMPLES = 5;
+
+// Where the compiler has no asm
+const volatile void* volatile bench_sink = 0;
+
+// Results changes held for readers, i.e. statistics
+const std::size_t CHANGE_RING_SIZE = 4096;
+
 //---------------------------------------------------------------------------
-// CLASS run_helper : PRIVATE MEMBERS
+// INTERNAL ROUTINES
 //---------------------------------------------------------------------------
-void run_helper::_print_event(std::string s, event_type_t t, int lnum,
-  const std::string& ename)
+
+// Tests whose results changed, in order. Held in a ring, so that
+// where readers fall too far behind, the oldest are overwritten.
+struct change_ring
 {
-  // Underlying event, such as assert pass, fail or error.
-  // If error, "ename" can supply additional error type string,
-  // otherwise it is ignored. Line number of zero is taken to
-  // mean unknown or N/A.
-  s = trim_str(s);
+  mutex lock;
+  tdog::u64_t seq; // <- no. of changes ever posted
+  std::vector<const run_helper*> items;
+
+  change_ring() : seq(0), items(CHANGE_RING_SIZE, 0) {}
+};
+
+static change_ring& _changes()
+{
+  // Created on first use, i.e. when the first
+  // test is constructed during static initialization
+  static change_ring ring;
+  return ring;
+}
+//---------------------------------------------------------------------------
+static void _post_change(const run_helper* rh)
+{
+  // Add to ring, over the oldest
+  change_ring& cr = _changes();
+  scoped_lock lock(cr.lock);
+  cr.items[cr.seq % CHANGE_RING_SIZE] = rh;
+  ++cr.seq;
+}
+//---------------------------------------------------------------------------
+static double _percentile(const std::vector<double>& sorted, double q)
+{
+  // Linear interpolation between closest ranks.
+  // The vector must be sorted and not empty.
+  double pos = q * static_cast<double>(sorted.size() - 1);
+  std::size_t lo = static_cast<std::size_t>(pos);
+
+  if (lo + 1 >= sorted.size()) return sorted.back();
+
+  return sorted[lo] + (sorted[lo + 1] - sorted[lo]) * (pos - static_cast<double>(lo));
+}
+//---------------------------------------------------------------------------
+static tdog::i64_t _time_batch(bench_batch& body, tdog::i64_t cnt)
+{
+  // Time one batch in ns
+  tdog::i64_t start = nsec_mono();
+  body.run(cnt);
+  return nsec_mono() - start;
+}
+//---------------------------------------------------------------------------
+static tdog::i64_t _to_ps(double ns)
+{
+  // Benchmark figure for transfer
+  return static_cast<tdog::i64_t>(ns * 1000.0 + 0.5);
+}
+//---------------------------------------------------------------------------
+static void _append_int(std::string& out, tdog::u64_t val, unsigned int base,
+  bool upper, std::size_t width, char pad)
+{
+  // Digits of val, padded to width
+  const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+  char buf[24];
+  std::size_t pos = sizeof(buf);
+
+  do
+  {
+    buf[--pos] = digits[val % base];
+    val /= base;
+  } while(val != 0);
+
+  std::size_t len = sizeof(buf) - pos;
+  if (len < width) out.append(width - len, pad);
+  out.append(buf + pos, len);
+}
+//---------------------------------------------------------------------------
+template <class TAGS>
+static void _format(std::string& out, const std::string& fs, TAGS& tags)
+{
+  // Single pass over the format string. Text between tags is
+  // copied whole, "\%" is written as "%", and a "%" which does
+  // not begin a tag of the value type is copied as it is. The
+  // tags object writes the value for a tag, and returns its
+  // length after the "%", or 0 if not recognised.
+  out.clear();
+
+  const char* p = fs.data();
+  const char* end = p + fs.size();
+
+  while(p != end)
+  {
+    const char* q = p;
+    while(q != end && *q != '%' && *q != '\\') ++q;
+
+    out.append(p, q);
+    if (q == end) break;
+
+    if (*q == '\\')
+    {
+      bool esc = (q + 1 != end && q[1] == '%');
+      out += esc ? '%' : '\\';
+      p = q + (esc ? 2 : 1);
+    }
+    else
+    {
+      std::size_t len = tags(out, q + 1, static_cast<std::size_t>(end - q - 1));
+      if (len == 0) out += '%';
+      p = q + 1 + len;
+    }
+  }
+}
+//---------------------------------------------------------------------------
+// Integer tags: %g, %i, %d (signed), %u, %o, %x, %X (unsigned), %c (character),
+// %b (true or false), and %02x, %04x, %08x and %16x (with X variants), of
+// which %16x is padded with spaces and the others with zeros.
+class int_tags
+{
+  private:
+
+  tdog::i64_t m_val;
+
+  public:
+
+  int_tags(tdog::i64_t val) : m_val(val) {}
+
+  std::size_t operator()(std::string& out, const char* p, std::size_t avail)
+  {
+    if (avail == 0) return 0;
+
+    tdog::u64_t u = static_cast<tdog::u64_t>(m_val);
+
+    switch(p[0])
+    {
+      case 'g':
+      case 'i':
+      case 'd':
+        if (m_val < 0)
+        {
+          out += '-';
+          u = 0 - u;
+        }
+        _append_int(out, u, 10, false, 0, ' ');
+        return 1;
+      case 'u':
+        _append_int(out, u, 10, false, 0, ' ');
+        return 1;
+      case 'o':
+        _append_int(out, u, 8, false, 0, ' ');
+        return 1;
+      case 'x':
+      case 'X':
+        _append_int(out, u, 16, (p[0] == 'X'), 0, ' ');
+        return 1;
+      case 'c':
+        out += static_cast<char>(m_val);
+        return 1;
+      case 'b':
+        out += (m_val != 0) ? "true" : "false";
+        return 1;
+      case '0':
+      case '1':
+        if (avail >= 3 && (p[2] == 'x' || p[2] == 'X'))
+        {
+          bool zero = (p[0] == '0');
+          if ((zero && (p[1] == '2' || p[1] == '4' || p[1] == '8')) || (!zero && p[1] == '6'))
+          {
+            std::size_t width = zero ? static_cast<std::size_t>(p[1] - '0') : 16;
+            _append_int(out, u, 16, (p[2] == 'X'), width, zero ? '0' : ' ');
+            return 3;
+          }
+        }
+        return 0;
+      default:
+        return 0;
+    }
+  }
+};
+//---------------------------------------------------------------------------
+// Double tags: %g and %f, both written as "%f"
+class double_tags
+{
+  private:
+
+  double m_val;
+  std::string m_str;
+
+  public:
+
+  double_tags(double val) : m_val(val) {}
+
+  std::size_t operator()(std::string& out, const char* p, std::size_t avail)
+  {
+    if (avail == 0 || (p[0] != 'g' && p[0] != 'f')) return 0;
+
+    if (m_str.empty()) m_str = double_to_str(m_val);
+    out += m_str;
+    return 1;
+  }
+};
+//---------------------------------------------------------------------------
+// String tags: %g and %s, and %k (with escapes)
+class str_tags
+{
+  private:
+
+  const std::string& m_val;
+  std::string m_esc;
+  bool m_has_esc;
+
+  public:
+
+  str_tags(const std::string& val) : m_val(val), m_has_esc(false) {}
 
+  std::size_t operator()(std::string& out, const char* p, std::size_t avail)
+  {
+    if (avail == 0) return 0;
+
+    if (p[0] == 'g' || p[0] == 's')
+    {
+      out += m_val;
+      return 1;
+    }
+
+    if (p[0] == 'k')
+    {
+      if (!m_has_esc) m_esc = encode_esc(m_val);
+      m_has_esc = true;
+      out += m_esc;
+      return 1;
+    }
+
+    return 0;
+  }
+};
+//---------------------------------------------------------------------------
+void tdog::bench_escape(const volatile void* ptr)
+{
+  // Used by do_not_optimize()
+  bench_sink = ptr;
+}
+
+//---------------------------------------------------------------------------
+// CLASS run_helper : PRIVATE MEMBERS
+//---------------------------------------------------------------------------
+void run_helper::_changed()
+{
+  // Post change for readers. Not while running, as readers
+  // must re-read running tests anyway, and events are many.
+  if (m_duration != TDUR_RUNNING) _post_change(this);
+}
+//---------------------------------------------------------------------------
+void run_helper::_limit_changed()
+{
+  // Tell watcher of limit in force
+  if (m_watcher != 0) m_watcher->limit_changed(m_watch_key, limit_in_force());
+}
+//---------------------------------------------------------------------------
+void run_helper::_update_status(event_type_t t, const std::string& ename)
+{
+  // Update test status according to event type.
+  // If error, "ename" can supply additional error type
+  // string, otherwise it is ignored.
   if (t == ET_ERROR)
   {
     m_status = TS_ERROR;
@@ -54,13 +335,32 @@ void run_helper::_print_event(std::string s, event_type_t t, int lnum,
     }
   }
 
-  if (!s.empty() || (t != ET_INFO && t != ET_PASS))
+  _changed();
+}
+//---------------------------------------------------------------------------
+void run_helper::_print_event(std::string s, event_type_t t, int lnum,
+  const std::string& ename)
+{
+  // Underlying event, such as assert pass, fail or error.
+  // Line number of zero is taken to mean unknown or N/A.
+  s = trim_str(s);
+  _update_status(t, ename);
+
+  bool quiet = (t == ET_INFO || t == ET_PASS);
+
+  if (t == ET_PASS && !s.empty() && !m_bench_quiet)
+  {
+    // Repeats counted
+    _log_pass(pass_key(lnum, 0, s));
+  }
+  else
+  if ((!s.empty() && !(quiet && m_bench_quiet)) || !quiet)
   {
     // Output to event log
-    m_event_log.push_back( event_item(s, t, lnum) );
+    _log_item( event_item(s, t, lnum) );
   }
 
-  if (has_passed() && check_time_limit(lnum))
+  if (has_passed() && _sample_time_limit(lnum))
   {
     // Time limit expired
     if (!m_continue_on_fail)
@@ -71,94 +371,237 @@ void run_helper::_print_event(std::string s, event_type_t t, int lnum,
   }
 }
 //---------------------------------------------------------------------------
-void run_helper::_printf_int(const std::string& s, tdog::i64_t val, int lnum)
+void run_helper::_print_event(static_str s, event_type_t t, int lnum)
 {
-  // Writes an integer integer value to the log.
+  // As above, but for static text from assert macros. The
+  // text is held by pointer, and is never empty or untrimmed.
+  _update_status(t, std::string());
 
-  if (m_itag_vect.size() == 0)
+  if (t != ET_PASS)
   {
-    // Mappings to sprintf()
-    // Only have to do this once
-    m_itag_vect.push_back(itag("%g", "%lld"));
-    m_itag_vect.push_back(itag("%i", "%lld"));
-    m_itag_vect.push_back(itag("%d", "%lld"));
-    m_itag_vect.push_back(itag("%u", "%llu"));
-    m_itag_vect.push_back(itag("%c", "%c"));
-    m_itag_vect.push_back(itag("%o", "%llo"));
-    m_itag_vect.push_back(itag("%x", "%llx"));
-    m_itag_vect.push_back(itag("%02x", "%02llx"));
-    m_itag_vect.push_back(itag("%04x", "%04llx"));
-    m_itag_vect.push_back(itag("%08x", "%08llx"));
-    m_itag_vect.push_back(itag("%16x", "%16llx"));
-    m_itag_vect.push_back(itag("%X", "%llX"));
-    m_itag_vect.push_back(itag("%02X", "%02llX"));
-    m_itag_vect.push_back(itag("%04X", "%04llX"));
-    m_itag_vect.push_back(itag("%08X", "%08llX"));
-    m_itag_vect.push_back(itag("%16X", "%16llX"));
+    _log_item( event_item(s, t, lnum) );
+  }
+  else
+  if (!m_bench_quiet)
+  {
+    // Not benchmark iteration after the first
+    _log_pass(pass_key(lnum, s.ptr));
   }
 
-  // Remove literal temporarily
-  std::string fs = str_replace(s, "\\%", "$#&");
+  if (has_passed() && _sample_time_limit(lnum))
+  {
+    // Time limit expired
+    if (!m_continue_on_fail)
+    {
+      // Break out
+      throw tdog_exception();
+    }
+  }
+}
+//---------------------------------------------------------------------------
+bool run_helper::pass_key::matches(const event_item& e) const
+{
+  // True if e is a pass with same line and text
+  return e.item_type == ET_PASS && e.line_num == line && e.msg_lit == lit &&
+    (lit != 0 || e.msg_str == str);
+}
+//---------------------------------------------------------------------------
+void run_helper::_log_pass(const pass_key& k)
+{
+  // Count pass against the next item of a repeating block,
+  // or the last item where the same. Otherwise, the passes
+  // at the tail may now form a block, or it is a new item.
+  if (m_cycle_start != std::string::npos && _cycle_pass(k)) return;
 
-  // Enumerate through array
-  for(std::size_t n = 0; n < m_itag_vect.size(); ++n)
+  if (m_event_log.size() > m_pass_floor)
   {
-    // Translate if required
-    fs = str_replace(fs, m_itag_vect[n].tag, int_to_str(val, m_itag_vect[n].spec));
+    event_item& last = m_event_log.back();
+
+    if (k.matches(last) && last.repeat < INT_MAX)
+    {
+      ++last.repeat;
+      return;
+    }
   }
 
-  // Special "boolean" tag
-  if (val != 0) fs = str_replace(fs, "%b", "true");
-  else fs = str_replace(fs, "%b", "false");
+  if (_find_cycle() && _cycle_pass(k)) return;
 
-  // Put back literal
-  fs = str_replace(fs, "$#&", "%");
+  if (k.lit != 0) m_event_log.push_back( event_item(static_str(k.lit), ET_PASS, k.line) );
+  else m_event_log.push_back( event_item(k.str, ET_PASS, k.line) );
+}
+//---------------------------------------------------------------------------
+void run_helper::_log_item(const event_item& e)
+{
+  // Passes which follow are not counted with those before
+  _end_cycle();
+  m_event_log.push_back(e);
+  m_pass_floor = m_event_log.size();
+}
+//---------------------------------------------------------------------------
+bool run_helper::_find_cycle()
+{
+  // Where the last 2 x len items are the same block twice, remove
+  // the second and count 2 cycles of the first. Items are compared
+  // with their repeat counts, so these must be complete.
+  const std::size_t MAX_BLOCK = 16;
+  std::size_t sz = m_event_log.size();
 
-  // Output to event log
-  print(fs, lnum);
+  for(std::size_t len = 2; len <= MAX_BLOCK && m_pass_floor + 2 * len <= sz; ++len)
+  {
+    std::size_t a = sz - 2 * len;
+    bool same = true;
+
+    for(std::size_t n = 0; n < len && same; ++n)
+    {
+      const event_item& x = m_event_log[a + n];
+      const event_item& y = m_event_log[a + len + n];
+
+      same = (x.item_type == ET_PASS && y.item_type == ET_PASS &&
+        x.line_num == y.line_num && x.repeat == y.repeat &&
+        x.msg_lit == y.msg_lit && (x.msg_lit != 0 || x.msg_str == y.msg_str));
+    }
+
+    if (same)
+    {
+      m_event_log.resize(sz - len);
+      m_event_log[a].block = static_cast<int>(len);
+      m_event_log[a].cycles = 2;
+      m_cycle_start = a;
+      m_cycle_pos = 0;
+      m_cycle_cnt = 0;
+      return true;
+    }
+  }
+
+  return false;
 }
 //---------------------------------------------------------------------------
-void run_helper::_printf_double(const std::string& s, double val, int lnum)
+bool run_helper::_cycle_pass(const pass_key& k)
 {
-  // Remove literal temporarily
-  std::string fs = str_replace(s, "\\%", "$#&");
+  // Count pass as the next of the repeating block, and
+  // the block once more when its cycle is complete. False,
+  // and the block ended, where the pass is not the next.
+  event_item& e = m_event_log[m_cycle_start + m_cycle_pos];
 
-  // Replace general
-  fs = str_replace(fs, "%g", "%f");
+  if (!k.matches(e))
+  {
+    _end_cycle();
+    return false;
+  }
 
-  // Replace
-  fs = str_replace(fs, "%f", double_to_str(val));
+  if (++m_cycle_cnt == e.repeat)
+  {
+    m_cycle_cnt = 0;
 
-  // Put back literal
-  fs = str_replace(fs, "$#&", "%");
+    if (++m_cycle_pos == m_event_log.size() - m_cycle_start)
+    {
+      event_item& first = m_event_log[m_cycle_start];
+      m_cycle_pos = 0;
 
-  // Output to event log
-  print(fs, lnum);
+      if (++first.cycles == INT_MAX)
+      {
+        m_cycle_start = std::string::npos;
+        m_pass_floor = m_event_log.size();
+      }
+    }
+  }
+
+  return true;
 }
 //---------------------------------------------------------------------------
-void run_helper::_printf_str(const std::string& s, const std::string& val, int lnum)
+void run_helper::_end_cycle()
 {
-  // Push value string onto the log vector
-  // Remove literal temporarily
-  std::string fs = str_replace(s, "\\%", "$#&");
+  // End repeating block, writing passes matched so far of its
+  // incomplete cycle. A block seen only twice is written out
+  // again, so that passes before it may still form a longer one.
+  if (m_cycle_start == std::string::npos) return;
 
-  // Replace general
-  fs = str_replace(fs, "%g", "%s");
+  std::size_t a = m_cycle_start;
+  std::size_t len = m_event_log.size() - a;
+  std::size_t pos = m_cycle_pos;
+  int cnt = m_cycle_cnt;
 
-  // Replace strings
-  fs = str_replace(fs, "%s", val);
+  m_cycle_start = std::string::npos;
+  m_cycle_pos = 0;
+  m_cycle_cnt = 0;
 
-  if (fs.find("%k") != std::string::npos)
+  if (m_event_log[a].cycles > 2)
   {
-    // Replace
-    fs = str_replace(fs, "%k", encode_esc(val));
+    m_pass_floor = m_event_log.size();
   }
+  else
+  {
+    m_event_log[a].block = 0;
+    m_event_log[a].cycles = 1;
 
-  // Put back literal
-  fs = str_replace(fs, "$#&", "%");
+    for(std::size_t n = 0; n < len; ++n)
+    {
+      event_item e = m_event_log[a + n];
+      m_event_log.push_back(e);
+    }
+  }
+
+  for(std::size_t n = 0; n <= pos; ++n)
+  {
+    event_item e = m_event_log[a + n];
+    e.block = 0;
+    e.cycles = 1;
 
-  // Output to event log
-  print(fs, lnum);
+    if (n == pos) e.repeat = cnt;
+    if (e.repeat > 0) m_event_log.push_back(e);
+  }
+}
+//---------------------------------------------------------------------------
+bool run_helper::_sample_time_limit(int lnum)
+{
+  // Calls check_time_limit(), but where events are close
+  // together, only every m_check_stride events. A tight loop
+  // of asserts therefore reads the clock around once per ms.
+  if (m_time_limit <= 0 && m_global_limit <= 0 && m_warning_limit <= 0)
+  {
+    return false;
+  }
+
+  if (++m_check_count < m_check_stride) return false;
+  m_check_count = 0;
+
+  tdog::i64_t now = nsec_mono();
+
+  if (now - m_check_last < TCHECK_NS)
+  {
+    if (m_check_stride < TCHECK_MAX) m_check_stride *= 2;
+  }
+  else
+  {
+    m_check_stride = 1;
+  }
+
+  m_check_last = now;
+  return check_time_limit(lnum);
+}
+//---------------------------------------------------------------------------
+void run_helper::_printf_int(const std::string& s, tdog::i64_t val, int lnum)
+{
+  // Writes an integer value to the log
+  int_tags tags(val);
+  _format(m_fmt_buf, s, tags);
+  print(m_fmt_buf, lnum);
+}
+//---------------------------------------------------------------------------
+void run_helper::_printf_double(const std::string& s, double val, int lnum)
+{
+  // Writes a double value to the log
+  double_tags tags(val);
+  _format(m_fmt_buf, s, tags);
+  print(m_fmt_buf, lnum);
+}
+//---------------------------------------------------------------------------
+void run_helper::_printf_str(const std::string& s, const std::string& val, int lnum)
+{
+  // Writes a string value to the log
+  str_tags tags(val);
+  _format(m_fmt_buf, s, tags);
+  print(m_fmt_buf, lnum);
 }
 //---------------------------------------------------------------------------
 void run_helper::_printf_str(const std::string& s, const std::wstring& val, int lnum)
@@ -183,24 +626,135 @@ void run_helper::_printf_ptr(const std::string& s, const void* val, int lnum)
   }
 }
 //---------------------------------------------------------------------------
-bool run_helper::_assert_impl(bool condition, bool eq, const std::string& s, int lnum)
+bool run_helper::_assert_impl(bool condition, bool eq, const assert_msg& s, int lnum)
 {
-  // Internal assert
+  // Internal assert. A pass with static text is logged
+  // by pointer. Otherwise, the message string is built.
   ++m_assert_cnt; // <- increment
 
   if (condition == eq)
   {
-    _print_event(s, ET_PASS, lnum);
+    if (s.literal() != 0) _print_event(static_str(s.literal()), ET_PASS, lnum);
+    else _print_event(s.str(), ET_PASS, lnum);
   }
   else
   {
     ++m_assert_fails;
-    _print_event(s, ET_FAIL, lnum);
+    _print_event(s.str(), ET_FAIL, lnum);
   }
 
   return (condition == eq);
 }
 //---------------------------------------------------------------------------
+void run_helper::_print_mismatch(std::size_t idx, const void* exp,
+  const void* act, std::size_t esize, std::size_t cnt)
+{
+  // Index of first difference. Where elements were compared
+  // as memory, a window of bytes around the first differing
+  // byte is shown from both, with that byte in brackets.
+  this->printf("-index = %g", static_cast<tdog::u64_t>(idx), 0);
+
+  if (esize == 0 || exp == 0 || act == 0 || idx >= cnt) return;
+
+  const std::size_t WIN = 16;
+  const char* HEX = "0123456789abcdef";
+  const unsigned char* pe = static_cast<const unsigned char*>(exp);
+  const unsigned char* pa = static_cast<const unsigned char*>(act);
+
+  std::size_t total = cnt * esize;
+  std::size_t pos = idx * esize;
+  while(pos + 1 < total && pe[pos] == pa[pos]) ++pos;
+
+  std::size_t start = (pos / WIN) * WIN;
+  if (start >= WIN) start -= WIN;
+  std::size_t end = std::min(start + 2 * WIN, total);
+
+  this->printf("-offset = %g", static_cast<tdog::u64_t>(pos), 0);
+
+  for(int k = 0; k < 2; ++k)
+  {
+    const unsigned char* p = (k == 0) ? pe : pa;
+    std::string line = (k == 0) ? "-exp @" : "-act @";
+    line += int_to_str(static_cast<tdog::xint_t>(start)) + ":";
+
+    for(std::size_t n = start; n < end; ++n)
+    {
+      line += (n == pos) ? '[' : ' ';
+      line += HEX[p[n] >> 4];
+      line += HEX[p[n] & 0x0F];
+      if (n == pos) line += ']';
+    }
+
+    _print_event(line, ET_INFO, 0);
+  }
+}
+//---------------------------------------------------------------------------
+void run_helper::_assert_close(bool valid, const float_diff& d, double exp,
+  double act, tol_t mode, double tol, const char* fmt, const assert_msg& s, int lnum)
+{
+  // One assert for the whole array. On failure, the worst
+  // element is given with the largest errors over all.
+  if (valid && _assert_impl( (d.mismatches == 0), true, s, lnum )) return;
+
+  if (!valid)
+  {
+    _assert_impl(false, true, s, lnum);
+    _printf_str("-error: invalid null pointer", "", 0);
+  }
+  else
+  {
+    this->printf("-mismatches = %g", static_cast<tdog::u64_t>(d.mismatches), 0);
+    this->printf("-index = %g", static_cast<tdog::u64_t>(d.worst), 0);
+    _print_event("-exp = " + double_to_str(exp, fmt), ET_INFO, 0);
+    _print_event("-act = " + double_to_str(act, fmt), ET_INFO, 0);
+    _print_event("-max abs = " + double_to_str(d.max_abs, "%g"), ET_INFO, 0);
+    _print_event("-max rel = " + double_to_str(d.max_rel, "%g"), ET_INFO, 0);
+
+    if (mode == TOL_ULP)
+    {
+      // Maximum is given where either is NaN
+      if (d.max_ulp == ~static_cast<tdog::u64_t>(0)) _printf_str("-max ulp = NaN", "", 0);
+      else this->printf("-max ulp = %u", d.max_ulp, 0);
+    }
+
+    _print_event("-tol = " + double_to_str(tol, "%g"), ET_INFO, 0);
+  }
+
+  if (!m_continue_on_fail)
+  {
+    throw tdog_exception();
+  }
+}
+//---------------------------------------------------------------------------
+void run_helper::_assert_file(const file_diff& d, const assert_msg& s, int lnum)
+{
+  // Location of first difference, and sizes where they differ
+  if (d.error.empty() && _assert_impl( (d.offset < 0), true, s, lnum )) return;
+
+  if (!d.error.empty())
+  {
+    _assert_impl(false, true, s, lnum);
+    this->printf("-error: %s", d.error, 0);
+  }
+  else
+  {
+    this->printf("-offset = %g", d.offset, 0);
+    this->printf("-line = %g", d.line, 0);
+    this->printf("-column = %g", d.column, 0);
+
+    if (d.exp_size != d.act_size)
+    {
+      this->printf("-exp size = %g", d.exp_size, 0);
+      this->printf("-act size = %g", d.act_size, 0);
+    }
+  }
+
+  if (!m_continue_on_fail)
+  {
+    throw tdog_exception();
+  }
+}
+//---------------------------------------------------------------------------
 template <typename T>
 bool run_helper::_ascii_compic(const T& s1, const T& s2) const
 {
@@ -224,11 +778,25 @@ bool run_helper::_ascii_compic(const T& s1, const T& s2) const
   return rslt;
 }
 //---------------------------------------------------------------------------
+bool run_helper::_bench_continue()
+{
+  // Between benchmark batches. False on failure, including
+  // a time limit, which the body may not otherwise check.
+  return !has_failed() && !check_time_limit(0);
+}
+//---------------------------------------------------------------------------
 // CLASS run_helper : PUBLIC MEMBERS
 //---------------------------------------------------------------------------
 run_helper::run_helper()
 {
   m_status = TS_READY;
+  m_duration = TDUR_NOT_RUN;
+  m_watcher = 0;
+  m_watch_key = 0;
+  m_pass_floor = 0;
+  m_cycle_start = std::string::npos;
+  m_cycle_pos = 0;
+  m_cycle_cnt = 0;
   clear();
 }
 //---------------------------------------------------------------------------
@@ -246,16 +814,30 @@ void run_helper::clear()
     m_assert_cnt = 0;
     m_assert_fails = 0;
     m_start_time = 0;
+    m_start_mono = 0;
     m_duration = TDUR_NOT_RUN;
+    m_check_last = 0;
+    m_check_stride = 1;
+    m_check_count = 0;
     m_time_warn_flag = false;
     m_continue_on_fail = false;
+    m_bench_quiet = false;
     m_time_limit = 0;
     m_global_limit = 0;
     m_warning_limit = 0;
     m_author.clear();
+    m_bench = bench_result();
+    m_counts = hw_counts();
+    m_allocs = alloc_counts();
     m_error_name.clear();
     m_event_log.clear();
+    m_pass_floor = 0;
+    m_cycle_start = std::string::npos;
+    m_cycle_pos = 0;
+    m_cycle_cnt = 0;
   }
+
+  _changed();
 }
 //---------------------------------------------------------------------------
 bool run_helper::start_test(tdog::i64_t glimit, tdog::i64_t gwarn)
@@ -270,7 +852,12 @@ bool run_helper::start_test(tdog::i64_t glimit, tdog::i64_t gwarn)
     m_warning_limit = gwarn;
     m_duration = TDUR_RUNNING;
     m_start_time = msec_time();
+    m_start_mono = nsec_mono();
+    m_check_last = m_start_mono;
 
+    // Readers now see it running
+    _post_change(this);
+    _limit_changed();
     return true;
   }
 
@@ -279,11 +866,17 @@ bool run_helper::start_test(tdog::i64_t glimit, tdog::i64_t gwarn)
 //---------------------------------------------------------------------------
 void run_helper::stop_test()
 {
+  m_bench_quiet = false;
+
   if (m_duration == TDUR_RUNNING)
   {
-    m_duration = msec_time() - m_start_time;
+    m_duration = nsec_mono() - m_start_mono;
     check_time_limit(0);
   }
+
+  // Passes of an unfinished cycle
+  _end_cycle();
+  _changed();
 }
 //---------------------------------------------------------------------------
 status_t run_helper::status() const
@@ -319,12 +912,30 @@ tdog::i64_t run_helper::start_time() const
 tdog::i64_t run_helper::duration() const
 {
   // Test duration in ms
+  return duration_ns() / 1000000;
+}
+//---------------------------------------------------------------------------
+tdog::i64_t run_helper::duration_ns() const
+{
+  // Test duration in ns, from the monotonic clock
   if (m_duration == TDUR_NOT_RUN) return 0;
-  if (m_duration == TDUR_RUNNING) return msec_time() - m_start_time;
+  if (m_duration == TDUR_RUNNING) return nsec_mono() - m_start_mono;
 
   return m_duration;
 }
 //---------------------------------------------------------------------------
+tdog::i64_t run_helper::limit_in_force() const
+{
+  // The time limit (ms) which will next fail the
+  // test, or 0 if none. Given to the watcher.
+  if (m_time_limit > 0 && (m_global_limit <= 0 || m_time_limit < m_global_limit))
+  {
+    return m_time_limit;
+  }
+
+  return (m_global_limit > 0) ? m_global_limit : 0;
+}
+//---------------------------------------------------------------------------
 bool run_helper::has_ran() const
 {
   // True if test ran, excluding skipped.
@@ -348,17 +959,225 @@ bool run_helper::has_passed() const
   return (m_status == TS_PASS_OK || m_status == TS_PASS_WARN);
 }
 //---------------------------------------------------------------------------
+bool run_helper::running() const
+{
+  // True between start_test() and stop_test()
+  return m_duration == TDUR_RUNNING;
+}
+//---------------------------------------------------------------------------
+bool run_helper::changed_since(tdog::u64_t& seq,
+  std::vector<const run_helper*>& out)
+{
+  // Static. Changes after seq, oldest first.
+  change_ring& cr = _changes();
+  scoped_lock lock(cr.lock);
+
+  bool rslt = (cr.seq - seq <= CHANGE_RING_SIZE);
+
+  for(; rslt && seq < cr.seq; ++seq)
+  {
+    out.push_back(cr.items[seq % CHANGE_RING_SIZE]);
+  }
+
+  seq = cr.seq;
+  return rslt;
+}
+//---------------------------------------------------------------------------
 std::string run_helper::author() const
 {
   return m_author;
 }
 //---------------------------------------------------------------------------
+const bench_result& run_helper::bench() const
+{
+  // Benchmark figures, if any
+  return m_bench;
+}
+//---------------------------------------------------------------------------
+const hw_counts& run_helper::counts() const
+{
+  // Hardware counts, if any
+  return m_counts;
+}
+//---------------------------------------------------------------------------
+const alloc_counts& run_helper::allocs() const
+{
+  // Heap allocations, if counted
+  return m_allocs;
+}
+//---------------------------------------------------------------------------
 const event_vector& run_helper::event_log() const
 {
   // Access to test log
   return m_event_log;
 }
 //---------------------------------------------------------------------------
+void run_helper::encode(std::string& out) const
+{
+  // Append results in binary form
+  byte_writer bw(out);
+  bw.put_u8(static_cast<tdog::u8_t>(m_status));
+  bw.put_str(m_error_name);
+  bw.put_i32(m_assert_cnt);
+  bw.put_i32(m_assert_fails);
+  bw.put_i64(m_start_time);
+  bw.put_i64(m_duration);
+  bw.put_u8(m_time_warn_flag ? 1 : 0);
+  bw.put_str(m_author);
+
+  bw.put_u32(static_cast<tdog::u32_t>(m_event_log.size()));
+
+  for(std::size_t n = 0; n < m_event_log.size(); ++n)
+  {
+    bw.put_u8(static_cast<tdog::u8_t>(m_event_log[n].item_type));
+    bw.put_i32(m_event_log[n].line_num);
+    bw.put_i32(m_event_log[n].repeat);
+    bw.put_i32(m_event_log[n].block);
+    bw.put_i32(m_event_log[n].cycles);
+    bw.put_str(m_event_log[n].msg());
+  }
+
+  // Hardware counts
+  bw.put_i64(m_counts.cycles);
+  bw.put_i64(m_counts.instructions);
+  bw.put_i64(m_counts.cache_misses);
+  bw.put_i64(m_counts.branch_misses);
+
+  // Heap allocations
+  bw.put_i64(m_allocs.count);
+  bw.put_i64(m_allocs.bytes);
+  bw.put_i64(m_allocs.peak_bytes);
+
+  // Benchmark figures, ns held as ps
+  bw.put_i64(m_bench.batch);
+  bw.put_i32(m_bench.samples);
+  bw.put_i64(_to_ps(m_bench.median_ns));
+  bw.put_i64(_to_ps(m_bench.p90_ns));
+  bw.put_i64(_to_ps(m_bench.p99_ns));
+  bw.put_i64(_to_ps(m_bench.mad_ns));
+  bw.put_u32(static_cast<tdog::u32_t>(m_bench.sample_ns.size()));
+
+  for(std::size_t n = 0; n < m_bench.sample_ns.size(); ++n)
+  {
+    bw.put_i64(_to_ps(m_bench.sample_ns[n]));
+  }
+}
+//---------------------------------------------------------------------------
+bool run_helper::decode(const char* data, std::size_t size)
+{
+  // Restore results written by encode(). Returns
+  // false if the data is invalid, in which case
+  // the results are left cleared.
+  byte_reader br(data, size);
+
+  clear();
+  m_status = static_cast<status_t>(br.get_u8());
+  m_error_name = br.get_str();
+  m_assert_cnt = br.get_i32();
+  m_assert_fails = br.get_i32();
+  m_start_time = br.get_i64();
+  m_duration = br.get_i64();
+  m_time_warn_flag = (br.get_u8() != 0);
+  m_author = br.get_str();
+
+  tdog::u32_t cnt = br.get_u32();
+
+  for(tdog::u32_t n = 0; n < cnt && br.ok(); ++n)
+  {
+    event_type_t t = static_cast<event_type_t>(br.get_u8());
+    int lnum = br.get_i32();
+    int rep = br.get_i32();
+    int blk = br.get_i32();
+    int cyc = br.get_i32();
+    m_event_log.push_back( event_item(br.get_str(), t, lnum, (rep > 0) ? rep : 1) );
+
+    if (blk > 1 && cyc > 1 && static_cast<tdog::u32_t>(blk) <= cnt - n)
+    {
+      m_event_log.back().block = blk;
+      m_event_log.back().cycles = cyc;
+    }
+  }
+
+  m_counts.cycles = br.get_i64();
+  m_counts.instructions = br.get_i64();
+  m_counts.cache_misses = br.get_i64();
+  m_counts.branch_misses = br.get_i64();
+
+  m_allocs.count = br.get_i64();
+  m_allocs.bytes = br.get_i64();
+  m_allocs.peak_bytes = br.get_i64();
+
+  m_bench.batch = br.get_i64();
+  m_bench.samples = br.get_i32();
+  m_bench.median_ns = br.get_i64() / 1000.0;
+  m_bench.p90_ns = br.get_i64() / 1000.0;
+  m_bench.p99_ns = br.get_i64() / 1000.0;
+  m_bench.mad_ns = br.get_i64() / 1000.0;
+
+  tdog::u32_t scnt = br.get_u32();
+
+  for(tdog::u32_t n = 0; n < scnt && br.ok(); ++n)
+  {
+    m_bench.sample_ns.push_back(br.get_i64() / 1000.0);
+  }
+
+  if (!br.ok())
+  {
+    m_status = TS_READY;
+    clear();
+    return false;
+  }
+
+  _changed();
+  return true;
+}
+//---------------------------------------------------------------------------
+void run_helper::set_aborted(const std::string& s, const std::string& ename,
+  tdog::i64_t start, tdog::i64_t dur, event_type_t t)
+{
+  // Record error where the test did not complete normally,
+  // i.e. the process running it was terminated. Where t is
+  // ET_FAIL, it is recorded as a failure instead.
+  m_status = TS_READY;
+  clear();
+
+  m_status = (t == ET_FAIL) ? TS_FAILED : TS_ERROR;
+  if (t != ET_FAIL) m_error_name = ename;
+  m_start_time = start;
+  m_duration = (dur > 0) ? dur * 1000000 : 0;
+  _log_item( event_item(s, (t == ET_FAIL) ? ET_FAIL : ET_ERROR, 0) );
+  _changed();
+}
+//---------------------------------------------------------------------------
+void run_helper::post_event(const std::string& s, event_type_t t)
+{
+  // As _print_event(), but without time limit
+  // checks, as the test is no longer running.
+  _update_status(t, std::string());
+  _log_item( event_item(trim_str(s), t, 0) );
+}
+//---------------------------------------------------------------------------
+void run_helper::set_counts(const hw_counts& c)
+{
+  // Set by basic_test after the run
+  m_counts = c;
+  _changed();
+}
+//---------------------------------------------------------------------------
+void run_helper::set_allocs(const alloc_counts& a)
+{
+  // Set by basic_test after the run
+  m_allocs = a;
+  _changed();
+}
+//---------------------------------------------------------------------------
+void run_helper::set_watcher(limit_watcher* w, std::size_t key)
+{
+  // Set by watchdog around the run
+  m_watcher = w;
+  m_watch_key = key;
+}
+//---------------------------------------------------------------------------
 void run_helper::set_author(const std::string& a)
 {
   // Set by test case
@@ -377,7 +1196,13 @@ void run_helper::set_skipped()
     m_assert_fails = 0;
     m_error_name.clear();
     m_event_log.clear();
+    m_pass_floor = 0;
+    m_cycle_start = std::string::npos;
+    m_cycle_pos = 0;
+    m_cycle_cnt = 0;
   }
+
+  _changed();
 }
 //---------------------------------------------------------------------------
 bool run_helper::set_enabled(bool flag)
@@ -387,12 +1212,14 @@ bool run_helper::set_enabled(bool flag)
   {
     clear();
     m_status = TS_DISABLED;
+    _changed();
     return true;
   }
   else
   if (flag && m_status == TS_DISABLED)
   {
     m_status = TS_READY;
+    _changed();
     return true;
   }
 
@@ -402,11 +1229,13 @@ bool run_helper::set_enabled(bool flag)
 void run_helper::set_time_limit(tdog::i64_t ms)
 {
   m_time_limit = ms;
+  _limit_changed();
 }
 //---------------------------------------------------------------------------
 void run_helper::set_global_limit_exempt()
 {
   m_global_limit = 0;
+  _limit_changed();
 }
 //---------------------------------------------------------------------------
 void run_helper::set_continue_on_fail(bool flag)
@@ -421,6 +1250,69 @@ void run_helper::sleep(int ms)
   msleep(ms);
 }
 //---------------------------------------------------------------------------
+void run_helper::run_benchmark(bench_batch& body)
+{
+  // The first iteration logs as normal. Passes
+  // and prints are not logged thereafter, so that
+  // the log does not grow with the iteration count.
+  m_bench = bench_result();
+
+  tdog::i64_t start = nsec_mono();
+  tdog::i64_t cnt = 1;
+  tdog::i64_t t = _time_batch(body, cnt);
+  m_bench_quiet = true;
+
+  // Calibrate, aiming a little over the sample time
+  while(t < BENCH_SAMPLE_NS && cnt < BENCH_MAX_BATCH && _bench_continue())
+  {
+    tdog::i64_t next = cnt * 100;
+    if (t > 0) next = std::min(next, cnt * BENCH_SAMPLE_NS * 6 / (t * 5));
+    cnt = std::min(std::max(next, cnt + 1), BENCH_MAX_BATCH);
+    t = _time_batch(body, cnt);
+  }
+
+  // Warmup
+  while(nsec_mono() - start < BENCH_WARMUP_NS && _bench_continue())
+  {
+    body.run(cnt);
+  }
+
+  // Samples, per iteration
+  std::vector<double> samp;
+  samp.reserve(BENCH_SAMPLES);
+  start = nsec_mono();
+
+  while(static_cast<int>(samp.size()) < BENCH_SAMPLES && _bench_continue())
+  {
+    samp.push_back( static_cast<double>(_time_batch(body, cnt)) / cnt );
+
+    if (static_cast<int>(samp.size()) >= BENCH_MIN_SAMPLES &&
+      nsec_mono() - start > BENCH_MAX_NS) break;
+  }
+
+  m_bench_quiet = false;
+
+  if (!has_failed() && !samp.empty())
+  {
+    std::sort(samp.begin(), samp.end());
+
+    m_bench.sample_ns = samp;
+    m_bench.batch = cnt;
+    m_bench.samples = static_cast<int>(samp.size());
+    m_bench.median_ns = _percentile(samp, 0.5);
+    m_bench.p90_ns = _percentile(samp, 0.9);
+    m_bench.p99_ns = _percentile(samp, 0.99);
+
+    for(std::size_t n = 0; n < samp.size(); ++n)
+    {
+      samp[n] = std::fabs(samp[n] - m_bench.median_ns);
+    }
+
+    std::sort(samp.begin(), samp.end());
+    m_bench.mad_ns = _percentile(samp, 0.5);
+  }
+}
+//---------------------------------------------------------------------------
 bool run_helper::check_time_limit(int lnum)
 {
   // Check time exceeded, return true if so.
@@ -567,7 +1459,7 @@ void run_helper::printf(const std::string& s, std::wstring val, int lnum)
   _printf_str(s, val, lnum);
 }
 //---------------------------------------------------------------------------
-void run_helper::assert_true(bool condition, bool eq, const std::string& s, int lnum)
+void run_helper::assert_true(bool condition, bool eq, const assert_msg& s, int lnum)
 {
   if ( !_assert_impl(condition, eq, s, lnum) )
   {
@@ -582,7 +1474,7 @@ void run_helper::assert_true(bool condition, bool eq, const std::string& s, int
 }
 //---------------------------------------------------------------------------
 void run_helper::assert_double_equal(const double& exp, const double& act,
-  bool eq, const double& delta, const std::string& s, int lnum)
+  bool eq, const double& delta, const assert_msg& s, int lnum)
 {
   if ( !_assert_impl( ((act >= (exp - delta)) && (act <= (exp + delta))), eq, s, lnum ) )
   {
@@ -598,8 +1490,32 @@ void run_helper::assert_double_equal(const double& exp, const double& act,
   }
 }
 //---------------------------------------------------------------------------
+void run_helper::assert_array_close(const double* exp, const double* act,
+  std::size_t cnt, tol_t mode, double tol, const assert_msg& s, int lnum)
+{
+  bool valid = (cnt == 0 || (exp != 0 && act != 0));
+  float_diff d;
+
+  if (valid) d = float_compare(exp, act, cnt, mode, tol);
+
+  _assert_close(valid, d, d.mismatches ? exp[d.worst] : 0,
+    d.mismatches ? act[d.worst] : 0, mode, tol, "%.17g", s, lnum);
+}
+//---------------------------------------------------------------------------
+void run_helper::assert_array_close(const float* exp, const float* act,
+  std::size_t cnt, tol_t mode, double tol, const assert_msg& s, int lnum)
+{
+  bool valid = (cnt == 0 || (exp != 0 && act != 0));
+  float_diff d;
+
+  if (valid) d = float_compare(exp, act, cnt, mode, tol);
+
+  _assert_close(valid, d, d.mismatches ? exp[d.worst] : 0,
+    d.mismatches ? act[d.worst] : 0, mode, tol, "%.9g", s, lnum);
+}
+//---------------------------------------------------------------------------
 void run_helper::assert_stric_equal(const std::string& exp, const std::string& act,
-  bool eq, const std::string& s, int lnum)
+  bool eq, const assert_msg& s, int lnum)
 {
   if ( !_assert_impl( _ascii_compic(exp, act), eq, s, lnum ) )
   {
@@ -615,7 +1531,7 @@ void run_helper::assert_stric_equal(const std::string& exp, const std::string& a
 }
 //---------------------------------------------------------------------------
 void run_helper::assert_stric_equal(const std::wstring& exp, const std::wstring& act,
-  bool eq, const std::string& s, int lnum)
+  bool eq, const assert_msg& s, int lnum)
 {
   if ( !_assert_impl( _ascii_compic(exp, act), eq, s, lnum ) )
   {
@@ -631,3 +1547,62 @@ void run_helper::assert_stric_equal(const std::wstring& exp, const std::wstring&
   }
 }
 //---------------------------------------------------------------------------
+void run_helper::assert_file_equal(const std::string& exp_file,
+  const std::string& act_file, const assert_msg& s, int lnum)
+{
+  _assert_file(file_compare(exp_file, act_file), s, lnum);
+}
+//---------------------------------------------------------------------------
+void run_helper::assert_file_equal(const std::string& exp_file,
+  const void* act, std::size_t size, const assert_msg& s, int lnum)
+{
+  if (act == 0 && size != 0)
+  {
+    _assert_impl(false, true, s, lnum);
+    _printf_str("-error: invalid null pointer", "", 0);
+    if (!m_continue_on_fail) throw tdog_exception();
+  }
+  else
+  {
+    _assert_file(file_compare(exp_file, act, size), s, lnum);
+  }
+}
+//---------------------------------------------------------------------------
+alloc_counts run_helper::alloc_mark() const
+{
+  // Running counts of calling thread
+  return alloc_tracker::current();
+}
+//---------------------------------------------------------------------------
+void run_helper::assert_alloc(const alloc_counts& mark, tdog::i64_t max_cnt,
+  tdog::i64_t max_bytes, const assert_msg& s, int lnum)
+{
+  // Where allocations are not tracked, there
+  // is nothing to assert. Warn, so that the
+  // assert is not taken to have passed.
+  alloc_counts now = alloc_tracker::current();
+
+  if (!mark.valid() || !now.valid())
+  {
+    raise_warning("allocations not tracked (requires TDOG_ALLOC_TRACKING build)", lnum);
+    return;
+  }
+
+  tdog::i64_t cnt = now.count - mark.count;
+  tdog::i64_t bytes = now.bytes - mark.bytes;
+
+  if ( !_assert_impl( (max_cnt < 0 || cnt <= max_cnt) &&
+    (max_bytes < 0 || bytes <= max_bytes), true, s, lnum ) )
+  {
+    this->printf("-allocs = %g", cnt, 0);
+    this->printf("-bytes = %g", bytes, 0);
+
+    if (max_bytes >= 0) this->printf("-lim = %g", max_bytes, 0);
+
+    if (!m_continue_on_fail)
+    {
+      throw tdog_exception();
+    }
+  }
+}
+//---------------------------------------------------------------------------
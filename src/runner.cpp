@@ -12,16 +12,29 @@
 #include "tdog/runner.hpp"
 #include "tdog/private/basic_test.hpp"
 #include "tdog/private/suite_manager.hpp"
+#include "tdog/private/shared_fixture.hpp"
 #include "basic_reporter.hpp"
 #include "null_reporter.hpp"
 #include "text_reporter.hpp"
 #include "html_reporter.hpp"
 #include "xml_reporter.hpp"
+#include "report_mux.hpp"
+#include "async_reporter.hpp"
+#include "result_file.hpp"
+#include "stat_index.hpp"
 #include "test_list.hpp"
+#include "name_matcher.hpp"
+#include "thread_pool.hpp"
+#include "process_pool.hpp"
+#include "duration_history.hpp"
+#include "bench_baseline.hpp"
+#include "watchdog.hpp"
 #include "util.hpp"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
-#include <fstream>
+#include <map>
 #include <stdexcept>
 
 //---------------------------------------------------------------------------
@@ -31,6 +44,224 @@ using namespace tdog;
 
 const char* IMMUTABLE_ERROR = "Cannot modify own runner within tests cases";
 
+// Runs a group of tests on a thread pool
+class group_task : public pool_task
+{
+  private:
+
+  const std::vector<basic_test*>& m_group;
+  tdog::i64_t m_glimit;
+  tdog::i64_t m_gwarn;
+  bool m_counters;
+  watchdog* m_wd;
+
+  public:
+
+  group_task(const std::vector<basic_test*>& group, tdog::i64_t glimit,
+    tdog::i64_t gwarn, bool counters, watchdog* wd) : m_group(group),
+    m_glimit(glimit), m_gwarn(gwarn), m_counters(counters), m_wd(wd) {}
+
+  virtual void run(std::size_t idx)
+  {
+    // Test run() will not throw
+    watchdog::guard wg(m_wd, m_group[idx]);
+    m_group[idx]->run(m_glimit, m_gwarn, m_counters);
+  }
+};
+
+// Shared fixtures of a run. Each is set up before the first group
+// of tests which uses it, and torn down after the last, outside of
+// test timing. Times are posted to the log of the first and last
+// tests which use it. Setup is not retried where it fails.
+class shared_set
+{
+  private:
+
+  struct pending_event
+  {
+    basic_test* tc;
+    std::string msg;
+    event_type_t type;
+  };
+
+  std::vector<basic_shared*> m_tried;
+  std::vector<pending_event> m_pending;
+  std::map<basic_shared*, std::size_t> m_last;
+
+  // No copy
+  shared_set(const shared_set&);
+  shared_set& operator=(const shared_set&);
+
+  bool _tried(basic_shared* sh) const
+  {
+    return std::find(m_tried.begin(), m_tried.end(), sh) != m_tried.end();
+  }
+
+  static std::string _call(basic_shared* sh, bool create, tdog::i64_t& ns)
+  {
+    // Create or destroy, returning error string on failure
+    std::string rslt;
+    ns = nsec_mono();
+
+    try
+    {
+      if (create && !sh->create()) rslt = "setup() returned false";
+      if (!create) sh->destroy();
+    }
+    catch(const std::exception& e)
+    {
+      rslt = "unhandled std::exception ('" + std::string(e.what()) + "') thrown";
+    }
+    catch(...)
+    {
+      rslt = "unhandled exception thrown";
+    }
+
+    ns = nsec_mono() - ns;
+    return rslt;
+  }
+
+  public:
+
+  shared_set() {}
+
+  ~shared_set()
+  {
+    // Leftovers, where the run was aborted
+    for(std::size_t n = 0; n < m_tried.size(); ++n)
+    {
+      tdog::i64_t ns;
+      _call(m_tried[n], false, ns);
+    }
+  }
+
+  void plan(const std::vector<basic_test*>& tlist,
+    const std::vector<std::size_t>& plan)
+  {
+    // Record index in plan of last test to use each fixture
+    m_last.clear();
+
+    for(std::size_t k = 0; k < plan.size(); ++k)
+    {
+      basic_shared* sh = tlist[plan[k]]->shared();
+      if (sh != 0) m_last[sh] = k;
+    }
+  }
+
+  void setup(const std::vector<basic_test*>& group)
+  {
+    // Set up fixtures first used by tests in group which will run.
+    // Events are held, as the test log is cleared when it runs.
+    for(std::size_t k = 0; k < group.size(); ++k)
+    {
+      basic_shared* sh = group[k]->shared();
+      status_t st = group[k]->helper().status();
+
+      if (sh != 0 && st != TS_DISABLED && st != TS_SKIPPED && !_tried(sh))
+      {
+        tdog::i64_t ns;
+        std::string err = _call(sh, true, ns);
+        m_tried.push_back(sh);
+
+        pending_event pe;
+        pe.tc = group[k];
+        pe.type = err.empty() ? ET_INFO : ET_ERROR;
+        pe.msg = "shared fixture " + sh->name();
+
+        if (err.empty()) pe.msg += " setup in " + double_to_str(ns / 1.0e6, "%.3f") + " ms";
+        else pe.msg += " setup failed: " + err;
+
+        m_pending.push_back(pe);
+      }
+    }
+  }
+
+  void teardown(const std::vector<basic_test*>& group, std::size_t next)
+  {
+    // Post setup events, then tear down fixtures used by
+    // group, but by no test in plan from index next
+    for(std::size_t n = 0; n < m_pending.size(); ++n)
+    {
+      m_pending[n].tc->post_event(m_pending[n].msg, m_pending[n].type);
+    }
+
+    m_pending.clear();
+
+    for(std::size_t k = group.size(); k > 0; --k)
+    {
+      basic_shared* sh = group[k - 1]->shared();
+      if (sh == 0 || !sh->ready()) continue;
+
+      std::map<basic_shared*, std::size_t>::const_iterator it = m_last.find(sh);
+
+      if (it == m_last.end() || it->second < next)
+      {
+        // Posted to last in group to use it
+        tdog::i64_t ns;
+        std::string err = _call(sh, false, ns);
+        std::string msg = "shared fixture " + sh->name();
+
+        if (err.empty())
+        {
+          msg += " teardown in " + double_to_str(ns / 1.0e6, "%.3f") + " ms";
+          group[k - 1]->post_event(msg, ET_INFO);
+        }
+        else
+        {
+          group[k - 1]->post_event(msg + " teardown failed: " + err, ET_ERROR);
+        }
+      }
+    }
+  }
+};
+
+namespace tdog {
+
+// Ends the run when a test in this process hangs. Called on the
+// watchdog thread, while the run thread waits on the current group.
+class hang_exit : public hang_handler
+{
+  private:
+
+  runner& m_runner;
+  basic_reporter* m_reporter;
+  bool m_deferred;
+  const std::vector<basic_test*>& m_group;
+
+  // No copy
+  hang_exit(const hang_exit&);
+  hang_exit& operator=(const hang_exit&);
+
+  public:
+
+  hang_exit(runner& r, basic_reporter* reporter, bool deferred,
+    const std::vector<basic_test*>& group) : m_runner(r),
+    m_reporter(reporter), m_deferred(deferred), m_group(group) {}
+
+  virtual void hung(basic_test* tc, tdog::i64_t elapsed)
+  {
+    // Record as failed, and write reports for results so far.
+    // Others in the group still running are left as they are.
+    tc->set_aborted("time constraint exceeded, run ended by watchdog", "",
+      tc->helper().start_time(), elapsed, ET_FAIL);
+
+    for(std::size_t n = 0; n < m_group.size(); ++n)
+    {
+      if (!m_group[n]->helper().running())
+      {
+        m_runner.m_stats_ptr->update(m_group[n]);
+        m_reporter->gen_test(std::cout, m_group[n]);
+      }
+    }
+
+    m_runner._end_reports(m_reporter, m_deferred);
+
+    std::cout.flush();
+  }
+};
+
+} // namespace
+
 //---------------------------------------------------------------------------
 // CLASS runner : PRIVATE MEMBERS
 //---------------------------------------------------------------------------
@@ -102,18 +333,112 @@ basic_reporter* runner::_create_reporter(report_style_t style) const
   }
 }
 //---------------------------------------------------------------------------
+void runner::_run_group(const std::vector<basic_test*>& group,
+  const std::vector<tdog::i64_t>& costs, watchdog* wd)
+{
+  // Run group of tests. These will be executed
+  // concurrently if there is more than one and
+  // parallelism is enabled. Costs give expected
+  // durations, and may be empty. Tests run in this
+  // process are watched by wd, and workers have their own.
+  if (m_isolated && !group[0]->is_setup() && !group[0]->is_teardown())
+  {
+    process_pool pool(m_parallelism, m_watchdog_stacks);
+    pool.run(group, m_global_time_limit, m_global_time_warn, m_hw_counters,
+      costs);
+  }
+  else
+  if (group.size() > 1 && m_parallelism > 1)
+  {
+    group_task task(group, m_global_time_limit, m_global_time_warn,
+      m_hw_counters, wd);
+    thread_pool pool(m_parallelism);
+    pool.run(task, group.size(), costs);
+  }
+  else
+  {
+    for(std::size_t n = 0; n < group.size(); ++n)
+    {
+      watchdog::guard wg(wd, group[n]);
+      group[n]->run(m_global_time_limit, m_global_time_warn, m_hw_counters);
+    }
+  }
+}
+//---------------------------------------------------------------------------
+void runner::_end_reports(basic_reporter* reporter, bool deferred)
+{
+  // Mark end time, and write report footer
+  m_end_time = msec_time();
+  reporter->gen_end(std::cout);
+
+  // Generate deferred and additional
+  // reports in a single pass.
+  report_mux mux;
+  if (deferred) mux.add(_create_reporter(m_report_style), std::cout);
+
+  for(std::size_t n = 0; n < m_reports_out.size(); ++n)
+  {
+    mux.add_file(_create_reporter(m_reports_out[n].style),
+      m_reports_out[n].fileout);
+  }
+
+  mux.generate(m_list_ptr->ordered(m_sorted));
+}
+//---------------------------------------------------------------------------
+bool runner::_check_baseline(bench_baseline& base, basic_test* tc) const
+{
+  // Compare benchmark which passed with its baseline, posting a
+  // failure or warning on a slowdown. Where there is no baseline,
+  // or it is to be updated, the samples are recorded instead.
+  // Returns true if the baseline changed.
+  const bench_result& b = tc->helper().bench();
+
+  if (!tc->helper().has_passed() || b.sample_ns.empty()) return false;
+
+  const std::vector<double>* prev = base.get(tc->full_name());
+
+  if (prev == 0 || m_baseline_update)
+  {
+    base.set(tc->full_name(), b.sample_ns);
+    return true;
+  }
+
+  bench_baseline::verdict v = bench_baseline::compare(*prev, b.sample_ns);
+
+  if (v.type != ET_PASS)
+  {
+    std::string s = (v.type == ET_FAIL) ? "benchmark regression" :
+      "possible benchmark regression";
+    s += ": median " + double_to_str(v.shift * 100, "%+.1f") + "% on baseline";
+    s += " (z = " + double_to_str(v.z, "%.2f") + ")";
+    tc->post_event(s, v.type);
+  }
+
+  return false;
+}
+//---------------------------------------------------------------------------
 // CLASS runner : PROTECTED MEMBERS
 //---------------------------------------------------------------------------
 template <typename T>
 bool runner::_run_parse(int argc, const T* argv[],
-  std::string& run_out, std::string& dis_out) const
+  std::string& run_out, std::string& dis_out, int* jobs_out, bool* iso_out,
+  std::string* hist_out, std::string* base_out) const
 {
   // Parse, and provide out as std::string.
-  // Returns true if should run.
+  // Returns true if should run. The jobs
+  // value is -1 if not given.
   run_out.clear();
   dis_out.clear();
   bool run_flag = false;
   bool dis_flag = false;
+  bool jobs_flag = false;
+  bool hist_flag = false;
+  bool base_flag = false;
+
+  if (jobs_out != 0) *jobs_out = -1;
+  if (iso_out != 0) *iso_out = false;
+  if (hist_out != 0) hist_out->clear();
+  if (base_out != 0) base_out->clear();
 
   for(int n = 0; n < argc; ++n)
   {
@@ -142,6 +467,65 @@ bool runner::_run_parse(int argc, const T* argv[],
         continue;
       }
       else
+      if (arg == "--tisolate" || arg == "/tisolate")
+      {
+        if (iso_out != 0) *iso_out = true;
+        run_flag = false;
+        dis_flag = false;
+        continue;
+      }
+      else
+      if (arg == "--tjobs" || arg == "/tjobs" || arg == "/tjobs:")
+      {
+        jobs_flag = true;
+        run_flag = false;
+        dis_flag = false;
+        continue;
+      }
+      else
+      if (arg == "--thistory" || arg == "/thistory" || arg == "/thistory:")
+      {
+        hist_flag = true;
+        run_flag = false;
+        dis_flag = false;
+        continue;
+      }
+      else
+      if (arg == "--tbaseline" || arg == "/tbaseline" || arg == "/tbaseline:")
+      {
+        base_flag = true;
+        run_flag = false;
+        dis_flag = false;
+        continue;
+      }
+      else
+      if (arg.substr(0, 10) == "/thistory:")
+      {
+        // Special case
+        hist_flag = true;
+        run_flag = false;
+        dis_flag = false;
+        arg.erase(0, 10);
+      }
+      else
+      if (arg.substr(0, 11) == "/tbaseline:")
+      {
+        // Special case
+        base_flag = true;
+        run_flag = false;
+        dis_flag = false;
+        arg.erase(0, 11);
+      }
+      else
+      if (arg.substr(0, 7) == "/tjobs:")
+      {
+        // Special case
+        jobs_flag = true;
+        run_flag = false;
+        dis_flag = false;
+        arg.erase(0, 7);
+      }
+      else
       if (arg.substr(0, 6) == "/trun:")
       {
         // Special case - no coninue
@@ -158,6 +542,42 @@ bool runner::_run_parse(int argc, const T* argv[],
         arg.erase(0, 6);
       }
 
+      if (hist_flag)
+      {
+        // Single filename only
+        hist_flag = false;
+
+        if (!arg.empty())
+        {
+          if (hist_out != 0) *hist_out = arg;
+          continue;
+        }
+      }
+
+      if (base_flag)
+      {
+        // Single filename only
+        base_flag = false;
+
+        if (!arg.empty())
+        {
+          if (base_out != 0) *base_out = arg;
+          continue;
+        }
+      }
+
+      if (jobs_flag)
+      {
+        // Single numeric value only
+        jobs_flag = false;
+
+        if (!arg.empty() && arg.find_first_not_of("0123456789") == std::string::npos)
+        {
+          if (jobs_out != 0) *jobs_out = std::atoi(arg.c_str());
+          continue;
+        }
+      }
+
       if (!arg.empty())
       {
         if (arg.substr(0, 1) == "-" || arg.substr(0, 1) == "/")
@@ -216,6 +636,43 @@ bool runner::_run_parse(int argc, const T* argv[],
   return false;
 }
 //---------------------------------------------------------------------------
+void runner::_adopt_results(const result_info& info,
+  const std::vector<basic_test*>& tests)
+{
+  // Replace tests with those loaded from
+  // file. The list takes ownership.
+  m_list_ptr->clear();
+  m_has_suites = false;
+  m_decl_errors = info.decl_errors;
+  m_decl_flag = !m_decl_errors.empty();
+
+  int run_cnt = 0;
+  int fail_cnt = 0;
+
+  for(std::size_t n = 0; n < tests.size(); ++n)
+  {
+    m_list_ptr->adopt(tests[n]);
+    m_has_suites |= !tests[n]->suite_name().empty();
+
+    if (tests[n]->helper().has_ran()) ++run_cnt;
+    if (tests[n]->helper().has_failed()) ++fail_cnt;
+  }
+
+  m_platos = info.platos;
+  m_project_name = info.project_name;
+  m_project_version = info.project_version;
+  m_project_desc = info.project_desc;
+  m_start_time = info.start_time;
+  m_end_time = info.end_time;
+  m_sorted = info.sorted;
+  m_hostname = info.hostname;
+  m_loaded = true;
+  m_stats_ptr->rebuild(*m_list_ptr);
+
+  if (run_cnt == 0) m_run_rslt = RAN_NONE;
+  else m_run_rslt = fail_cnt;
+}
+//---------------------------------------------------------------------------
 // CLASS runner : PUBLIC MEMBERS
 //---------------------------------------------------------------------------
 runner::runner(const std::string& platos)
@@ -223,6 +680,7 @@ runner::runner(const std::string& platos)
   // Default
   m_immutable = false;
   m_list_ptr = new test_list();
+  m_stats_ptr = new stat_index();
 
   clear(true);
 
@@ -243,6 +701,7 @@ runner::runner(report_style_t def_style, const std::string& platos)
   // Default
   m_immutable = false;
   m_list_ptr = new test_list();
+  m_stats_ptr = new stat_index();
 
   clear(true);
   m_report_style = def_style;
@@ -261,6 +720,7 @@ runner::runner(report_style_t def_style, const std::string& platos)
 //---------------------------------------------------------------------------
 runner::~runner()
 {
+  delete m_stats_ptr;
   delete m_list_ptr;
 }
 //---------------------------------------------------------------------------
@@ -315,6 +775,9 @@ void runner::clear(bool all)
   m_start_time = 0;
   m_end_time = 0;
   m_run_rslt = RAN_NONE;
+  m_loaded = false;
+  m_hostname.clear();
+  m_stats_ptr->invalidate();
 
   if (all)
   {
@@ -330,10 +793,19 @@ void runner::clear(bool all)
     m_html_stylesheet.clear();
     m_text_report_break_width = 65;
     m_report_style = RS_TEXT_SUMMARY;
+    m_async_report = false;
     m_sorted = false;
     m_reports_out.clear();
     m_global_time_limit = 0;
     m_global_time_warn = 0;
+    m_parallelism = 1;
+    m_isolated = false;
+    m_history_file.clear();
+    m_baseline_file.clear();
+    m_baseline_update = false;
+    m_hw_counters = false;
+    m_watchdog_stacks = true;
+    m_watchdog_exit = true;
   }
   else
   {
@@ -391,6 +863,7 @@ bool runner::register_test(basic_test* tc)
   if (rslt)
   {
     m_list_ptr->add(tc);
+    m_stats_ptr->invalidate();
 
     // Unlikely TC may have been disabled by another runner,
     // but happens in self-test. Make sure it is initially enabled.
@@ -413,8 +886,9 @@ std::vector<std::string> runner::declaration_errors(bool lf) const
   // Start time will be non-zero if either the test
   // is running, or has been run. This means the test
   // registration phase has finished, and we can check
-  // matching suite open/closure statements.
-  if (m_start_time > 0)
+  // matching suite open/closure statements. Results
+  // loaded from file hold those of their own run.
+  if (m_start_time > 0 && !m_loaded)
   {
     if (suite_manager::counter() > 0)
     {
@@ -463,21 +937,18 @@ int runner::set_enabled(const std::string& names, bool flag)
   if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
 
   int rslt = 0;
-  std::vector<std::string> list = _split_names(names);
+  name_matcher filter(_split_names(names));
 
-  std::size_t l_sz = list.size();
   std::size_t t_sz = m_list_ptr->size();
 
   for(std::size_t t = 0; t < t_sz; ++t)
   {
     basic_test* tc = m_list_ptr->get(t);
 
-    for(std::size_t l = 0; l < l_sz; ++l)
+    if (filter.matches(tc) && tc->set_enabled(flag))
     {
-      if (tc->name_equals(list[l], false))
-      {
-        if (tc->set_enabled(flag)) ++rslt;
-      }
+      m_stats_ptr->update(tc);
+      ++rslt;
     }
   }
 
@@ -490,13 +961,12 @@ std::vector<std::string>& runner::enumerate_test_names(
   // Enumerates the names of all test cases registered in the runner.
   rslt_out.clear();
 
-  // Sort
-  test_list temp = *m_list_ptr;
-  temp.sort(m_sorted);
+  // Sorted
+  const std::vector<basic_test*>& order = m_list_ptr->ordered(m_sorted);
 
-  for(std::size_t n = 0; n < temp.size(); ++n)
+  for(std::size_t n = 0; n < order.size(); ++n)
   {
-    rslt_out.push_back(temp.get(n)->full_name());
+    rslt_out.push_back(order[n]->full_name());
   }
 
   return rslt_out;
@@ -508,14 +978,12 @@ std::vector<std::string>& runner::enumerate_suite_names(
   // Enumerates the names of all test suites registered in the runner.
   rslt_out.clear();
 
-  // Sort
-  std::string s;
-  test_list temp = *m_list_ptr;
-  temp.sort(m_sorted);
+  // Sorted
+  const std::vector<basic_test*>& order = m_list_ptr->ordered(m_sorted);
 
-  for(std::size_t n = 0; n < temp.size(); ++n)
+  for(std::size_t n = 0; n < order.size(); ++n)
   {
-    s = temp.get(n)->suite_name();
+    const std::string& s = order[n]->suite_name();
 
     if (!_exists(s, rslt_out))
     {
@@ -561,53 +1029,133 @@ int runner::run(const std::string& names, bool throw_declerr)
   int fail_cnt = 0;
   std::vector<std::string> name_list = _split_names(names);
 
-  // Create reporter
+  // Create reporter. One which needs all results is
+  // written at the end, as if by generate_report().
   basic_reporter* reporter = _create_reporter(m_report_style);
+  bool deferred = reporter->needs_results();
 
-  // Zero results
+  if (deferred)
+  {
+    delete reporter;
+    reporter = _create_reporter(RS_NONE);
+  }
+  else
+  if (m_async_report)
+  {
+    // Format and write on reporter thread
+    reporter = new async_reporter(reporter);
+  }
+
+  // Zero results, and index statistics
+  // so they are updated as tests complete.
   clear(false);
+  m_stats_ptr->rebuild(*m_list_ptr);
 
   // Initialize timer
   m_start_time = msec_time();
 
   try
   {
-    // Copy into temporary sorted test list
-    test_list tlist = *m_list_ptr;
-    tlist.sort(m_sorted);
+    // Sorted run order. Copied, as the cached
+    // order must not change under us.
+    std::vector<basic_test*> tlist = m_list_ptr->ordered(m_sorted);
 
     std::size_t t_sz = tlist.size();
-    std::size_t l_sz = name_list.size();
+    name_matcher filter(name_list);
 
     // Write report header
     reporter->gen_start(std::cout);
 
-    // Loop through all tests if no error
+    // Determine which tests are to be run,
+    // and hold their indexes in run order.
+    std::vector<std::size_t> plan;
+
     for(std::size_t t = 0; t < t_sz && decl_ok; ++t)
     {
-      bool listed = false;
-      basic_test* tc = tlist.get(t);
-
       // Determine whether this test is in the list
-      for(std::size_t n = 0; n < l_sz; ++n)
+      if (filter.matches(tlist[t])) plan.push_back(t);
+    }
+
+    // Durations from previous runs
+    duration_history history;
+    if (!m_history_file.empty()) history.load(m_history_file);
+
+    // Benchmark timings from previous runs
+    bench_baseline baseline;
+    bool base_changed = false;
+    if (!m_baseline_file.empty()) baseline.load(m_baseline_file);
+
+    std::size_t p_sz = plan.size();
+    std::vector<basic_test*> group;
+    std::vector<tdog::i64_t> costs;
+
+    // Reports tests which hang
+    hang_exit hexit(*this, reporter, deferred, group);
+    watchdog wd(false, m_watchdog_stacks, m_watchdog_exit ? &hexit : 0);
+
+    // Fixtures shared by suite tests
+    shared_set shared;
+    shared.plan(tlist, plan);
+
+    for(std::size_t p = 0; p < p_sz; )
+    {
+      // Build group of tests to run together. Setup
+      // and teardown tests act as barriers, and always
+      // run alone. Otherwise, consecutive tests may be
+      // executed concurrently.
+      std::size_t q = p + 1;
+      group.clear();
+      group.push_back(tlist[plan[p]]);
+
+      if ((m_parallelism > 1 || m_isolated) && !group[0]->is_setup() &&
+        !group[0]->is_teardown())
       {
-        listed = (tc->name_equals(name_list[n], false));
-        if (listed) break;
+        while(q < p_sz && !tlist[plan[q]]->is_setup() &&
+          !tlist[plan[q]]->is_teardown())
+        {
+          group.push_back(tlist[plan[q++]]);
+        }
       }
 
-      // Run this test?
-      if (listed)
+      // Expected durations, where known
+      costs.clear();
+
+      if (group.size() > 1 && history.size() != 0)
       {
-        // Set immutable flag.
-        // This prevent tests modifying the
-        // global runner (accidentally).
-        m_immutable = true;
+        for(std::size_t k = 0; k < group.size(); ++k)
+        {
+          costs.push_back(history.get(group[k]->full_name()));
+        }
+      }
+
+      // Set immutable flag.
+      // This prevent tests modifying the
+      // global runner (accidentally).
+      m_immutable = true;
+
+      // Set up shared fixtures first used here
+      shared.setup(group);
+
+      // RUN TESTS
+      _run_group(group, costs, &wd);
+
+      // Clear immutable
+      m_immutable = false;
+
+      // Tear down those not used again
+      shared.teardown(group, q);
 
-        // RUN TEST
-        tc->run(m_global_time_limit, m_global_time_warn);
+      // Results are reported in run order
+      for(std::size_t k = p; k < q; ++k)
+      {
+        std::size_t t = plan[k];
+        basic_test* tc = tlist[t];
 
-        // Clear immutable
-        m_immutable = false;
+        // Compare benchmarks before counting status
+        if (!m_baseline_file.empty() && _check_baseline(baseline, tc))
+        {
+          base_changed = true;
+        }
 
         // Increment run counter
         if (tc->helper().has_ran()) ++run_cnt;
@@ -615,44 +1163,42 @@ int runner::run(const std::string& names, bool throw_declerr)
         // Failed or error
         if (tc->helper().has_failed()) ++fail_cnt;
 
+        // Aggregate statistics
+        m_stats_ptr->update(tc);
+
+        // Record duration for next time
+        if (tc->helper().has_ran())
+        {
+          history.set(tc->full_name(), tc->helper().duration());
+        }
+
         // Write report
         reporter->gen_test(std::cout, tc);
 
         // Skip tests in suite if setup() failed
         if (tc->helper().has_failed() && tc->is_setup())
         {
-          std::string sname = tc->suite_name() + NSSEP + "*";
+          name_matcher sname(tc->suite_name() + NSSEP + "*");
 
-          for(std::size_t k = t + 1; k < t_sz; ++k)
+          for(std::size_t j = t + 1; j < t_sz; ++j)
           {
-            if (tlist.get(k)->name_equals(sname, false))
+            if (sname.matches(tlist[j]))
             {
-              tlist.get(k)->set_skipped();
+              tlist[j]->set_skipped();
+              m_stats_ptr->update(tlist[j]);
             }
           }
         }
       }
-    }
-
-    // Mark end time
-    m_end_time = msec_time();
-
-    // Write report footer
-    reporter->gen_end(std::cout);
-
-    // Generate additional reports
-    for(std::size_t n = 0; n < m_reports_out.size(); ++n)
-    {
-      std::ofstream fs;
-      fs.open(m_reports_out[n].fileout.c_str());
 
-      if (fs.is_open())
-      {
-        generate_report(fs, m_reports_out[n].style);
-        fs.close();
-      }
+      p = q;
     }
 
+    if (!m_history_file.empty()) history.save(m_history_file);
+    if (base_changed) baseline.save(m_baseline_file);
+
+    // Footer, and deferred reports
+    _end_reports(reporter, deferred);
   }
   catch(...)
   {
@@ -680,11 +1226,18 @@ int runner::run_cmdline(int argc, char* argv[], bool def_run)
   // Run the test according to the given command line arguments.
   if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
 
-  std::string run_list, dis_list;
+  int jobs;
+  bool iso;
+  std::string run_list, dis_list, hist, base;
 
   bool parse_ok = _run_parse<char>(argc,
     const_cast<const char**>(argv),
-    run_list, dis_list);
+    run_list, dis_list, &jobs, &iso, &hist, &base);
+
+  if (jobs >= 0) set_parallelism(jobs);
+  if (iso) set_isolated(true);
+  if (!hist.empty()) set_history_file(hist);
+  if (!base.empty()) set_baseline_file(base);
 
   if (parse_ok || def_run)
   {
@@ -702,11 +1255,18 @@ int runner::run_cmdline(int argc, wchar_t* argv[], bool def_run)
   // Overload of above
   if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
 
-  std::string run_list, dis_list;
+  int jobs;
+  bool iso;
+  std::string run_list, dis_list, hist, base;
 
   bool parse_ok = _run_parse<wchar_t>(argc,
     const_cast<const wchar_t**>(argv),
-    run_list, dis_list);
+    run_list, dis_list, &jobs, &iso, &hist, &base);
+
+  if (jobs >= 0) set_parallelism(jobs);
+  if (iso) set_isolated(true);
+  if (!hist.empty()) set_history_file(hist);
+  if (!base.empty()) set_baseline_file(base);
 
   if (parse_ok || def_run)
   {
@@ -749,6 +1309,122 @@ void runner::set_global_time_warning(tdog::i64_t ms)
   else m_global_time_warn = 0;
 }
 //---------------------------------------------------------------------------
+int runner::parallelism() const
+{
+  // Returns the maximum number of test cases run concurrently.
+  return m_parallelism;
+}
+//---------------------------------------------------------------------------
+void runner::set_parallelism(int n)
+{
+  // Sets the maximum number of test cases run concurrently.
+  // Zero gives the number of processors.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  if (n == 0) m_parallelism = cpu_count();
+  else if (n > 0) m_parallelism = n;
+  else m_parallelism = 1;
+}
+//---------------------------------------------------------------------------
+bool runner::isolated() const
+{
+  // Returns whether tests run in worker processes.
+  return m_isolated;
+}
+//---------------------------------------------------------------------------
+void runner::set_isolated(bool flag)
+{
+  // Sets whether tests run in worker processes.
+  // Ignored where not supported.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  m_isolated = (flag && process_pool::supported());
+}
+//---------------------------------------------------------------------------
+std::string runner::history_file() const
+{
+  // Returns the test duration history filename.
+  return m_history_file;
+}
+//---------------------------------------------------------------------------
+void runner::set_history_file(const std::string& filename)
+{
+  // Sets the name of a file used to record test durations between runs.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  m_history_file = trim_str(filename);
+}
+//---------------------------------------------------------------------------
+std::string runner::baseline_file() const
+{
+  // Returns the benchmark baseline filename.
+  return m_baseline_file;
+}
+//---------------------------------------------------------------------------
+void runner::set_baseline_file(const std::string& filename)
+{
+  // Sets the name of a file of benchmark timings to compare against.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  m_baseline_file = trim_str(filename);
+}
+//---------------------------------------------------------------------------
+bool runner::baseline_update() const
+{
+  // Returns whether benchmark baselines are updated.
+  return m_baseline_update;
+}
+//---------------------------------------------------------------------------
+void runner::set_baseline_update(bool flag)
+{
+  // Sets whether benchmark baselines are updated.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  m_baseline_update = flag;
+}
+//---------------------------------------------------------------------------
+bool runner::hw_counters() const
+{
+  // Returns whether hardware counters are taken.
+  return m_hw_counters;
+}
+//---------------------------------------------------------------------------
+void runner::set_hw_counters(bool flag)
+{
+  // Sets whether hardware counters are taken around each test.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  m_hw_counters = flag;
+}
+//---------------------------------------------------------------------------
+bool runner::watchdog_exit() const
+{
+  // Returns whether the watchdog ends the run when a test hangs.
+  return m_watchdog_exit;
+}
+//---------------------------------------------------------------------------
+void runner::set_watchdog_exit(bool flag)
+{
+  // Sets whether the watchdog ends the run when a test hangs.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  m_watchdog_exit = flag;
+}
+//---------------------------------------------------------------------------
+bool runner::watchdog_stacks() const
+{
+  // Returns whether the watchdog takes stack snapshots.
+  return m_watchdog_stacks;
+}
+//---------------------------------------------------------------------------
+void runner::set_watchdog_stacks(bool flag)
+{
+  // Sets whether the watchdog takes stack snapshots.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  m_watchdog_stacks = flag;
+}
+//---------------------------------------------------------------------------
 report_style_t runner::default_report() const
 {
   // Returns the report style written to STDOUT during the test run.
@@ -763,43 +1439,41 @@ void runner::set_default_report(report_style_t style)
   m_report_style = style;
 }
 //---------------------------------------------------------------------------
+bool runner::async_report() const
+{
+  // Returns whether the STDOUT report is written on a separate thread.
+  return m_async_report;
+}
+//---------------------------------------------------------------------------
+void runner::set_async_report(bool flag)
+{
+  // Sets whether the STDOUT report is written on a separate thread.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  m_async_report = flag;
+}
+//---------------------------------------------------------------------------
 std::ostream& runner::generate_report(std::ostream& ro, report_style_t style) const
 {
   // Generates a test report pertaining to the last test run and writes
   // it to the supplied output stream.
   if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
 
-  // Create reporter
-  basic_reporter* reporter = _create_reporter(style);
-
-  test_list temp = *m_list_ptr;
-  temp.sort(m_sorted);
+  // Reporter is deleted by mux
+  report_mux mux;
+  mux.add(_create_reporter(style), ro);
 
   try
   {
-    // Write report header
-    reporter->gen_start(ro);
-
-    // Loop through all tests
-    for(std::size_t n = 0; n < temp.size(); ++n)
-    {
-      reporter->gen_test(ro, temp.get(n));
-    }
-
-    // Write report footer
-    reporter->gen_end(ro);
+    mux.generate(m_list_ptr->ordered(m_sorted));
   }
   catch(...)
   {
     // Unexpected exception
-    delete reporter;
     std::cout << "\nABORTED - Unknown exception in test library.\n";
     throw;
   }
 
-  // Delete reporter
-  delete reporter;
-
   return ro;
 }
 //---------------------------------------------------------------------------
@@ -817,6 +1491,51 @@ void runner::add_report(report_style_t style, const std::string& filename)
   }
 }
 //---------------------------------------------------------------------------
+bool runner::save_results(const std::string& filename) const
+{
+  // Saves the results of the last test run to a binary file.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  result_info info;
+  info.platos = m_platos;
+  info.project_name = m_project_name;
+  info.project_version = m_project_version;
+  info.project_desc = m_project_desc;
+  info.start_time = m_start_time;
+  info.end_time = m_end_time;
+  info.sorted = m_sorted;
+  info.hostname = run_hostname();
+  info.decl_errors = declaration_errors(true);
+
+  return result_file::save(filename, info, m_list_ptr->ordered(m_sorted));
+}
+//---------------------------------------------------------------------------
+bool runner::load_results(const std::string& filename)
+{
+  // Loads test results from a file written by save_results().
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  result_info info;
+  std::vector<basic_test*> tests;
+  if (!result_file::load(filename, info, tests)) return false;
+
+  _adopt_results(info, tests);
+  return true;
+}
+//---------------------------------------------------------------------------
+bool runner::merge_results(const std::vector<std::string>& filenames)
+{
+  // Loads and merges test results from several files.
+  if (m_immutable) throw std::logic_error(IMMUTABLE_ERROR);
+
+  result_info info;
+  std::vector<basic_test*> tests;
+  if (!result_file::merge(filenames, info, tests)) return false;
+
+  _adopt_results(info, tests);
+  return true;
+}
+//---------------------------------------------------------------------------
 std::string runner::report_charset() const
 {
   // Returns the test report character set encoding.
@@ -874,15 +1593,21 @@ tdog::i64_t runner::statistic_count(stat_count_t type, const std::string& name)
     return static_cast<int>(declaration_errors().size());
   }
 
+  // Answer from aggregated statistics where the
+  // name is a single test, suite or suite tree.
+  tdog::i64_t rslt = 0;
+  name_matcher filter(name);
+
+  if (m_stats_ptr->query(*m_list_ptr, filter, type, rslt)) return rslt;
+
   // Loop through tests and perform count
   int run_cnt = 0;
-  tdog::i64_t rslt = 0;
 
   for(std::size_t n = 0; n < m_list_ptr->size(); ++n)
   {
     basic_test* tc = m_list_ptr->get(n);
 
-    if (tc->name_equals(name, false))
+    if (filter.matches(tc))
     {
       // Get status
       status_t status = tc->helper().status();
@@ -926,6 +1651,18 @@ tdog::i64_t runner::statistic_count(stat_count_t type, const std::string& name)
         case CNT_DURATION:
           rslt += tc->helper().duration(); // <- why result needs to be 64 bit
           break;
+        case CNT_CYCLES:
+          rslt += std::max(tc->helper().counts().cycles, tdog::i64_t(0));
+          break;
+        case CNT_INSTRUCTIONS:
+          rslt += std::max(tc->helper().counts().instructions, tdog::i64_t(0));
+          break;
+        case CNT_CACHE_MISSES:
+          rslt += std::max(tc->helper().counts().cache_misses, tdog::i64_t(0));
+          break;
+        case CNT_BRANCH_MISSES:
+          rslt += std::max(tc->helper().counts().branch_misses, tdog::i64_t(0));
+          break;
         default:
           // Error
           return -1;
@@ -983,4 +1720,11 @@ tdog::i64_t runner::duration() const
   return m_end_time - m_start_time;
 }
 //---------------------------------------------------------------------------
+std::string runner::run_hostname() const
+{
+  // Returns the host of the last test run.
+  if (m_loaded) return m_hostname;
+  return tdog::hostname();
+}
+//---------------------------------------------------------------------------
 
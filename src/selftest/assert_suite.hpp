@@ -17,8 +17,12 @@
 //---------------------------------------------------------------------------
 #include <tdog.hpp>
 
+#include <cstdio>
+#include <fstream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 //---------------------------------------------------------------------------
 // DOCUMENTATION
@@ -44,6 +48,45 @@ TDOG_SUITE(assert_suite)
     if (flag) throw std::runtime_error("test error");
   }
 
+  std::string _pass_seq(const std::string& txt, const std::string& name)
+  {
+    // Pass messages of test in verbose report, in order
+    // and without line numbers, each followed by "|"
+    std::string rslt;
+    const std::string LEAD = name + " : OK: ";
+
+    for(std::size_t pos = txt.find(LEAD); pos != NPOS; pos = txt.find(LEAD, pos + 1))
+    {
+      pos += LEAD.size();
+      rslt += txt.substr(pos, txt.find(" [", pos) - pos) + "|";
+    }
+
+    return rslt;
+  }
+
+  // Files for file asserts. Negative tests use
+  // their own, as tests may run concurrently.
+  const char* const FILE_A = "./tdog_assert_a.tmp";
+  const char* const FILE_B = "./tdog_assert_b.tmp";
+  const char* const FILE_C = "./tdog_assert_c.tmp";
+  const char* const FILE_D = "./tdog_assert_d.tmp";
+  const char* const FILE_E = "./tdog_assert_e.tmp";
+
+  // Lines of 16 bytes
+  std::string line_text(std::size_t lines)
+  {
+    std::string rslt;
+    rslt.reserve(lines * 16);
+    for(std::size_t n = 0; n < lines; ++n) rslt += "0123456789abcde\n";
+    return rslt;
+  }
+
+  void write_file(const std::string& fn, const std::string& s)
+  {
+    std::ofstream fs(fn.c_str(), std::ios::binary);
+    fs.write(s.data(), static_cast<std::streamsize>(s.size()));
+  }
+
   // ------------------------------
   // POSITIVE INTERNAL
   // ------------------------------
@@ -55,6 +98,42 @@ TDOG_SUITE(assert_suite)
       TDOG_ASSERT_MSG(true, "assert_msg()");
     }
 
+    TDOG_TEST_CASE(assert_repeat)
+    {
+      for(int n = 0; n < 1000; ++n) TDOG_ASSERT(true);
+      TDOG_ASSERT_MSG(true, "assert_msg()");
+    }
+
+    TDOG_TEST_CASE(assert_repeat_mixed)
+    {
+      // Interleaved passes, with a print between loops
+      for(int n = 0; n < 1000; ++n)
+      {
+        TDOG_ASSERT(true);
+        TDOG_ASSERT_EQ(n, n);
+        TDOG_ASSERT_MSG(true, std::string("user msg"));
+      }
+
+      TDOG_PRINT("between loops");
+
+      for(int n = 0; n < 1000; ++n)
+      {
+        TDOG_ASSERT(true);
+        TDOG_ASSERT_EQ(n, n);
+      }
+    }
+
+    TDOG_TEST_CASE(assert_repeat_uneven)
+    {
+      // Inner loop varies, so cycles are broken off
+      for(int n = 0; n < 50; ++n)
+      {
+        TDOG_ASSERT_MSG(true, "a");
+        for(int k = 0; k < n % 3; ++k) TDOG_ASSERT_MSG(true, "b");
+        if (n < 49) TDOG_ASSERT_MSG(true, "c");
+      }
+    }
+
     TDOG_TEST_CASE(assert_not)
     {
       TDOG_ASSERT(true);
@@ -214,6 +293,28 @@ TDOG_SUITE(assert_suite)
 
       TDOG_ASSERT_ARRAY_EQ(va, vb, 3);
       TDOG_ASSERT_ARRAY_EQ_MSG(va, vb, 3, "assert_array_eq_msg(vector)");
+
+      // Sizes around the vector widths, compared as memory
+      std::vector<unsigned char> ca(4099), cb;
+      for(std::size_t n = 0; n < ca.size(); ++n) ca[n] = (unsigned char)(n * 7);
+      cb = ca;
+
+      for(std::size_t n = 0; n < 130; ++n)
+      {
+        TDOG_ASSERT_ARRAY_EQ(&ca[0], &cb[0], n);
+        TDOG_ASSERT_ARRAY_EQ(&ca[n], &cb[n], ca.size() - n);
+      }
+
+      const std::vector<unsigned char>& cc(cb);
+      TDOG_ASSERT_ARRAY_EQ(&ca[0], &cc[0], ca.size());
+
+      // Compared element by element
+      double da[] = {0.0, 1.5};
+      double db[] = {-0.0, 1.5};
+      TDOG_ASSERT_ARRAY_EQ(da, db, 2);
+
+      std::vector<bool> ba(3, true), bb(3, true);
+      TDOG_ASSERT_ARRAY_EQ(ba, bb, 3);
     }
 
     TDOG_TEST_CASE(assert_array_neq)
@@ -233,6 +334,46 @@ TDOG_SUITE(assert_suite)
       TDOG_ASSERT_ARRAY_NEQ_MSG(va, vc, 3, "assert_array_neq_msg(vector)");
     }
 
+    TDOG_TEST_CASE(assert_array_close)
+    {
+      // Tail lengths differ from the vector width
+      const double inf = std::numeric_limits<double>::infinity();
+      std::vector<double> da(1001), db;
+      for(std::size_t n = 0; n < da.size(); ++n) da[n] = n * 0.37 - 100.0;
+      db = da;
+      for(std::size_t n = 0; n < db.size(); ++n) db[n] += 0.5e-9 * (int(n % 3) - 1);
+      da[500] = inf;
+      db[500] = inf;
+
+      TDOG_ASSERT_ARRAY_NEAR(da, db, da.size(), 1.0e-9);
+      TDOG_ASSERT_ARRAY_NEAR_MSG(&da[0], &db[0], 999, 1.0e-9, "assert_array_near_msg");
+      TDOG_ASSERT_ARRAY_REL(da, db, da.size(), 1.0e-8);
+
+      float fa[] = {1.0f, -2.0f, 0.0f, 1.0e6f, 3.0f};
+      float fb[] = {1.0000001f, -2.0000002f, -0.0f, 1.0000001e6f, 3.0f};
+      TDOG_ASSERT_ARRAY_REL(fa, fb, 5, 1.0e-6);
+      TDOG_ASSERT_ARRAY_ULP(fa, fb, 5, 2);
+
+      double za[] = {0.0, 1.5};
+      double zb[] = {-0.0, 1.5};
+      TDOG_ASSERT_ARRAY_ULP(za, zb, 2, 0);
+      TDOG_ASSERT_ARRAY_NEAR(za, zb, 0, 0.0);
+    }
+
+    TDOG_TEST_CASE(assert_file_eq)
+    {
+      // Spans more than one window
+      std::string txt = line_text(600000);
+      write_file(FILE_A, txt);
+      write_file(FILE_B, txt);
+      write_file(FILE_E, "");
+
+      TDOG_ASSERT_FILE_EQ(FILE_A, FILE_B);
+      TDOG_ASSERT_FILE_EQ_MSG(FILE_A, FILE_B, "assert_file_eq_msg");
+      TDOG_ASSERT_FILE_BUF_EQ(FILE_A, txt.data(), txt.size());
+      TDOG_ASSERT_FILE_BUF_EQ_MSG(FILE_E, "", 0, "assert_file_buf_eq_msg");
+    }
+
     TDOG_TEST_CASE(assert_throw)
     {
       TDOG_ASSERT_THROW( throw_exception(true), std::runtime_error );
@@ -245,6 +386,15 @@ TDOG_SUITE(assert_suite)
       TDOG_ASSERT_NO_THROW( throw_exception(false) );
     }
 
+    TDOG_TEST_CASE(assert_alloc)
+    {
+      int x = 3;
+      std::vector<int> v;
+      TDOG_ASSERT_NO_ALLOC( x = tsqr(x) );
+      TDOG_ASSERT_ALLOC_LTE( v.reserve(16), 1024 );
+      TDOG_ASSERT_NO_ALLOC( v.push_back(x) ); // <- capacity reserved
+    }
+
     // positive_suite
     TDOG_CLOSE_SUITE
   }
@@ -447,6 +597,81 @@ TDOG_SUITE(assert_suite)
       TDOG_ASSERT_ARRAY_NEQ_MSG(vb, vb, 3, "assert_array_neq_msg(vector)");
     }
 
+    TDOG_TEST_CASE(assert_array_mismatch)
+    {
+      TDOG_SET_CONTINUE_ON_FAIL(true);
+
+      // Must fail, giving location of difference
+      std::vector<unsigned char> ca(1000, 0x5A), cb(ca);
+      cb[777] = 0xA5;
+      TDOG_ASSERT_ARRAY_EQ(ca, cb, ca.size());
+
+      std::vector<int> ia(300, 12345), ib(ia);
+      ib[257] = ~ib[257]; // <- all bytes differ
+      TDOG_ASSERT_ARRAY_EQ(&ia[0], &ib[0], ia.size());
+
+      double da[] = {1, 2, 3, 4, 5, 6};
+      double db[] = {1, 2, 3, 4, 5, 7};
+      TDOG_ASSERT_ARRAY_EQ(da, db, 6);
+
+      std::vector<int> ic(2);
+      TDOG_ASSERT_ARRAY_EQ(ia, ic, 3);
+    }
+
+    TDOG_TEST_CASE(assert_array_close)
+    {
+      TDOG_SET_CONTINUE_ON_FAIL(true);
+
+      // Must fail, giving the worst
+      std::vector<double> da(1000, 1.0), db(da);
+      db[10] = 1.1;
+      db[777] = 1.5;
+      db[999] = 0.9;
+      TDOG_ASSERT_ARRAY_NEAR(da, db, da.size(), 0.01);
+
+      float fa[] = {0, 1, 2, 3, 4, 5, 6};
+      float fb[] = {0, 1, 2, 3, 4, 5, std::numeric_limits<float>::quiet_NaN()};
+      TDOG_ASSERT_ARRAY_REL(fa, fb, 7, 1.0e-3);
+
+      double ua[] = {1.0, 2.0};
+      double ub[] = {1.0, 2.0000000000000009}; // <- 2 ulps
+      TDOG_ASSERT_ARRAY_ULP(ua, ub, 2, 1);
+
+      double na[] = {1.0, 2.0};
+      double nb[] = {1.0, std::numeric_limits<double>::quiet_NaN()};
+      TDOG_ASSERT_ARRAY_ULP(na, nb, 2, 1);
+
+      double ia[] = {-std::numeric_limits<double>::infinity()};
+      double ib[] = {std::numeric_limits<double>::infinity()};
+      TDOG_ASSERT_ARRAY_ULP(ia, ib, 1, 1);
+
+      std::vector<double> dc(2);
+      TDOG_ASSERT_ARRAY_NEAR(da, dc, 3, 0.1);
+
+      const double* nptr = 0;
+      TDOG_ASSERT_ARRAY_NEAR_MSG(nptr, &da[0], 1, 0.1, "assert_array_near_msg");
+    }
+
+    TDOG_TEST_CASE(assert_file_eq)
+    {
+      TDOG_SET_CONTINUE_ON_FAIL(true);
+
+      // Must fail, giving location of difference
+      std::string txt = line_text(600000);
+      write_file(FILE_C, txt);
+      txt[550000 * 16 + 4] = '#';
+      write_file(FILE_D, txt);
+      TDOG_ASSERT_FILE_EQ(FILE_C, FILE_D);
+
+      txt = line_text(3);
+      TDOG_ASSERT_FILE_BUF_EQ(FILE_C, txt.data(), txt.size() - 1);
+
+      TDOG_ASSERT_FILE_EQ_MSG(FILE_C, "./tdog_assert_none.tmp", "assert_file_eq_msg");
+
+      const char* nptr = 0;
+      TDOG_ASSERT_FILE_BUF_EQ(FILE_C, nptr, 1);
+    }
+
     TDOG_TEST_CASE(assert_throw)
     {
       TDOG_SET_CONTINUE_ON_FAIL(true);
@@ -462,6 +687,16 @@ TDOG_SUITE(assert_suite)
       TDOG_ASSERT_NO_THROW( throw_exception(true) );
     }
 
+    TDOG_TEST_CASE(assert_alloc)
+    {
+      TDOG_SET_CONTINUE_ON_FAIL(true);
+
+      // Must fail
+      std::vector<int> v;
+      TDOG_ASSERT_NO_ALLOC( v.push_back(1) );
+      TDOG_ASSERT_ALLOC_LTE( v.reserve(1000), 100 );
+    }
+
     TDOG_TEST_CASE(force_fail)
     {
       TDOG_TEST_FAIL("Test failure was forced");
@@ -529,6 +764,134 @@ TDOG_SUITE(assert_suite)
     TDOG_ASSERT_EQ(NPOS, xml.find("-cond")); // <- not found
     TDOG_ASSERT_NEQ(NPOS, xml.find("ASSERT"));
     TDOG_ASSERT_NEQ(NPOS, xml.find("assert_msg()"));
+
+    // Passing macro asserts hold static
+    // text, built only when reported.
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(positive_suite::assert);
+    TDOG_ASSERT_EQ(2, (int)tc->helper().event_log().size());
+    TDOG_ASSERT( tc->helper().event_log()[0].msg_lit != 0 );
+    TDOG_ASSERT_EQ("ASSERT( true )", tc->helper().event_log()[0].msg());
+    TDOG_ASSERT_EQ("assert_msg()", tc->helper().event_log()[1].msg());
+    TDOG_ASSERT_NEQ(NPOS, txt.find("OK: ASSERT( true )"));
+  }
+
+  TDOG_TEST_CASE(assert_repeat_positive)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/assert_repeat_positive.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(positive_suite::assert_repeat) ) );
+
+    int rslt = tr.run();
+    if (rslt != 0) TDOG_TEST_FAIL("Assert test failed");
+
+    // Passes in a loop are held as one item
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(positive_suite::assert_repeat);
+    TDOG_ASSERT_EQ(1001, tc->helper().assert_cnt());
+    TDOG_ASSERT_EQ(2, (int)tc->helper().event_log().size());
+    TDOG_ASSERT_EQ(1000, tc->helper().event_log()[0].repeat);
+    TDOG_ASSERT_EQ(1, tc->helper().event_log()[1].repeat);
+
+    // But verbose reports are unchanged
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    stm.str("");
+    tr.generate_report(stm, tdog::RS_XML);
+    std::string xml = stm.str();
+
+    int txt_cnt = 0;
+    std::size_t pos = txt.find("OK: ASSERT( true )");
+
+    while(pos != NPOS)
+    {
+      ++txt_cnt;
+      pos = txt.find("OK: ASSERT( true )", pos + 1);
+    }
+
+    int xml_cnt = 0;
+    pos = xml.find("ASSERT( true )");
+
+    while(pos != NPOS)
+    {
+      ++xml_cnt;
+      pos = xml.find("ASSERT( true )", pos + 1);
+    }
+
+    TDOG_ASSERT_EQ(1000, txt_cnt);
+    TDOG_ASSERT_EQ(1000, xml_cnt);
+    TDOG_ASSERT_NEQ(NPOS, txt.find("assert_msg()"));
+  }
+
+  TDOG_TEST_CASE(assert_repeat_mixed_positive)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/assert_repeat_mixed_positive.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(positive_suite::assert_repeat_mixed) ) );
+
+    int rslt = tr.run();
+    if (rslt != 0) TDOG_TEST_FAIL("Assert test failed");
+
+    // Log bounded by asserts in loop, not iterations
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(positive_suite::assert_repeat_mixed);
+    const tdog::event_vector& log = tc->helper().event_log();
+
+    TDOG_ASSERT_EQ(5000, tc->helper().assert_cnt());
+    TDOG_ASSERT_EQ(6, (int)log.size());
+    TDOG_ASSERT_EQ(3, log[0].block);
+    TDOG_ASSERT_EQ(1000, log[0].cycles);
+    TDOG_ASSERT_EQ(1, log[0].repeat);
+    TDOG_ASSERT_EQ(1, log[1].repeat);
+    TDOG_ASSERT_EQ("user msg", log[2].msg());
+    TDOG_ASSERT_EQ("between loops", log[3].msg());
+    TDOG_ASSERT_EQ(2, log[4].block);
+    TDOG_ASSERT_EQ(1000, log[4].cycles);
+
+    // Every pass still written in verbose report, in order
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    std::string exp;
+
+    for(int n = 0; n < 1000; ++n) exp += "ASSERT( true )|ASSERT_EQ( n, n )|user msg|";
+    for(int n = 0; n < 1000; ++n) exp += "ASSERT( true )|ASSERT_EQ( n, n )|";
+
+    TDOG_ASSERT_EQ(exp, _pass_seq(txt, tc->full_name()));
+  }
+
+  TDOG_TEST_CASE(assert_repeat_uneven_positive)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(positive_suite::assert_repeat_uneven) ) );
+
+    int rslt = tr.run();
+    if (rslt != 0) TDOG_TEST_FAIL("Assert test failed");
+
+    // Block cycles and leftover passes written in order
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(positive_suite::assert_repeat_uneven);
+    TDOG_ASSERT_LT((int)tc->helper().event_log().size(), 16);
+
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    std::string exp;
+
+    for(int n = 0; n < 50; ++n)
+    {
+      exp += "a|";
+      for(int k = 0; k < n % 3; ++k) exp += "b|";
+      if (n < 49) exp += "c|";
+    }
+
+    TDOG_ASSERT_EQ(exp, _pass_seq(txt, tc->full_name()));
   }
 
   TDOG_TEST_CASE(assert_not_positive)
@@ -816,6 +1179,52 @@ TDOG_SUITE(assert_suite)
     TDOG_ASSERT_NEQ(NPOS, txt.find("assert_array_neq_msg(vector)"));
   }
 
+  TDOG_TEST_CASE(assert_array_close_positive)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/assert_array_close_positive.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(positive_suite::assert_array_close) ) );
+
+    // Run and check result without relying ASSERT
+    int rslt = tr.run();
+    if (rslt != 0) TDOG_TEST_FAIL("Assert test failed");
+
+    // Check for expected strings
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    TDOG_ASSERT_EQ(NPOS, txt.find("-act")); // <- not found
+    TDOG_ASSERT_NEQ(NPOS, txt.find("assert_array_near_msg"));
+  }
+
+  TDOG_TEST_CASE(assert_file_eq_positive)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/assert_file_eq_positive.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(positive_suite::assert_file_eq) ) );
+
+    // Run and check result without relying ASSERT
+    int rslt = tr.run();
+    std::remove(FILE_A);
+    std::remove(FILE_B);
+    std::remove(FILE_E);
+    if (rslt != 0) TDOG_TEST_FAIL("Assert test failed");
+
+    // Check for expected strings
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    TDOG_ASSERT_EQ(NPOS, txt.find("-offset")); // <- not found
+    TDOG_ASSERT_NEQ(NPOS, txt.find("assert_file_eq_msg"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("assert_file_buf_eq_msg"));
+  }
+
   TDOG_TEST_CASE(assert_throw_positive)
   {
     TDOG_SET_AUTHOR("Kuiper");
@@ -842,6 +1251,35 @@ TDOG_SUITE(assert_suite)
     if (rslt != 0) TDOG_TEST_FAIL("Assert test failed");
   }
 
+  TDOG_TEST_CASE(assert_alloc_positive)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/assert_alloc_positive.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(positive_suite::assert_alloc) ) );
+
+    // Run and check result without relying ASSERT
+    int rslt = tr.run();
+    if (rslt != 0) TDOG_TEST_FAIL("Assert test failed");
+
+    // Warns only where the library does not track allocations
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(positive_suite::assert_alloc);
+    const tdog::run_helper& h = tc->helper();
+
+    if (h.allocs().valid())
+    {
+      TDOG_ASSERT_EQ(tdog::TS_PASS_OK, h.status());
+      TDOG_ASSERT_GTE(h.allocs().count, 1);
+      TDOG_ASSERT_GTE(h.allocs().bytes, (int)(16 * sizeof(int)));
+      TDOG_ASSERT_GTE(h.allocs().peak_bytes, (int)(16 * sizeof(int)));
+    }
+    else
+    {
+      TDOG_ASSERT_EQ(tdog::TS_PASS_WARN, h.status());
+    }
+  }
+
   // ------------------------------
   // NEGATIVE TESTS
   // ------------------------------
@@ -1153,6 +1591,36 @@ TDOG_SUITE(assert_suite)
     TDOG_ASSERT_NEQ(NPOS, txt.find("assert_array_eq_msg(vector)"));
   }
 
+  TDOG_TEST_CASE(assert_array_mismatch)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/assert_array_mismatch.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(negative_suite::assert_array_mismatch) ) );
+
+    // Run and check result without relying ASSERT
+    int rslt = tr.run();
+    if (rslt != 1) TDOG_TEST_FAIL("Assert test failed");
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(negative_suite::assert_array_mismatch);
+    TDOG_ASSERT_EQ(4, tc->helper().fail_cnt());
+
+    // Check for expected strings
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-index = 777\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-offset = 777\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-exp @752: 5a 5a"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find(" 5a[5a] 5a"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find(" 5a[a5] 5a"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-index = 257\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-offset = 1028\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-index = 5\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-error: size less than count"));
+  }
+
   TDOG_TEST_CASE(assert_array_neq_negative)
   {
     TDOG_SET_AUTHOR("Kuiper");
@@ -1174,6 +1642,74 @@ TDOG_SUITE(assert_suite)
     TDOG_ASSERT_NEQ(NPOS, txt.find("assert_array_neq_msg(vector)"));
   }
 
+  TDOG_TEST_CASE(assert_array_close_negative)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/assert_array_close_negative.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(negative_suite::assert_array_close) ) );
+
+    // Run and check result without relying ASSERT
+    int rslt = tr.run();
+    if (rslt != 1) TDOG_TEST_FAIL("Assert test failed");
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(negative_suite::assert_array_close);
+    TDOG_ASSERT_EQ(7, tc->helper().fail_cnt());
+
+    // Check for expected strings
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-mismatches = 3\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-index = 777\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-act = 1.5\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-max abs = 0.5\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-mismatches = 1\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-index = 6\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-max ulp = 2\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-max ulp = NaN\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-max ulp = 18437736874454810624\n"));
+    TDOG_ASSERT_EQ(NPOS, txt.find("-max ulp = -"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-error: size less than count"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-error: invalid null pointer"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("assert_array_near_msg"));
+  }
+
+  TDOG_TEST_CASE(assert_file_eq_negative)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/assert_file_eq_negative.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(negative_suite::assert_file_eq) ) );
+
+    // Run and check result without relying ASSERT
+    int rslt = tr.run();
+    std::remove(FILE_C);
+    std::remove(FILE_D);
+    if (rslt != 1) TDOG_TEST_FAIL("Assert test failed");
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(negative_suite::assert_file_eq);
+    TDOG_ASSERT_EQ(4, tc->helper().fail_cnt());
+
+    // Check for expected strings
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-offset = 8800004\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-line = 550001\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-column = 5\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-offset = 47\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-line = 3\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-column = 16\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-exp size = 9600000\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-act size = 47\n"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-error: cannot open file ./tdog_assert_none.tmp"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("-error: invalid null pointer"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("assert_file_eq_msg"));
+  }
+
   TDOG_TEST_CASE(assert_throw_negative)
   {
     TDOG_SET_AUTHOR("Kuiper");
@@ -1200,6 +1736,37 @@ TDOG_SUITE(assert_suite)
     if (rslt != 1) TDOG_TEST_FAIL("Assert test failed");
   }
 
+  TDOG_TEST_CASE(assert_alloc_negative)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/assert_alloc_negative.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(negative_suite::assert_alloc) ) );
+
+    // Fails only where the library tracks allocations
+    int rslt = tr.run();
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(negative_suite::assert_alloc);
+    const tdog::run_helper& h = tc->helper();
+
+    if (h.allocs().valid())
+    {
+      if (rslt != 1) TDOG_TEST_FAIL("Assert test failed");
+      TDOG_ASSERT_EQ(2, h.fail_cnt());
+
+      std::stringstream stm;
+      tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+      TDOG_ASSERT_NEQ(NPOS, stm.str().find("-allocs = 1"));
+      TDOG_ASSERT_NEQ(NPOS, stm.str().find("-lim = 100"));
+      TDOG_ASSERT_NEQ(NPOS, stm.str().find("ALLOCATIONS: count "));
+    }
+    else
+    {
+      if (rslt != 0) TDOG_TEST_FAIL("Assert test failed");
+      TDOG_ASSERT_EQ(tdog::TS_PASS_WARN, h.status());
+    }
+  }
+
   TDOG_TEST_CASE(force_fail)
   {
     TDOG_SET_AUTHOR("Kuiper");
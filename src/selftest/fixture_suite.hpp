@@ -106,6 +106,52 @@ TDOG_SUITE(fixture_suite)
       throw std::runtime_error("Some error");
     }
 
+    class shr_class_ok
+    {
+    public:
+      int value;
+      shr_class_ok() : value(0) { log += "shr_c "; }
+      ~shr_class_ok() { log += "shr_d "; }
+      bool setup() { log += "shr_setup "; value = 42; return true; }
+      void teardown() { log += "shr_teardown "; }
+    };
+
+    class shr_class_fail
+    {
+    public:
+      shr_class_fail() { log += "shr_c "; }
+      ~shr_class_fail() { log += "shr_d "; }
+      bool setup() { log += "shr_setup "; return false; }
+      void teardown() { log += "shr_teardown "; }
+    };
+
+    TDOG_SHARED_FIXTURE(shr_class_ok)
+    TDOG_SHARED_FIXTURE(shr_class_fail)
+
+    TDOG_TEST_SHARED(shared_a, shr_class_ok)
+    {
+      TDOG_ASSERT_EQ(42, TDOG_SHARED().value);
+    }
+
+    TDOG_TEST_SHARED(shared_b, shr_class_ok)
+    {
+      TDOG_ASSERT_EQ(42, TDOG_SHARED().value);
+    }
+
+    TDOG_TEST_SHARED(shared_c, shr_class_ok)
+    {
+      const USER_TYPE& u = TDOG_SHARED();
+      TDOG_ASSERT_EQ(42, u.value);
+    }
+
+    TDOG_TEST_SHARED(shared_fail_a, shr_class_fail)
+    {
+    }
+
+    TDOG_TEST_SHARED(shared_fail_b, shr_class_fail)
+    {
+    }
+
     TDOG_TEST_CASE(_teardown1)
     {
       log += "teardown1 ";
@@ -299,6 +345,91 @@ TDOG_SUITE(fixture_suite)
     TDOG_ASSERT_NEQ(NPOS, txt.find("ERROR: Fixture teardown()"));
   }
 
+  TDOG_TEST_CASE(shared_positive)
+  {
+    // Shared fixture set up once for all tests
+    // using it, and torn down after the last.
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/fixture_shared_positive.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::shared_c) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::fixture_ok) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::shared_a) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::shared_b) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::_teardown1) ) );
+
+    internal_suite::log.clear();
+    TDOG_ASSERT_EQ(0, tr.run("*"));
+
+    // Run in order registered, with another test between
+    TDOG_ASSERT_EQ("shr_c shr_setup fix_c fix_setup fix_teardown fix_d "
+      "shr_teardown shr_d teardown1 ", internal_suite::log);
+
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(internal_suite::shared_a);
+    TDOG_ASSERT_EQ(tdog::TT_SHARED, tc->test_type());
+    TDOG_ASSERT(tc->shared() != 0);
+    TDOG_ASSERT_EQ("fixture_suite::internal_suite::shr_class_ok", tc->shared()->name());
+    TDOG_ASSERT(!tc->shared()->ready());
+
+    // Setup on first, and teardown on last
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    std::size_t pa = txt.find("shared_a : TEST STARTED");
+    std::size_t pb = txt.find("shared_b : TEST STARTED");
+    std::size_t pc = txt.find("shared_c : TEST STARTED");
+    std::size_t ps = txt.find("shared fixture fixture_suite::internal_suite::shr_class_ok setup in ");
+    std::size_t pt = txt.find("shared fixture fixture_suite::internal_suite::shr_class_ok teardown in ");
+
+    TDOG_ASSERT(pc < pa && pa < pb && pb != NPOS);
+    TDOG_ASSERT(ps > pc && ps < pa);
+    TDOG_ASSERT(pt > pb && pt != NPOS);
+    TDOG_ASSERT_NEQ(NPOS, txt.find("TEST TYPE: SHARED"));
+
+    // Still once where run concurrently
+    tdog::runner pr(tdog::RS_NONE);
+    pr.set_parallelism(4);
+
+    TDOG_ASSERT( pr.register_test( TDOG_GET_TCPTR(internal_suite::shared_a) ) );
+    TDOG_ASSERT( pr.register_test( TDOG_GET_TCPTR(internal_suite::shared_b) ) );
+    TDOG_ASSERT( pr.register_test( TDOG_GET_TCPTR(internal_suite::shared_c) ) );
+
+    internal_suite::log.clear();
+    TDOG_ASSERT_EQ(0, pr.run("*"));
+    TDOG_ASSERT_EQ("shr_c shr_setup shr_teardown shr_d ", internal_suite::log);
+  }
+
+  TDOG_TEST_CASE(shared_setup_fail)
+  {
+    // Where shared setup fails, it is not
+    // retried, and its tests are in error.
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/fixture_shared_setup_fail.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::shared_fail_a) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::shared_fail_b) ) );
+
+    internal_suite::log.clear();
+    TDOG_ASSERT_EQ(2, tr.run("*"));
+
+    TDOG_ASSERT_EQ("shr_c shr_setup shr_d ", internal_suite::log);
+
+    TDOG_ASSERT_EQ(tdog::TS_ERROR, tr.test_status("fixture_suite::internal_suite::shared_fail_a"));
+    TDOG_ASSERT_EQ(tdog::TS_ERROR, tr.test_status("fixture_suite::internal_suite::shared_fail_b"));
+
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_VERBOSE);
+    std::string txt = stm.str();
+
+    TDOG_ASSERT_NEQ(NPOS, txt.find("shr_class_fail setup failed: setup() returned false"));
+    TDOG_ASSERT_NEQ(NPOS, txt.find("Shared fixture fixture_suite::internal_suite::shr_class_fail not set up"));
+  }
+
   // fixture_suite
   TDOG_CLOSE_SUITE
 }
@@ -18,6 +18,12 @@
 #include "comp_unit.hpp"
 
 #include <tdog.hpp>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cctype>
 
 //---------------------------------------------------------------------------
 // DOCUMENTATION
@@ -85,6 +91,164 @@ TDOG_SUITE(runner_suite)
     TDOG_CLOSE_SUITE
   }
 
+  // Written by tests in parallel_suite. Each test
+  // has its own flag, so no locking is needed.
+  bool par_setup = false;
+  bool par_done[4] = {false, false, false, false};
+
+  TDOG_EXPLICIT_SUITE(parallel_suite)
+  {
+    TDOG_TEST_CASE(setup)
+    {
+      TDOG_ASSERT_NOT(par_done[0] || par_done[1] || par_done[2] || par_done[3]);
+      par_setup = true;
+    }
+
+    TDOG_TEST_CASE(par0)
+    {
+      TDOG_ASSERT(par_setup);
+      TDOG_TEST_SLEEP(250);
+      par_done[0] = true;
+    }
+
+    TDOG_TEST_CASE(par1)
+    {
+      TDOG_ASSERT(par_setup);
+      TDOG_TEST_SLEEP(250);
+      par_done[1] = true;
+    }
+
+    TDOG_TEST_CASE(par2)
+    {
+      TDOG_ASSERT(par_setup);
+      TDOG_TEST_SLEEP(250);
+      par_done[2] = true;
+    }
+
+    TDOG_TEST_CASE(par3)
+    {
+      TDOG_ASSERT(par_setup);
+      TDOG_TEST_SLEEP(250);
+      par_done[3] = true;
+    }
+
+    TDOG_TEST_CASE(teardown)
+    {
+      TDOG_ASSERT(par_done[0] && par_done[1] && par_done[2] && par_done[3]);
+    }
+
+    // parallel_suite
+    TDOG_CLOSE_SUITE
+  }
+
+  // Runner queried by its own tests, concurrently
+  const tdog::runner* stats_runner = 0;
+
+  bool query_stats()
+  {
+    // Totals while other tests complete
+    bool ok = true;
+
+    for(int n = 0; n < 2000 && ok; ++n)
+    {
+      ok = (stats_runner->statistic_count(tdog::CNT_TOTAL, "*") == 4 &&
+        stats_runner->statistic_count(tdog::CNT_RAN, "runner_suite::stats_suite::") <= 4);
+    }
+
+    return ok;
+  }
+
+  TDOG_EXPLICIT_SUITE(stats_suite)
+  {
+    TDOG_TEST_CASE(query0)
+    {
+      TDOG_ASSERT( query_stats() );
+    }
+
+    TDOG_TEST_CASE(query1)
+    {
+      TDOG_ASSERT( query_stats() );
+    }
+
+    TDOG_TEST_CASE(query2)
+    {
+      TDOG_ASSERT( query_stats() );
+    }
+
+    TDOG_TEST_CASE(query3)
+    {
+      TDOG_ASSERT( query_stats() );
+    }
+
+    // stats_suite
+    TDOG_CLOSE_SUITE
+  }
+
+  // Durations are such that the run is 400 ms if
+  // taken in order by two workers, but 300 ms
+  // if the long test is started first.
+  TDOG_EXPLICIT_SUITE(history_suite)
+  {
+    TDOG_TEST_CASE(short_a)
+    {
+      TDOG_TEST_SLEEP(100);
+    }
+
+    TDOG_TEST_CASE(short_b)
+    {
+      TDOG_TEST_SLEEP(100);
+    }
+
+    TDOG_TEST_CASE(short_c)
+    {
+      TDOG_TEST_SLEEP(100);
+    }
+
+    TDOG_TEST_CASE(long_d)
+    {
+      TDOG_TEST_SLEEP(300);
+    }
+
+    // history_suite
+    TDOG_CLOSE_SUITE
+  }
+
+  // Changed only in worker processes
+  int iso_counter = 0;
+
+  TDOG_EXPLICIT_SUITE(isolated_suite)
+  {
+    TDOG_TEST_CASE(pass_print)
+    {
+      TDOG_SET_AUTHOR("Kuiper");
+      TDOG_PRINT("Hello from worker");
+      TDOG_ASSERT(true);
+      ++iso_counter;
+    }
+
+    TDOG_TEST_CASE(crash_abort)
+    {
+      TDOG_ASSERT(true);
+      ++iso_counter;
+      std::abort();
+    }
+
+    TDOG_TEST_CASE(fail_assert)
+    {
+      TDOG_ASSERT(false);
+    }
+
+    TDOG_TEST_CASE(pass_after)
+    {
+      TDOG_ASSERT(true);
+      TDOG_ASSERT(true);
+      ++iso_counter;
+    }
+
+    // isolated_suite
+    TDOG_CLOSE_SUITE
+  }
+
   TDOG_TEST_CASE(stats_all)
   {
     TDOG_SET_AUTHOR("Kuiper");
@@ -110,6 +274,89 @@ TDOG_SUITE(runner_suite)
     TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_DISABLED, "*"));
   }
 
+  TDOG_TEST_CASE(stats_nested)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert2) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::fail_assert) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass2) ) );
+
+    TDOG_ASSERT_EQ(1, tr.run("*"));
+
+    // Suite totals roll up through nested suites
+    TDOG_ASSERT_EQ(5, tr.statistic_count(tdog::CNT_TOTAL, "runner_suite::*"));
+    TDOG_ASSERT_EQ(5, tr.statistic_count(tdog::CNT_TOTAL, "runner_suite::internal_suite::*"));
+    TDOG_ASSERT_EQ(3, tr.statistic_count(tdog::CNT_TOTAL, "runner_suite::internal_suite::"));
+    TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_TOTAL, "runner_suite::"));
+    TDOG_ASSERT_EQ(2, tr.statistic_count(tdog::CNT_TOTAL, "runner_suite::internal_suite::nested_suite::"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_FAILED, "runner_suite::*"));
+    TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_FAILED, "runner_suite::internal_suite::nested_suite::*"));
+    TDOG_ASSERT_EQ(80, tr.statistic_count(tdog::CNT_PASS_RATE, "runner_suite::internal_suite::*"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_TOTAL, "runner_suite::internal_suite::fail_assert"));
+    TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_TOTAL, "runner_suite::not_exist::*"));
+
+    // Totals follow changes made after the run
+    TDOG_ASSERT_EQ(1, tr.set_enabled("runner_suite::internal_suite::nested_suite::pass1", false));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_DISABLED, "*"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_DISABLED, "runner_suite::internal_suite::*"));
+    TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_DISABLED, "runner_suite::internal_suite::"));
+    TDOG_ASSERT_EQ(4, tr.statistic_count(tdog::CNT_RAN, "*"));
+
+    // Test cases are shared with other tests
+    tr.set_enabled("runner_suite::internal_suite::nested_suite::pass1", true);
+  }
+
+  TDOG_TEST_CASE(stats_shared)
+  {
+    // Totals follow changes made by another runner
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tdog::runner other(tdog::RS_NONE);
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::fail_assert) ) );
+    TDOG_ASSERT( other.register_test( TDOG_GET_TCPTR(internal_suite::fail_assert) ) );
+
+    TDOG_ASSERT_EQ(1, tr.run("*"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_FAILED, "*"));
+    TDOG_ASSERT_EQ(3, tr.statistic_count(tdog::CNT_ASSERT_TOTAL, "runner_suite::internal_suite::"));
+
+    other.clear(false);
+    TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_FAILED, "*"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_RAN, "runner_suite::*"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_ASSERT_TOTAL, "runner_suite::internal_suite::"));
+
+    TDOG_ASSERT_EQ(1, other.run("*"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_FAILED, "*"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_FAILED, "runner_suite::internal_suite::fail_assert"));
+    TDOG_ASSERT_EQ(2, tr.statistic_count(tdog::CNT_RAN, "*"));
+  }
+
+  TDOG_TEST_CASE(stats_concurrent)
+  {
+    // Queries from tests running in parallel
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.set_parallelism(4);
+    stats_runner = &tr;
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(stats_suite::query0) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(stats_suite::query1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(stats_suite::query2) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(stats_suite::query3) ) );
+
+    TDOG_ASSERT_EQ(0, tr.run("*"));
+    TDOG_ASSERT_EQ(4, tr.statistic_count(tdog::CNT_PASSED, "runner_suite::stats_suite::"));
+    stats_runner = 0;
+  }
+
   TDOG_TEST_CASE(stats_some)
   {
     TDOG_SET_AUTHOR("Kuiper");
@@ -184,6 +431,256 @@ runner_suite::internal_suite::fail_assert runner_suite::internal_suite::nested_s
     const char* argv7[] = {"--help", "--tdis", "TEST4"};
     TDOG_ASSERT_NOT( _run_parse<char>(3, argv7, rout, dout) );
     TDOG_ASSERT_EQ("", rout);
+
+    // Jobs
+    int jobs = 0;
+    const char* argv8[] = {"--trun", "TEST1", "--tjobs", "8", "TEST2"};
+    TDOG_ASSERT( _run_parse<char>(5, argv8, rout, dout, &jobs) );
+    TDOG_ASSERT_EQ("TEST1", rout);
+    TDOG_ASSERT_EQ(8, jobs);
+
+    const char* argv9[] = {"/trun:TEST1", "/tjobs:0"};
+    TDOG_ASSERT( _run_parse<char>(2, argv9, rout, dout, &jobs) );
+    TDOG_ASSERT_EQ("TEST1", rout);
+    TDOG_ASSERT_EQ(0, jobs);
+
+    TDOG_ASSERT( _run_parse<char>(1, argv9, rout, dout, &jobs) );
+    TDOG_ASSERT_EQ(-1, jobs);
+
+    // Isolated
+    bool iso = false;
+    const char* argv10[] = {"--trall", "--tisolate", "--tjobs", "4"};
+    TDOG_ASSERT( _run_parse<char>(4, argv10, rout, dout, &jobs, &iso) );
+    TDOG_ASSERT_EQ("*", rout);
+    TDOG_ASSERT_EQ(4, jobs);
+    TDOG_ASSERT(iso);
+
+    TDOG_ASSERT( _run_parse<char>(1, argv10, rout, dout, &jobs, &iso) );
+    TDOG_ASSERT_NOT(iso);
+
+    // History
+    std::string hist;
+    const char* argv11[] = {"--trall", "--thistory", "hist.txt", "--tjobs", "2"};
+    TDOG_ASSERT( _run_parse<char>(5, argv11, rout, dout, &jobs, &iso, &hist) );
+    TDOG_ASSERT_EQ("*", rout);
+    TDOG_ASSERT_EQ("hist.txt", hist);
+    TDOG_ASSERT_EQ(2, jobs);
+
+    const char* argv12[] = {"/trun:TEST1", "/thistory:hist.txt"};
+    TDOG_ASSERT( _run_parse<char>(2, argv12, rout, dout, &jobs, &iso, &hist) );
+    TDOG_ASSERT_EQ("TEST1", rout);
+    TDOG_ASSERT_EQ("hist.txt", hist);
+
+    TDOG_ASSERT( _run_parse<char>(1, argv12, rout, dout, &jobs, &iso, &hist) );
+    TDOG_ASSERT(hist.empty());
+
+    // Baseline
+    std::string base;
+    const char* argv13[] = {"--trall", "--tbaseline", "base.txt"};
+    TDOG_ASSERT( _run_parse<char>(3, argv13, rout, dout, &jobs, &iso, &hist, &base) );
+    TDOG_ASSERT_EQ("*", rout);
+    TDOG_ASSERT_EQ("base.txt", base);
+
+    const char* argv14[] = {"/trun:TEST1", "/tbaseline:base.txt"};
+    TDOG_ASSERT( _run_parse<char>(2, argv14, rout, dout, &jobs, &iso, &hist, &base) );
+    TDOG_ASSERT_EQ("TEST1", rout);
+    TDOG_ASSERT_EQ("base.txt", base);
+
+    TDOG_ASSERT( _run_parse<char>(1, argv14, rout, dout, &jobs, &iso, &hist, &base) );
+    TDOG_ASSERT(base.empty());
+  }
+
+  TDOG_TEST_CASE(xml_stats)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_XML, "./reports/internal/runner_xml_stats.xml");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert2) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::fail_assert) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass2) ) );
+
+    TDOG_ASSERT_EQ(1, tr.set_enabled("runner_suite::internal_suite::pass_assert2", false));
+    TDOG_ASSERT_EQ(1, tr.run("*"));
+
+    // Counts precede the tests they count
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_XML);
+    std::string xml = stm.str();
+
+    const std::size_t NPOS = std::string::npos;
+    TDOG_ASSERT_NEQ(NPOS, xml.find("tests=\"5\" failures=\"1\" errors=\"0\" skip=\"0\" disabled=\"1\""));
+    TDOG_ASSERT_NEQ(NPOS, xml.find("name=\"runner_suite::internal_suite\" id=\"0\" "
+      "tests=\"3\" errors=\"0\" failures=\"1\" skipped=\"0\" disabled=\"1\""));
+    TDOG_ASSERT_NEQ(NPOS, xml.find("name=\"runner_suite::internal_suite::nested_suite\" id=\"1\" "
+      "tests=\"2\" errors=\"0\" failures=\"0\" skipped=\"0\" disabled=\"0\""));
+
+    // Test cases are shared with other tests
+    tr.set_enabled("runner_suite::internal_suite::pass_assert2", true);
+  }
+
+  TDOG_TEST_CASE(async_report)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_TEXT_VERBOSE);
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert2) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::fail_assert) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass2) ) );
+
+    // Capture STDOUT for both runs
+    std::stringstream sync_out, async_out;
+    std::streambuf* prev = std::cout.rdbuf(sync_out.rdbuf());
+
+    tr.run("*");
+
+    TDOG_ASSERT( !tr.async_report() );
+    tr.set_async_report(true);
+    std::cout.rdbuf(async_out.rdbuf());
+
+    tr.run("*");
+
+    std::cout.rdbuf(prev);
+    TDOG_ASSERT( tr.async_report() );
+
+    // Same report, other than times and dates
+    std::string s1 = sync_out.str();
+    std::string s2 = async_out.str();
+    TDOG_ASSERT( !s1.empty() );
+
+    std::string d1, d2;
+    for(std::size_t n = 0; n < s1.size(); ++n) if (!std::isdigit(s1[n])) d1 += s1[n];
+    for(std::size_t n = 0; n < s2.size(); ++n) if (!std::isdigit(s2[n])) d2 += s2[n];
+
+    TDOG_ASSERT_EQ(d1, d2);
+  }
+
+  TDOG_TEST_CASE(save_results)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.set_project_name("Saved Results");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert2) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::fail_assert) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass2) ) );
+
+    TDOG_ASSERT_EQ(1, tr.set_enabled("runner_suite::internal_suite::pass_assert2", false));
+    TDOG_ASSERT_EQ(1, tr.run("*"));
+
+    const std::string fname = "./reports/internal/runner_results.tdr";
+    TDOG_ASSERT( tr.save_results(fname) );
+
+    // Loaded results give same reports
+    tdog::runner lr(tdog::RS_NONE);
+    TDOG_ASSERT( lr.load_results(fname) );
+    TDOG_ASSERT_EQ("Saved Results", lr.project_name());
+    TDOG_ASSERT_EQ(tr.start_time(), lr.start_time());
+    TDOG_ASSERT_EQ(5, lr.statistic_count(tdog::CNT_TOTAL, "*"));
+    TDOG_ASSERT_EQ(1, lr.statistic_count(tdog::CNT_FAILED, "*"));
+    TDOG_ASSERT_EQ(1, lr.statistic_count(tdog::CNT_DISABLED, "*"));
+
+    std::stringstream s1, s2;
+    tr.generate_report(s1, tdog::RS_TEXT_VERBOSE);
+    lr.generate_report(s2, tdog::RS_TEXT_VERBOSE);
+    TDOG_ASSERT_EQ(s1.str(), s2.str());
+
+    s1.str("");
+    s2.str("");
+    tr.generate_report(s1, tdog::RS_XML);
+    lr.generate_report(s2, tdog::RS_XML);
+    TDOG_ASSERT_EQ(s1.str(), s2.str());
+
+    // Invalid file leaves runner unchanged
+    std::ofstream fs("./reports/internal/runner_invalid.tdr");
+    fs << "Not a results file\n";
+    fs.close();
+
+    TDOG_ASSERT( !lr.load_results("./reports/internal/runner_invalid.tdr") );
+    TDOG_ASSERT( !lr.load_results("./reports/internal/not_exist.tdr") );
+    TDOG_ASSERT_EQ(5, lr.statistic_count(tdog::CNT_TOTAL, "*"));
+    TDOG_ASSERT_EQ(tr.run_hostname(), lr.run_hostname());
+
+    // Run aborted by declaration errors stays aborted
+    tdog::runner dr(tdog::RS_NONE);
+    TDOG_ASSERT( dr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert1) ) );
+    TDOG_ASSERT( !dr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert1) ) );
+    dr.run("*");
+
+    const std::string dname = "./reports/internal/runner_declerr.tdr";
+    TDOG_ASSERT( dr.save_results(dname) );
+    TDOG_ASSERT( lr.load_results(dname) );
+    TDOG_ASSERT_EQ(1, (int)lr.declaration_errors().size());
+    TDOG_ASSERT_EQ(dr.declaration_errors()[0], lr.declaration_errors()[0]);
+    TDOG_ASSERT_EQ(tdog::TS_DECL_ERROR,
+      lr.test_status("runner_suite::internal_suite::pass_assert1"));
+
+    s1.str("");
+    s2.str("");
+    dr.generate_report(s1, tdog::RS_TEXT_VERBOSE);
+    lr.generate_report(s2, tdog::RS_TEXT_VERBOSE);
+    TDOG_ASSERT_NEQ(std::string::npos, s2.str().find("TEST DECLARATION ERRORS"));
+    TDOG_ASSERT_EQ(s1.str(), s2.str());
+
+    // Test cases are shared with other tests
+    tr.set_enabled("runner_suite::internal_suite::pass_assert2", true);
+  }
+
+  TDOG_TEST_CASE(merge_results)
+  {
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::pass_assert2) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::fail_assert) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::nested_suite::pass2) ) );
+
+    // Each shard has all tests, but runs only its share
+    std::vector<std::string> shards;
+    shards.push_back("./reports/internal/runner_shard0.tdr");
+    shards.push_back("./reports/internal/runner_shard1.tdr");
+
+    TDOG_ASSERT_EQ(0, tr.run("runner_suite::internal_suite::pass_assert1, "
+      "runner_suite::internal_suite::nested_suite::*"));
+    TDOG_ASSERT( tr.save_results(shards[0]) );
+
+    TDOG_ASSERT_EQ(1, tr.run("runner_suite::internal_suite::pass_assert2, "
+      "runner_suite::internal_suite::fail_assert"));
+    TDOG_ASSERT( tr.save_results(shards[1]) );
+
+    tdog::runner mr(tdog::RS_NONE);
+    TDOG_ASSERT( mr.merge_results(shards) );
+
+    TDOG_ASSERT_EQ(5, mr.statistic_count(tdog::CNT_TOTAL, "*"));
+    TDOG_ASSERT_EQ(5, mr.statistic_count(tdog::CNT_RAN, "*"));
+    TDOG_ASSERT_EQ(4, mr.statistic_count(tdog::CNT_PASSED, "*"));
+    TDOG_ASSERT_EQ(1, mr.statistic_count(tdog::CNT_FAILED, "*"));
+    TDOG_ASSERT_EQ(2, mr.statistic_count(tdog::CNT_RAN, "runner_suite::internal_suite::nested_suite::*"));
+    TDOG_ASSERT_EQ(tdog::TS_PASS_OK, mr.test_status("runner_suite::internal_suite::pass_assert2"));
+    TDOG_ASSERT_EQ(tdog::TS_PASS_OK, mr.test_status("runner_suite::internal_suite::nested_suite::pass1"));
+
+    // Merged results save to a single file
+    TDOG_ASSERT( mr.save_results("./reports/internal/runner_merged.tdr") );
+    tdog::runner lr(tdog::RS_NONE);
+    TDOG_ASSERT( lr.load_results("./reports/internal/runner_merged.tdr") );
+    TDOG_ASSERT_EQ(5, lr.statistic_count(tdog::CNT_RAN, "*"));
+
+    // Any invalid shard fails
+    shards.push_back("./reports/internal/not_exist.tdr");
+    TDOG_ASSERT( !lr.merge_results(shards) );
+    TDOG_ASSERT_EQ(5, lr.statistic_count(tdog::CNT_RAN, "*"));
   }
 
   TDOG_TEST_CASE(cmdline)
@@ -214,6 +711,157 @@ runner_suite::internal_suite::fail_assert runner_suite::internal_suite::nested_s
     TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_ERRORS, "*"));
   }
 
+  TDOG_TEST_CASE(parallel_run)
+  {
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/runner_parallel.txt");
+
+    // Register out of order
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(parallel_suite::teardown) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(parallel_suite::par0) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(parallel_suite::par1) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(parallel_suite::par2) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(parallel_suite::par3) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(parallel_suite::setup) ) );
+
+    TDOG_ASSERT_EQ(1, tr.parallelism());
+    tr.set_parallelism(4);
+    TDOG_ASSERT_EQ(4, tr.parallelism());
+
+    // Setup and teardown will assert the order
+    TDOG_ASSERT_EQ(0, tr.run("*"));
+    TDOG_ASSERT_EQ(6, tr.statistic_count(tdog::CNT_RAN, "*"));
+    TDOG_ASSERT_EQ(6, tr.statistic_count(tdog::CNT_PASSED, "*"));
+
+    // Each test of 250 ms should overlap another by a good
+    // margin, which cannot happen if executed serially.
+    // Not timed, as the host may be loaded.
+    TDOG_PRINTF("Parallel duration: %i ms", tr.duration());
+
+    const tdog::basic_test* par[4] = { TDOG_GET_TCPTR(parallel_suite::par0),
+      TDOG_GET_TCPTR(parallel_suite::par1), TDOG_GET_TCPTR(parallel_suite::par2),
+      TDOG_GET_TCPTR(parallel_suite::par3) };
+
+    for(int i = 0; i < 4; ++i)
+    {
+      bool overlap = false;
+      tdog::i64_t si = par[i]->helper().start_time();
+      tdog::i64_t ei = si + par[i]->helper().duration();
+
+      for(int j = 0; j < 4 && !overlap; ++j)
+      {
+        tdog::i64_t sj = par[j]->helper().start_time();
+        tdog::i64_t ej = sj + par[j]->helper().duration();
+        overlap = (i != j && sj + 100 < ei && si + 100 < ej);
+      }
+
+      TDOG_ASSERT_MSG(overlap, "Test ran concurrently with another");
+    }
+  }
+
+  TDOG_TEST_CASE(history_run)
+  {
+    const char* HIST_FILE = "./reports/internal/runner_history.txt";
+    std::remove(HIST_FILE);
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/runner_history_rpt.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(history_suite::short_a) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(history_suite::short_b) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(history_suite::short_c) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(history_suite::long_d) ) );
+
+    TDOG_ASSERT( tr.history_file().empty() );
+    tr.set_history_file(HIST_FILE);
+    TDOG_ASSERT_EQ(HIST_FILE, tr.history_file());
+    tr.set_parallelism(2);
+
+    // No history yet, but file is written
+    TDOG_ASSERT_EQ(0, tr.run("*"));
+    TDOG_PRINTF("First run duration: %i ms", tr.duration());
+
+    std::ifstream fs(HIST_FILE);
+    TDOG_ASSERT( fs.is_open() );
+    fs.close();
+
+    // Long test now scheduled first, so no short test starts before
+    // it (one starts alongside it). Checked by start order rather than
+    // run duration, as the host may be loaded.
+    const tdog::basic_test* d = TDOG_GET_TCPTR(history_suite::long_d);
+    const tdog::basic_test* a = TDOG_GET_TCPTR(history_suite::short_a);
+    const tdog::basic_test* b = TDOG_GET_TCPTR(history_suite::short_b);
+    const tdog::basic_test* c = TDOG_GET_TCPTR(history_suite::short_c);
+
+    TDOG_ASSERT_EQ(0, tr.run("*"));
+    TDOG_ASSERT_EQ(4, tr.statistic_count(tdog::CNT_PASSED, "*"));
+    TDOG_PRINTF("Second run duration: %i ms", tr.duration());
+    TDOG_ASSERT_LTE(d->helper().start_time(), a->helper().start_time());
+    TDOG_ASSERT_LTE(d->helper().start_time(), b->helper().start_time());
+    TDOG_ASSERT_LTE(d->helper().start_time(), c->helper().start_time());
+
+    // Same again in worker processes
+    tr.set_isolated(true);
+
+    if (tr.isolated())
+    {
+      TDOG_ASSERT_EQ(0, tr.run("*"));
+      TDOG_PRINTF("Isolated run duration: %i ms", tr.duration());
+      TDOG_ASSERT_LTE(d->helper().start_time(), a->helper().start_time());
+      TDOG_ASSERT_LTE(d->helper().start_time(), b->helper().start_time());
+      TDOG_ASSERT_LTE(d->helper().start_time(), c->helper().start_time());
+    }
+  }
+
+  TDOG_TEST_CASE(isolated_run)
+  {
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/runner_isolated.txt");
+
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(isolated_suite::pass_print) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(isolated_suite::crash_abort) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(isolated_suite::fail_assert) ) );
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(isolated_suite::pass_after) ) );
+
+    tr.set_isolated(true);
+
+    if (!tr.isolated())
+    {
+      TDOG_PRINT("Process isolation not supported on this platform");
+      return;
+    }
+
+    // One worker, so the crash must
+    // not prevent pass_after from running.
+    TDOG_ASSERT_EQ(2, tr.run("*"));
+    TDOG_ASSERT_EQ(4, tr.statistic_count(tdog::CNT_RAN, "*"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_ERRORS, "*"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_FAILED, "*"));
+    TDOG_ASSERT_EQ(4, tr.statistic_count(tdog::CNT_ASSERT_TOTAL, "*"));
+
+    TDOG_ASSERT_EQ(tdog::TS_ERROR,
+      tr.test_status("runner_suite::isolated_suite::crash_abort"));
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(isolated_suite::crash_abort);
+    TDOG_ASSERT_EQ("SIGABRT", tc->helper().error_name());
+
+    // Results passed back from worker
+    tc = TDOG_GET_TCPTR(isolated_suite::pass_print);
+    TDOG_ASSERT_EQ(tdog::TS_PASS_OK, tc->helper().status());
+    TDOG_ASSERT_EQ("Kuiper", tc->helper().author());
+    TDOG_ASSERT_EQ(2, (int)tc->helper().event_log().size());
+    TDOG_ASSERT_EQ("Hello from worker", tc->helper().event_log()[0].msg());
+
+    // Workers do not share our memory
+    TDOG_ASSERT_EQ(0, iso_counter);
+
+    // Again with two workers
+    tr.set_parallelism(2);
+    TDOG_ASSERT_EQ(2, tr.run("*"));
+    TDOG_ASSERT_EQ(4, tr.statistic_count(tdog::CNT_RAN, "*"));
+    TDOG_ASSERT_EQ(tdog::TS_PASS_OK,
+      tr.test_status("runner_suite::isolated_suite::pass_after"));
+  }
+
   TDOG_TEST_CASE(singleton_method)
   {
     // Test our singleton method gives the same
@@ -229,6 +877,107 @@ runner_suite::internal_suite::fail_assert runner_suite::internal_suite::nested_s
     }
   }
 
+  TDOG_TEST_CASE(registry_lookup)
+  {
+    // Enough tests that lookup by scanning
+    // would be noticeably slow.
+    const int TEST_CNT = 5000;
+
+    tdog::suite_manager suiteA_open(true, "regA", false);
+    dummy_test direct("direct");
+
+    tdog::suite_manager suiteB_open(true, "regB", false);
+    std::vector<dummy_test*> tests;
+    char buf[32];
+
+    for(int n = 0; n < TEST_CNT; ++n)
+    {
+      std::sprintf(buf, "test%d", n);
+      tests.push_back(new dummy_test(buf));
+    }
+
+    tdog::suite_manager suiteB_close(false);
+    tdog::suite_manager suiteA_close(false);
+
+    TDOG_ASSERT_EQ(0, suiteA_open.counter());
+    TDOG_ASSERT_EQ(0, suiteA_close.counter());
+    TDOG_ASSERT_EQ(0, suiteB_open.counter());
+    TDOG_ASSERT_EQ(0, suiteB_close.counter());
+
+    tdog::runner tr(tdog::RS_NONE);
+
+    for(int n = 0; n < TEST_CNT; ++n)
+    {
+      tr.register_test(tests[n]);
+    }
+
+    // Run order is cached, but must
+    // change when a test is registered
+    std::vector<std::string> names;
+    TDOG_ASSERT_EQ(TEST_CNT, (int)tr.enumerate_test_names(names).size());
+    TDOG_ASSERT_EQ("regA::regB::test0", names[0]);
+
+    TDOG_ASSERT( tr.register_test(&direct) );
+    TDOG_ASSERT( tr.declaration_errors().empty() );
+
+    TDOG_ASSERT_EQ(TEST_CNT + 1, (int)tr.enumerate_test_names(names).size());
+    TDOG_ASSERT_EQ("regA::direct", names[0]);
+
+    // Test names
+    TDOG_ASSERT( tr.exists("regA::regB::test0") );
+    TDOG_ASSERT( tr.exists("::regA::regB::test4999") );
+    TDOG_ASSERT( tr.exists("regA::direct") );
+    TDOG_ASSERT_NOT( tr.exists("regA::regB::test5000") );
+    TDOG_ASSERT_NOT( tr.exists("regA::regB::test") );
+
+    // Suite names
+    TDOG_ASSERT( tr.exists("regA::") );
+    TDOG_ASSERT( tr.exists("regA::*") );
+    TDOG_ASSERT( tr.exists("regA::regB::") );
+    TDOG_ASSERT( tr.exists("regA::regB::*") );
+    TDOG_ASSERT( tr.exists("*") );
+    TDOG_ASSERT_NOT( tr.exists("regB::") );
+    TDOG_ASSERT_NOT( tr.exists("regA::reg*") );
+    TDOG_ASSERT_NOT( tr.exists("regA::regB") );
+    TDOG_ASSERT_NOT( tr.exists("::") );
+
+    TDOG_ASSERT_EQ(tdog::TS_READY, tr.test_status("regA::regB::test2500"));
+    TDOG_ASSERT_EQ(tdog::TS_NOT_EXIST, tr.test_status("regA::regB::*"));
+
+    // Pattern counts
+    TDOG_ASSERT_EQ(TEST_CNT + 1, tr.statistic_count(tdog::CNT_TOTAL, "regA::*"));
+    TDOG_ASSERT_EQ(TEST_CNT + 1, tr.statistic_count(tdog::CNT_TOTAL, "::*"));
+    TDOG_ASSERT_EQ(TEST_CNT, tr.statistic_count(tdog::CNT_TOTAL, "regA::regB::*"));
+    TDOG_ASSERT_EQ(TEST_CNT, tr.statistic_count(tdog::CNT_TOTAL, "::regA::regB::"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_TOTAL, "regA::"));
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_TOTAL, "regA::regB::test99"));
+    TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_TOTAL, "regB::*"));
+
+    // Long run list, with overlapping patterns
+    std::string run_list = "regA::, regA::direct";
+
+    for(int n = 0; n < TEST_CNT; n += 10)
+    {
+      std::sprintf(buf, " regA::regB::test%d", n);
+      run_list += buf;
+    }
+
+    TDOG_ASSERT_EQ(2, tr.set_enabled("regA::direct regA::regB::test10", false));
+    TDOG_ASSERT_EQ(0, tr.run(run_list));
+    TDOG_ASSERT_EQ(TEST_CNT / 10 - 1, tr.statistic_count(tdog::CNT_RAN, "*"));
+    TDOG_ASSERT_EQ(2, tr.statistic_count(tdog::CNT_DISABLED, "*"));
+    TDOG_ASSERT_EQ(2, tr.set_enabled("*", true));
+
+    // Duplicate is rejected
+    TDOG_ASSERT_NOT( tr.register_test(tests[10]) );
+    TDOG_ASSERT_EQ(1, (int)tr.declaration_errors().size());
+
+    for(int n = 0; n < TEST_CNT; ++n)
+    {
+      delete tests[n];
+    }
+  }
+
   TDOG_TEST_CASE(immutable_test)
   {
     // Ensure code withing test cases can't change global runner
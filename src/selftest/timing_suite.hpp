@@ -18,6 +18,11 @@
 #include <tdog.hpp>
 
 #include <ctime>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
 
 //---------------------------------------------------------------------------
 // DOCUMENTATION
@@ -35,6 +40,9 @@ TDOG_SUITE(timing_suite)
 
   TDOG_EXPLICIT_SUITE(internal_suite)
   {
+    // Set where assert_loop runs to its end
+    bool loop_ended = false;
+
     void wait_delay(int min_sec)
     {
       // Crude platform independent "sleep" function which
@@ -48,6 +56,18 @@ TDOG_SUITE(timing_suite)
       }
     }
 
+    void write_baseline(const std::string& filename, int fast_cnt, int slow_cnt)
+    {
+      // Baseline for bench_sum, with samples far faster
+      // or slower than it can run, to give a known result.
+      std::ofstream fs(filename.c_str());
+      fs << "# Test baseline\n";
+      fs << "timing_suite::internal_suite::bench_sum\t";
+      for(int n = 0; n < fast_cnt; ++n) fs << "0.001 ";
+      for(int n = 0; n < slow_cnt; ++n) fs << "1000000000 ";
+      fs << "\n";
+    }
+
     TDOG_TEST_CASE(local_timeout)
     {
       // Test expected to fail.
@@ -93,6 +113,25 @@ TDOG_SUITE(timing_suite)
       TDOG_TEST_SLEEP(1500);
     }
 
+    TDOG_TEST_CASE(assert_loop)
+    {
+      // Test expected to fail on global limit,
+      // detected from asserts alone.
+      std::time_t until = std::time(0) + 3;
+      loop_ended = false;
+      while(std::time(0) <= until) TDOG_ASSERT(true);
+      loop_ended = true;
+    }
+
+    TDOG_TEST_CASE(hang)
+    {
+      // Test expected to fail. No asserts
+      // or prints, so only the watchdog
+      // can see it while it runs.
+      TDOG_SET_TEST_TIMEOUT(200);
+      wait_delay(2);
+    }
+
     TDOG_TEST_CASE(check_limit)
     {
       // Wait while checking limit
@@ -111,6 +150,35 @@ TDOG_SUITE(timing_suite)
       TDOG_TEST_ERROR("Never detected timout");
     }
 
+    TDOG_BENCHMARK(bench_sum)
+    {
+      // Expect to pass, with figures
+      int sum = 0;
+      for(int n = 0; n < 100; ++n) sum += n;
+
+      TDOG_DO_NOT_OPTIMIZE(sum);
+      TDOG_ASSERT_EQ(4950, sum);
+    }
+
+    TDOG_BENCHMARK(bench_fail)
+    {
+      // Test expected to fail
+      TDOG_ASSERT(false);
+    }
+
+    TDOG_TEST_CASE(count_loop)
+    {
+      // Expect to pass, with some work to count
+      int sum = 0;
+      for(int n = 0; n < 100000; ++n)
+      {
+        sum += n % 7;
+        TDOG_DO_NOT_OPTIMIZE(sum);
+      }
+
+      TDOG_ASSERT_EQ(299995, sum);
+    }
+
     TDOG_CLOSE_SUITE
   }
 
@@ -126,6 +194,9 @@ TDOG_SUITE(timing_suite)
     // Register tests with local runner
     TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::local_timeout) ) );
 
+    // Runs on past its limit
+    tr.set_watchdog_exit(false);
+
     TDOG_ASSERT_EQ(1, tr.run()); // <- expect fails
   }
 
@@ -140,6 +211,9 @@ TDOG_SUITE(timing_suite)
     // Register tests with local runner
     TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::short_sleep) ) );
 
+    // Sleeps on past its limit
+    tr.set_watchdog_exit(false);
+
     TDOG_ASSERT_EQ(1, tr.run()); // <- expect fails
   }
 
@@ -154,6 +228,9 @@ TDOG_SUITE(timing_suite)
     // Register tests with local runner
     TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::long_sleep) ) );
 
+    // Sleeps on past its limit
+    tr.set_watchdog_exit(false);
+
     TDOG_ASSERT_EQ(1, tr.run()); // <- expect fails
   }
 
@@ -170,6 +247,9 @@ TDOG_SUITE(timing_suite)
 
     tr.set_global_time_limit(1000);
 
+    // Sleeps on past its limit
+    tr.set_watchdog_exit(false);
+
     TDOG_ASSERT_EQ(1, tr.run()); // <- expect fails
   }
 
@@ -214,6 +294,96 @@ TDOG_SUITE(timing_suite)
     TDOG_ASSERT_NEQ(NPOS, s.find("time warning threshold of 1000 ms exceeded"));
   }
 
+  TDOG_TEST_CASE(assert_loop)
+  {
+    // Time limit in a tight loop of asserts. Summary
+    // report only, as verbose would list every pass.
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_SUMMARY, "./reports/internal/timing_assert_loop.txt");
+
+    // Register tests with local runner
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::assert_loop) ) );
+
+    tr.set_global_time_limit(1000);
+
+    TDOG_ASSERT_EQ(1, tr.run()); // <- expect fail
+
+    // Must break out on the limit, rather than run to end
+    // of loop. Not bounded above, as the host may be loaded.
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(internal_suite::assert_loop);
+    TDOG_ASSERT_NOT(internal_suite::loop_ended);
+    TDOG_ASSERT_GTE(tc->helper().duration(), 1000);
+    TDOG_ASSERT_GTE(tc->helper().duration_ns(), tc->helper().duration() * 1000000);
+
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_SUMMARY);
+    TDOG_ASSERT_NEQ(NPOS, stm.str().find("global time constraint of 1000 ms exceeded"));
+  }
+
+  TDOG_TEST_CASE(watchdog_report)
+  {
+    // Hang in process is reported while running
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/timing_watchdog_report.txt");
+
+    // Register tests with local runner
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::hang) ) );
+
+    // Otherwise our own process would end
+    TDOG_ASSERT(tr.watchdog_exit());
+    tr.set_watchdog_exit(false);
+
+    // Capture stderr
+    std::stringstream err;
+    std::streambuf* old_buf = std::cerr.rdbuf(err.rdbuf());
+    int rslt = tr.run();
+    std::cerr.rdbuf(old_buf);
+
+    TDOG_ASSERT_EQ(1, rslt); // <- expect fail
+    TDOG_ASSERT_NEQ(NPOS, err.str().find("TDOG WATCHDOG: timing_suite::internal_suite::hang"));
+    TDOG_ASSERT_NEQ(NPOS, err.str().find("time constraint of 200 ms"));
+
+    // Snapshot taken by default
+    TDOG_ASSERT(tr.watchdog_stacks());
+#if defined(__GLIBC__)
+    TDOG_ASSERT_NEQ(NPOS, err.str().find("stack snapshot"));
+#endif
+  }
+
+  TDOG_TEST_CASE(watchdog_isolated)
+  {
+    // Hang in worker process is terminated
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/timing_watchdog_isolated.txt");
+
+    // Register tests with local runner
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::hang) ) );
+
+    tr.set_isolated(true);
+
+    if (!tr.isolated())
+    {
+      TDOG_PRINT("Process isolation not supported on this platform");
+      return;
+    }
+
+    TDOG_ASSERT_EQ(1, tr.run()); // <- expect fail
+
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(internal_suite::hang);
+    TDOG_ASSERT_EQ(tdog::TS_FAILED, tc->helper().status());
+    TDOG_ASSERT_EQ(1, (int)tc->helper().event_log().size());
+    TDOG_ASSERT_NEQ(NPOS, tc->helper().event_log()[0].msg().find("time constraint exceeded"));
+
+    // Stopped, rather than left to finish
+    TDOG_ASSERT_NEQ(NPOS, tc->helper().event_log()[0].msg().find("terminated by watchdog"));
+  }
+
   TDOG_TEST_CASE(check_limit)
   {
     // Test sleep call with value more than 1 sec
@@ -237,6 +407,172 @@ TDOG_SUITE(timing_suite)
     TDOG_ASSERT_NEQ(NPOS, s.find("Exceed limit detected"));
   }
 
+  TDOG_TEST_CASE(hw_counters)
+  {
+    // Hardware counts, where the system permits
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/timing_hw_counters.txt");
+
+    // Register tests with local runner
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::count_loop) ) );
+
+    // Off by default
+    TDOG_ASSERT( !tr.hw_counters() );
+    TDOG_ASSERT_EQ(0, tr.run());
+
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(internal_suite::count_loop);
+    TDOG_ASSERT( !tc->helper().counts().valid() );
+    TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_CYCLES, "*"));
+
+    tr.set_hw_counters(true);
+    TDOG_ASSERT_EQ(0, tr.run()); // <- must not fail either way
+
+    std::stringstream txt, xml;
+    tr.generate_report(txt, tdog::RS_TEXT_VERBOSE);
+    tr.generate_report(xml, tdog::RS_XML);
+
+    const tdog::hw_counts& hc = tc->helper().counts();
+
+    if (hc.valid())
+    {
+      TDOG_PRINTF("Counters read, instructions: %d", hc.instructions);
+      TDOG_ASSERT_GT(hc.instructions, 100000);
+      TDOG_ASSERT_EQ(hc.instructions, tr.statistic_count(tdog::CNT_INSTRUCTIONS, "*"));
+      TDOG_ASSERT_EQ(hc.instructions, tr.statistic_count(tdog::CNT_INSTRUCTIONS,
+        "timing_suite::internal_suite::count_loop"));
+      TDOG_ASSERT_NEQ(NPOS, txt.str().find("COUNTERS: cycles "));
+      TDOG_ASSERT_NEQ(NPOS, xml.str().find("<property name=\"hw.instructions\""));
+    }
+    else
+    {
+      TDOG_PRINT("Counters not permitted on this system");
+      TDOG_ASSERT_EQ(0, tr.statistic_count(tdog::CNT_INSTRUCTIONS, "*"));
+      TDOG_ASSERT_EQ(NPOS, txt.str().find("COUNTERS: "));
+    }
+
+    // Summary report does not give them
+    std::stringstream sum;
+    tr.generate_report(sum, tdog::RS_TEXT_SUMMARY);
+    TDOG_ASSERT_EQ(NPOS, sum.str().find("COUNTERS: "));
+  }
+
+  TDOG_TEST_CASE(benchmark)
+  {
+    // Benchmark figures in all reports
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/timing_benchmark.txt");
+
+    // Register tests with local runner
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::bench_sum) ) );
+
+    TDOG_ASSERT_EQ(0, tr.run()); // <- expect success
+
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(internal_suite::bench_sum);
+    const tdog::bench_result& b = tc->helper().bench();
+    TDOG_ASSERT_EQ(tdog::TT_BENCHMARK, tc->test_type());
+    TDOG_ASSERT_GTE(b.samples, 5);
+    TDOG_ASSERT_GT(b.batch, 1);
+    TDOG_ASSERT_GT(b.median_ns, 0.0);
+    TDOG_ASSERT_GTE(b.p90_ns, b.median_ns);
+    TDOG_ASSERT_GTE(b.p99_ns, b.p90_ns);
+    TDOG_ASSERT_GT(b.ops_per_sec(), 0.0);
+
+    // Pass of first iteration only
+    TDOG_ASSERT_EQ(1, (int)tc->helper().event_log().size());
+    TDOG_ASSERT_EQ(1, tc->helper().event_log()[0].repeat);
+
+    std::stringstream txt, xml, html;
+    tr.generate_report(txt, tdog::RS_TEXT_SUMMARY);
+    tr.generate_report(xml, tdog::RS_XML);
+    tr.generate_report(html, tdog::RS_HTML_SUMMARY);
+
+    TDOG_ASSERT_NEQ(NPOS, txt.str().find("BENCHMARK: median "));
+    TDOG_ASSERT_NEQ(NPOS, txt.str().find(" ops/sec"));
+    TDOG_ASSERT_NEQ(NPOS, xml.str().find("<property name=\"bench.median_ns\""));
+    TDOG_ASSERT_NEQ(NPOS, xml.str().find("<property name=\"bench.ops_per_sec\""));
+    TDOG_ASSERT_NEQ(NPOS, html.str().find("Benchmark Results"));
+  }
+
+  TDOG_TEST_CASE(benchmark_baseline)
+  {
+    // Comparison with stored timings
+    TDOG_SET_AUTHOR("Kuiper");
+
+    const std::string fname = "./reports/internal/timing_baseline.txt";
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(internal_suite::bench_sum);
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/timing_benchmark_baseline.txt");
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::bench_sum) ) );
+
+    tr.set_baseline_file(fname);
+    TDOG_ASSERT_EQ(fname, tr.baseline_file());
+
+    // No baseline - recorded
+    std::remove(fname.c_str());
+    TDOG_ASSERT_EQ(0, tr.run());
+    TDOG_ASSERT_EQ(tdog::TS_PASS_OK, tc->helper().status());
+
+    std::ifstream fs(fname.c_str());
+    std::string content((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+    fs.close();
+    TDOG_ASSERT_NEQ(NPOS, content.find("timing_suite::internal_suite::bench_sum\t"));
+
+    // Far slower than baseline
+    internal_suite::write_baseline(fname, 100, 0);
+    TDOG_ASSERT_EQ(1, tr.run());
+    TDOG_ASSERT_EQ(tdog::TS_FAILED, tc->helper().status());
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_FAILED));
+
+    std::stringstream stm;
+    tr.generate_report(stm, tdog::RS_TEXT_SUMMARY);
+    TDOG_ASSERT_NEQ(NPOS, stm.str().find("FAIL: benchmark regression: median +"));
+
+    // Borderline, with 60 of 100 samples faster
+    internal_suite::write_baseline(fname, 60, 40);
+    TDOG_ASSERT_EQ(0, tr.run());
+    TDOG_ASSERT_EQ(tdog::TS_PASS_WARN, tc->helper().status());
+    TDOG_ASSERT_EQ(1, tr.statistic_count(tdog::CNT_WARNINGS));
+
+    // Faster than baseline
+    internal_suite::write_baseline(fname, 0, 100);
+    TDOG_ASSERT_EQ(0, tr.run());
+    TDOG_ASSERT_EQ(tdog::TS_PASS_OK, tc->helper().status());
+
+    // Update replaces baseline
+    internal_suite::write_baseline(fname, 100, 0);
+    tr.set_baseline_update(true);
+    TDOG_ASSERT_EQ(0, tr.run());
+    TDOG_ASSERT_EQ(tdog::TS_PASS_OK, tc->helper().status());
+
+    fs.open(fname.c_str());
+    content.assign((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+    TDOG_ASSERT_EQ(NPOS, content.find("\t0.001 "));
+  }
+
+  TDOG_TEST_CASE(benchmark_fail)
+  {
+    // Failing benchmark has no figures
+    TDOG_SET_AUTHOR("Kuiper");
+
+    tdog::runner tr(tdog::RS_NONE);
+    tr.add_report(tdog::RS_TEXT_VERBOSE, "./reports/internal/timing_benchmark_fail.txt");
+
+    // Register tests with local runner
+    TDOG_ASSERT( tr.register_test( TDOG_GET_TCPTR(internal_suite::bench_fail) ) );
+
+    TDOG_ASSERT_EQ(1, tr.run()); // <- expect fail
+
+    const tdog::basic_test* tc = TDOG_GET_TCPTR(internal_suite::bench_fail);
+    TDOG_ASSERT_EQ(tdog::TS_FAILED, tc->helper().status());
+    TDOG_ASSERT( !tc->helper().bench().valid() );
+    TDOG_ASSERT_EQ(1, tc->helper().fail_cnt());
+  }
+
   TDOG_CLOSE_SUITE
 }
 
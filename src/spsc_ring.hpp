@@ -0,0 +1,97 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : spsc_ring.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_SPSC_RING_H
+#define TDOG_SPSC_RING_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "thread_pool.hpp"
+
+#include <cstddef>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Fixed size, lock-free queue for exactly one producer thread and one
+// consumer thread. Each index is written by one side only, and the
+// barriers ensure an item is complete before the other side sees it.
+// Indexes are free running, so the count is simply tail - head.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS spsc_ring
+//---------------------------------------------------------------------------
+template <typename T>
+class spsc_ring
+{
+  private:
+
+  std::vector<T> m_buf;
+  std::size_t m_mask;
+  volatile std::size_t m_head;  // <- next to pop, written by consumer
+  volatile std::size_t m_tail;  // <- next to push, written by producer
+
+  // No copy
+  spsc_ring(const spsc_ring&);
+  spsc_ring& operator=(const spsc_ring&);
+
+  public:
+
+  // Capacity is rounded up to a power of 2
+  spsc_ring(std::size_t cap) : m_head(0), m_tail(0)
+  {
+    std::size_t sz = 2;
+    while(sz < cap) sz <<= 1;
+    m_buf.resize(sz);
+    m_mask = sz - 1;
+  }
+
+  // Producer only. False if full.
+  bool push(const T& v)
+  {
+    std::size_t t = m_tail;
+    if (t - m_head > m_mask) return false;
+
+    m_buf[t & m_mask] = v;
+    memory_barrier();
+    m_tail = t + 1;
+    return true;
+  }
+
+  // Consumer only. False if empty.
+  bool pop(T& v)
+  {
+    std::size_t h = m_head;
+    if (h == m_tail) return false;
+
+    memory_barrier();
+    v = m_buf[h & m_mask];
+    memory_barrier();
+    m_head = h + 1;
+    return true;
+  }
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
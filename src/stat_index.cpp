@@ -0,0 +1,302 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : stat_index.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "stat_index.hpp"
+#include "test_list.hpp"
+#include "name_matcher.hpp"
+#include "tdog/private/basic_test.hpp"
+#include "tdog/private/suite_manager.hpp"
+
+#include <algorithm>
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+//---------------------------------------------------------------------------
+// CLASS stat_totals : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+stat_totals::stat_totals()
+{
+  // Constructor
+  total = 0;
+  ran = 0;
+  passed = 0;
+  failed = 0;
+  errors = 0;
+  skipped = 0;
+  disabled = 0;
+  warnings = 0;
+  assert_total = 0;
+  assert_failed = 0;
+  duration = 0;
+  cycles = 0;
+  instructions = 0;
+  cache_misses = 0;
+  branch_misses = 0;
+}
+//---------------------------------------------------------------------------
+stat_totals stat_totals::of(const basic_test* tc)
+{
+  // Totals for a single test
+  stat_totals rslt;
+  const run_helper& h = tc->helper();
+  status_t status = h.status();
+
+  rslt.total = 1;
+  rslt.ran = h.has_ran() ? 1 : 0;
+  rslt.passed = h.has_passed() ? 1 : 0;
+  rslt.failed = (status == TS_FAILED) ? 1 : 0;
+  rslt.errors = (status == TS_ERROR) ? 1 : 0;
+  rslt.skipped = (status == TS_SKIPPED) ? 1 : 0;
+  rslt.disabled = (status == TS_DISABLED) ? 1 : 0;
+  rslt.warnings = (status == TS_PASS_WARN) ? 1 : 0;
+  rslt.assert_total = h.assert_cnt();
+  rslt.assert_failed = h.fail_cnt();
+  rslt.duration = h.duration();
+
+  // Counts not taken are -1
+  const hw_counts& hc = h.counts();
+  rslt.cycles = std::max(hc.cycles, tdog::i64_t(0));
+  rslt.instructions = std::max(hc.instructions, tdog::i64_t(0));
+  rslt.cache_misses = std::max(hc.cache_misses, tdog::i64_t(0));
+  rslt.branch_misses = std::max(hc.branch_misses, tdog::i64_t(0));
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
+void stat_totals::add(const stat_totals& other, int sign)
+{
+  // Add or subtract other
+  total += sign * other.total;
+  ran += sign * other.ran;
+  passed += sign * other.passed;
+  failed += sign * other.failed;
+  errors += sign * other.errors;
+  skipped += sign * other.skipped;
+  disabled += sign * other.disabled;
+  warnings += sign * other.warnings;
+  assert_total += sign * other.assert_total;
+  assert_failed += sign * other.assert_failed;
+  duration += sign * other.duration;
+  cycles += sign * other.cycles;
+  instructions += sign * other.instructions;
+  cache_misses += sign * other.cache_misses;
+  branch_misses += sign * other.branch_misses;
+}
+//---------------------------------------------------------------------------
+tdog::i64_t stat_totals::get(stat_count_t type) const
+{
+  // Value of statistic
+  switch(type)
+  {
+    case CNT_TOTAL: return total;
+    case CNT_RAN: return ran;
+    case CNT_PASSED: return passed;
+    case CNT_FAILED: return failed;
+    case CNT_ERRORS: return errors;
+    case CNT_SKIPPED: return skipped;
+    case CNT_DISABLED: return disabled;
+    case CNT_WARNINGS: return warnings;
+    case CNT_ASSERT_TOTAL: return assert_total;
+    case CNT_ASSERT_FAILED: return assert_failed;
+    case CNT_DURATION: return duration;
+    case CNT_CYCLES: return cycles;
+    case CNT_INSTRUCTIONS: return instructions;
+    case CNT_CACHE_MISSES: return cache_misses;
+    case CNT_BRANCH_MISSES: return branch_misses;
+    case CNT_PASS_RATE:
+      if (ran > 0) return (100 * passed) / ran;
+      else return 0;
+    default: return -1;
+  }
+}
+//---------------------------------------------------------------------------
+// CLASS stat_index : PRIVATE MEMBERS
+//---------------------------------------------------------------------------
+void stat_index::_clear()
+{
+  // Index must be rebuilt before use
+  m_valid = false;
+  m_all = stat_totals();
+  m_suites.clear();
+  m_tests.clear();
+  m_helpers.clear();
+  m_running.clear();
+}
+//---------------------------------------------------------------------------
+void stat_index::_apply(const std::string& sname, const stat_totals& st, int sign)
+{
+  // Add to suite, and to the tree totals of the suite
+  // and each parent, i.e. "a::b::c", "a::b" and "a".
+  m_all.add(st, sign);
+  m_suites[sname].direct.add(st, sign);
+
+  std::size_t pos = sname.size();
+
+  while(pos != std::string::npos && pos > 0)
+  {
+    m_suites[sname.substr(0, pos)].tree.add(st, sign);
+    pos = (pos > 1) ? sname.rfind(NSSEP, pos - 1) : std::string::npos;
+  }
+}
+//---------------------------------------------------------------------------
+void stat_index::_replace(entry& e)
+{
+  // Replace totals of entry with current results
+  const basic_test* tc = e.test;
+
+  stat_totals st = stat_totals::of(tc);
+  _apply(tc->suite_name(), e.totals, -1);
+  _apply(tc->suite_name(), st, 1);
+  e.totals = st;
+
+  if (tc->helper().running()) m_running.insert(&e);
+  else m_running.erase(&e);
+}
+//---------------------------------------------------------------------------
+void stat_index::_rebuild(const test_list& list)
+{
+  // Index all tests. Changes from here on are read
+  // on refresh, so those made meanwhile are not lost.
+  _clear();
+  m_changed.clear();
+  run_helper::changed_since(m_seq, m_changed);
+
+  for(std::size_t n = 0; n < list.size(); ++n)
+  {
+    const basic_test* tc = list.get(n);
+    entry& e = m_tests[tc->full_name()];
+
+    e.test = tc;
+    e.totals = stat_totals::of(tc);
+    _apply(tc->suite_name(), e.totals, 1);
+
+    m_helpers[&tc->helper()] = &e;
+    if (tc->helper().running()) m_running.insert(&e);
+  }
+
+  m_valid = true;
+}
+//---------------------------------------------------------------------------
+void stat_index::_refresh()
+{
+  // Re-read tests changed since, i.e. by another runner,
+  // and those running. Where changes were dropped, all.
+  m_changed.clear();
+
+  if (!run_helper::changed_since(m_seq, m_changed))
+  {
+    for(test_map_t::iterator it = m_tests.begin(); it != m_tests.end(); ++it)
+    {
+      _replace(it->second);
+    }
+
+    return;
+  }
+
+  std::vector<entry*> run(m_running.begin(), m_running.end());
+
+  for(std::size_t n = 0; n < run.size(); ++n)
+  {
+    _replace(*run[n]);
+  }
+
+  for(std::size_t n = 0; n < m_changed.size(); ++n)
+  {
+    helper_map_t::iterator it = m_helpers.find(m_changed[n]);
+    if (it != m_helpers.end()) _replace(*it->second);
+  }
+}
+//---------------------------------------------------------------------------
+bool stat_index::_lookup(const name_matcher& filter, stat_count_t type,
+  tdog::i64_t& rslt_out) const
+{
+  // Answer query from index, where a single pattern
+  std::size_t pcnt = filter.names().size() + filter.suites().size() +
+    filter.trees().size();
+
+  if (filter.all())
+  {
+    rslt_out = m_all.get(type);
+    return true;
+  }
+
+  if (pcnt == 0)
+  {
+    // Nothing matches
+    rslt_out = stat_totals().get(type);
+    return true;
+  }
+
+  if (pcnt != 1) return false;
+
+  if (!filter.names().empty())
+  {
+    test_map_t::const_iterator it = m_tests.find(*filter.names().begin());
+    rslt_out = (it != m_tests.end()) ? it->second.totals.get(type) : stat_totals().get(type);
+    return true;
+  }
+
+  bool tree = filter.suites().empty();
+  const std::string& sname = tree ? *filter.trees().begin() : *filter.suites().begin();
+  suite_map_t::const_iterator it = m_suites.find(sname);
+
+  if (it == m_suites.end()) rslt_out = stat_totals().get(type);
+  else rslt_out = tree ? it->second.tree.get(type) : it->second.direct.get(type);
+
+  return true;
+}
+//---------------------------------------------------------------------------
+// CLASS stat_index : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+stat_index::stat_index()
+{
+  // Constructor
+  m_valid = false;
+  m_seq = 0;
+}
+//---------------------------------------------------------------------------
+void stat_index::invalidate()
+{
+  scoped_lock lock(m_mutex);
+  _clear();
+}
+//---------------------------------------------------------------------------
+void stat_index::rebuild(const test_list& list)
+{
+  scoped_lock lock(m_mutex);
+  _rebuild(list);
+}
+//---------------------------------------------------------------------------
+void stat_index::update(const basic_test* tc)
+{
+  // Replace previous totals for test
+  scoped_lock lock(m_mutex);
+  if (!m_valid) return;
+
+  test_map_t::iterator it = m_tests.find(tc->full_name());
+  if (it != m_tests.end()) _replace(it->second);
+}
+//---------------------------------------------------------------------------
+bool stat_index::query(const test_list& list, const name_matcher& filter,
+  stat_count_t type, tdog::i64_t& rslt_out)
+{
+  // Bring index up to date, and answer from it
+  scoped_lock lock(m_mutex);
+
+  if (!m_valid) _rebuild(list);
+  else _refresh();
+
+  return _lookup(filter, type, rslt_out);
+}
+//---------------------------------------------------------------------------
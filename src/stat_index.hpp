@@ -0,0 +1,161 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : stat_index.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_STAT_INDEX_H
+#define TDOG_STAT_INDEX_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+#include "tdog/types.hpp"
+#include "thread_pool.hpp"
+
+#include <string>
+#include <map>
+#include <set>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Statistics held in aggregate, so that runner::statistic_count() need
+// not scan every test. Totals are kept for each test, for the tests
+// directly in each suite, and for each suite together with its nested
+// suites. When a test's results change, its previous contribution is
+// replaced in its own suite and each parent, so an update costs O(depth).
+// A query for "*", "suite::", "suite::*" or a full test name is a single
+// lookup. Other patterns are not answered, and the caller should scan.
+//
+// The runner rebuilds the index when the list of tests changes, and
+// updates it as each test completes. Tests are shared, however, and
+// their results may also be changed by another runner. Before a query,
+// the index therefore re-reads tests posted as changed since, in any
+// runner (see run_helper::changed_since()), and those running. This is
+// O(changed), and nothing where none have. Where changes have been
+// dropped, all tests are re-read. Queries may come from tests running
+// concurrently, so the index is guarded by a mutex.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+// Forward declarations
+class basic_test;
+class run_helper;
+class test_list;
+class name_matcher;
+
+// Statistics for one or more tests
+struct stat_totals
+{
+  tdog::i64_t total;
+  tdog::i64_t ran;
+  tdog::i64_t passed;
+  tdog::i64_t failed;
+  tdog::i64_t errors;
+  tdog::i64_t skipped;
+  tdog::i64_t disabled;
+  tdog::i64_t warnings;
+  tdog::i64_t assert_total;
+  tdog::i64_t assert_failed;
+  tdog::i64_t duration;
+  tdog::i64_t cycles;
+  tdog::i64_t instructions;
+  tdog::i64_t cache_misses;
+  tdog::i64_t branch_misses;
+
+  stat_totals();
+
+  // Totals for a single test
+  static stat_totals of(const basic_test* tc);
+
+  // Add or subtract other
+  void add(const stat_totals& other, int sign);
+
+  // Value of statistic, or -1 if type is unknown
+  tdog::i64_t get(stat_count_t type) const;
+};
+
+//---------------------------------------------------------------------------
+// CLASS stat_index
+//---------------------------------------------------------------------------
+class stat_index
+{
+  private:
+
+  struct node
+  {
+    stat_totals direct; // <- tests in suite
+    stat_totals tree;   // <- and in nested suites
+  };
+
+  struct entry
+  {
+    const basic_test* test;
+    stat_totals totals;
+  };
+
+  typedef std::map<std::string, node> suite_map_t;
+  typedef std::map<std::string, entry> test_map_t;
+  typedef std::map<const run_helper*, entry*> helper_map_t;
+
+  mutex m_mutex;
+  bool m_valid;
+  tdog::u64_t m_seq;            // <- changes read up to
+  stat_totals m_all;
+  suite_map_t m_suites;
+  test_map_t m_tests;
+  helper_map_t m_helpers;
+  std::set<entry*> m_running;   // <- duration still changing
+  std::vector<const run_helper*> m_changed;
+
+  // No copy
+  stat_index(const stat_index&);
+  stat_index& operator=(const stat_index&);
+
+  void _clear();
+  void _apply(const std::string& sname, const stat_totals& st, int sign);
+  void _replace(entry& e);
+  void _rebuild(const test_list& list);
+  void _refresh();
+  bool _lookup(const name_matcher& filter, stat_count_t type,
+    tdog::i64_t& rslt_out) const;
+
+  public:
+
+  stat_index();
+
+  // Index must be rebuilt before use
+  void invalidate();
+
+  // Index all tests in list
+  void rebuild(const test_list& list);
+
+  // Replace totals of test with its current results.
+  // Does nothing if the index is not valid.
+  void update(const basic_test* tc);
+
+  // Answer query for pattern, indexing list first if need
+  // be. Returns false if it cannot answer for the pattern.
+  bool query(const test_list& list, const name_matcher& filter,
+    stat_count_t type, tdog::i64_t& rslt_out);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
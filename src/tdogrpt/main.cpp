@@ -0,0 +1,152 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : main.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include <tdog.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Generates a report from a results file written by runner::save_results(),
+// without running the tests. Usage:
+//
+//   tdogrpt [--style s] [--out file] [--save file] [--iffail] resultfile...
+//
+// Where style is one of "text", "textv", "html", "htmlv" or "xml", the
+// default being "text". The report is written to STDOUT unless a file is
+// given. With "--iffail", a report is written only if any test failed or
+// had an error. Where several results files are given, i.e. one from each
+// shard of a run, they are merged into a single report. The merged results
+// may also be written to a single results file with "--save". The exit code
+// is 0 where all tests passed, 1 where any failed, and 2 if a results file
+// could not be read.
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+const int EXIT_PASSED = 0;
+const int EXIT_FAILED = 1;
+const int EXIT_INVALID = 2;
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+static bool _parse_style(const std::string& s, tdog::report_style_t& style)
+{
+  // Report style from name
+  if (s == "text") style = tdog::RS_TEXT_SUMMARY;
+  else if (s == "textv") style = tdog::RS_TEXT_VERBOSE;
+  else if (s == "html") style = tdog::RS_HTML_SUMMARY;
+  else if (s == "htmlv") style = tdog::RS_HTML_VERBOSE;
+  else if (s == "xml") style = tdog::RS_XML;
+  else return false;
+
+  return true;
+}
+//---------------------------------------------------------------------------
+static int _usage()
+{
+  std::cerr << "Usage: tdogrpt [--style text|textv|html|htmlv|xml] "
+    "[--out file] [--save file] [--iffail] resultfile...\n";
+  return EXIT_INVALID;
+}
+//---------------------------------------------------------------------------
+// MAIN FUNCTION
+//---------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  tdog::report_style_t style = tdog::RS_TEXT_SUMMARY;
+  std::string out_file;
+  std::string save_file;
+  std::vector<std::string> in_files;
+  bool if_fail = false;
+
+  for(int n = 1; n < argc; ++n)
+  {
+    std::string arg = argv[n];
+
+    if (arg == "--style" && n + 1 < argc)
+    {
+      if (!_parse_style(argv[++n], style)) return _usage();
+    }
+    else
+    if (arg == "--out" && n + 1 < argc)
+    {
+      out_file = argv[++n];
+    }
+    else
+    if (arg == "--save" && n + 1 < argc)
+    {
+      save_file = argv[++n];
+    }
+    else
+    if (arg == "--iffail")
+    {
+      if_fail = true;
+    }
+    else
+    if (arg.substr(0, 1) != "-")
+    {
+      in_files.push_back(arg);
+    }
+    else
+    {
+      return _usage();
+    }
+  }
+
+  if (in_files.empty()) return _usage();
+
+  tdog::runner tr(tdog::RS_NONE);
+
+  if (!tr.merge_results(in_files))
+  {
+    std::cerr << "tdogrpt: cannot read results file(s)\n";
+    return EXIT_INVALID;
+  }
+
+  if (!save_file.empty() && !tr.save_results(save_file))
+  {
+    std::cerr << "tdogrpt: cannot write file: " << save_file << "\n";
+    return EXIT_INVALID;
+  }
+
+  bool failed = tr.statistic_count(tdog::CNT_FAILED, "*") != 0 ||
+    tr.statistic_count(tdog::CNT_ERRORS, "*") != 0;
+
+  if (!if_fail || failed)
+  {
+    if (out_file.empty())
+    {
+      tr.generate_report(std::cout, style);
+    }
+    else
+    {
+      std::ofstream fs(out_file.c_str());
+
+      if (!fs.is_open())
+      {
+        std::cerr << "tdogrpt: cannot write file: " << out_file << "\n";
+        return EXIT_INVALID;
+      }
+
+      tr.generate_report(fs, style);
+    }
+  }
+
+  return failed ? EXIT_FAILED : EXIT_PASSED;
+}
+//---------------------------------------------------------------------------
@@ -43,16 +43,20 @@ bool test_list::sort_functor::operator()(const basic_test* a, const basic_test*
   // ::suiteA::teardown
   // ::teardown
 
-  bool setup_a = a->is_setup();
-  bool setup_b = b->is_setup();
-  bool teardown_a = a->is_teardown();
-  bool teardown_b = b->is_teardown();
-  std::string sname_a = a->suite_name();
-  std::string sname_b = b->suite_name();
-  std::string tname_a = a->test_name();
-  std::string tname_b = b->test_name();
-  std::string tname_lwr_a = ascii_lower(tname_a);
-  std::string tname_lwr_b = ascii_lower(tname_b);
+  // Names and keys are held by the tests, so
+  // nothing here should allocate.
+  const basic_test::sort_key& key_a = a->key();
+  const basic_test::sort_key& key_b = b->key();
+  bool setup_a = (key_a.rank == 0);
+  bool setup_b = (key_b.rank == 0);
+  bool teardown_a = (key_a.rank == 2);
+  bool teardown_b = (key_b.rank == 2);
+  const std::string& sname_a = a->suite_name();
+  const std::string& sname_b = b->suite_name();
+  const std::string& tname_a = a->test_name();
+  const std::string& tname_b = b->test_name();
+  const std::string& tname_lwr_a = key_a.name_lower;
+  const std::string& tname_lwr_b = key_b.name_lower;
 
   // Sort teardown
   if (teardown_a || teardown_b)
@@ -74,13 +78,13 @@ bool test_list::sort_functor::operator()(const basic_test* a, const basic_test*
       else return (tname_a < tname_b);
     }
 
-    if (teardown_a && sname_b.substr(0, sname_a.size()) == sname_a) return false;
-    if (teardown_b && sname_a.substr(0, sname_b.size()) == sname_b) return true;
+    if (teardown_a && sname_b.compare(0, sname_a.size(), sname_a) == 0) return false;
+    if (teardown_b && sname_a.compare(0, sname_b.size(), sname_b) == 0) return true;
   }
 
   // Sort suite different names
-  std::string sname_lwr_a = ascii_lower(sname_a);
-  std::string sname_lwr_b = ascii_lower(sname_b);
+  const std::string& sname_lwr_a = key_a.suite_lower;
+  const std::string& sname_lwr_b = key_b.suite_lower;
 
   if (sname_lwr_a != sname_lwr_b) return (sname_lwr_a < sname_lwr_b);
   if (sname_a != sname_b) return (sname_a < sname_b);
@@ -108,34 +112,124 @@ bool test_list::sort_functor::operator()(const basic_test* a, const basic_test*
 //---------------------------------------------------------------------------
 // CLASS test_list : PUBLIC MEMBERS
 //---------------------------------------------------------------------------
-void test_list::sort(bool full)
+test_list::test_list()
 {
-  // Sorts the list. The default suite will always be sorted first.
-  // Additionally, within a suite, a test beginning "setup" or "_setup"
-  // will always be sorted first, and tests beginning "_teardown" or
-  // "_TEARDOWN" will be sorted last. Otherwise, if full is false,
+  // Constructor
+  m_order_mode = -1;
+}
+//---------------------------------------------------------------------------
+const std::vector<basic_test*>& test_list::ordered(bool full) const
+{
+  // Returns tests in run order. The default suite will always be sorted
+  // first. Additionally, within a suite, a test beginning "setup" or
+  // "_setup" will always be sorted first, and tests beginning "_teardown"
+  // or "_TEARDOWN" will be sorted last. Otherwise, if full is false,
   // the suite and test names will remain unsorted. If full is true,
   // the list will be sorted according to suite and test names is
   // ordinal order.
-  sort_functor sort_fn;
-  sort_fn.full_sort = full;
-  std::stable_sort(storage.begin(), storage.end(), sort_fn);
+  int mode = full ? 1 : 0;
+
+  if (m_order_mode != mode)
+  {
+    sort_functor sort_fn;
+    sort_fn.full_sort = full;
+    m_order = m_storage;
+    std::stable_sort(m_order.begin(), m_order.end(), sort_fn);
+    m_order_mode = mode;
+  }
+
+  return m_order;
 }
 //---------------------------------------------------------------------------
 basic_test* test_list::find(const std::string& full_name, bool precise) const
 {
   // Find test case and return pointer. If precise is true,
-  // then name must match the full test name.
+  // then name must match the full test name. Otherwise, the
+  // first test matching as for basic_test::name_equals()
+  // is returned.
+  const std::size_t NSZ = std::string(NSSEP).size();
+  const std::string XSFX = std::string(NSSEP) + "*";
+
   std::string tn = trim_str(full_name);
 
-  for(std::size_t n = 0; n < storage.size(); ++n)
+  if (tn.empty() || m_storage.empty()) return 0;
+  if (tn == "*" || tn == XSFX) return precise ? 0 : m_storage[0];
+
+  if (tn.size() > NSZ && tn.substr(0, NSZ) == NSSEP)
+  {
+    // Remove leading "::"
+    tn.erase(0, NSZ);
+  }
+
+  index_t::const_iterator it;
+
+  if (!precise)
   {
-    if (storage[n]->name_equals(tn, precise))
+    if (is_suffix(tn, NSSEP))
+    {
+      // Tests directly in suite
+      tn.erase(tn.size() - NSZ, NSZ);
+      it = m_suite_index.find(tn);
+      return (it != m_suite_index.end()) ? m_storage[it->second] : 0;
+    }
+    else
+    if (is_suffix(tn, XSFX))
     {
-      return storage[n];
+      // Suite itself, and all those nested under it
+      tn.erase(tn.size() - 1, 1);
+      std::size_t pos = m_storage.size();
+
+      it = m_suite_index.find(tn.substr(0, tn.size() - NSZ));
+      if (it != m_suite_index.end()) pos = it->second;
+
+      for(it = m_suite_index.lower_bound(tn); it != m_suite_index.end() &&
+        it->first.compare(0, tn.size(), tn) == 0; ++it)
+      {
+        if (it->first.size() > tn.size() && it->second < pos) pos = it->second;
+      }
+
+      return (pos < m_storage.size()) ? m_storage[pos] : 0;
     }
   }
 
-  return 0;
+  // Full test name
+  it = m_name_index.find(tn);
+  return (it != m_name_index.end()) ? m_storage[it->second] : 0;
+}
+//---------------------------------------------------------------------------
+test_list::~test_list()
+{
+  // Destructor
+  clear();
+}
+//---------------------------------------------------------------------------
+void test_list::clear()
+{
+  for(std::size_t n = 0; n < m_owned.size(); ++n) delete m_owned[n];
+
+  m_owned.clear();
+  m_storage.clear();
+  m_name_index.clear();
+  m_suite_index.clear();
+  m_order.clear();
+  m_order_mode = -1;
+}
+//---------------------------------------------------------------------------
+basic_test* test_list::add(basic_test* ptr)
+{
+  // Suite index holds first position only
+  std::size_t pos = m_storage.size();
+  m_storage.push_back(ptr);
+  m_name_index[ptr->full_name()] = pos;
+  m_suite_index.insert(index_t::value_type(ptr->suite_name(), pos));
+
+  m_order_mode = -1;
+  return ptr;
+}
+//---------------------------------------------------------------------------
+basic_test* test_list::adopt(basic_test* ptr)
+{
+  m_owned.push_back(ptr);
+  return add(ptr);
 }
 //---------------------------------------------------------------------------
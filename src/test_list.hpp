@@ -17,11 +17,17 @@
 //---------------------------------------------------------------------------
 #include <string>
 #include <vector>
+#include <map>
 
 //---------------------------------------------------------------------------
 // DOCUMENTATION
 //---------------------------------------------------------------------------
 
+// List of test cases in registration order, indexed on full test name
+// and suite name so that find() does not need to scan the list. The
+// sorted run order is computed on demand, and cached until the list
+// is next changed.
+
 //---------------------------------------------------------------------------
 // DECLARATIONS
 //---------------------------------------------------------------------------
@@ -46,20 +52,42 @@ class test_list
     bool operator()(const basic_test* a, const basic_test* b) const;
   };
 
+  typedef std::map<std::string, std::size_t> index_t;
+
+  std::vector<basic_test*> m_storage;
+  std::vector<basic_test*> m_owned;
+  index_t m_name_index;
+  index_t m_suite_index; // <- first position of each suite
+
+  // Cached run order. Mode is -1 where invalid,
+  // otherwise 0 for partial sort or 1 for full.
+  mutable std::vector<basic_test*> m_order;
+  mutable int m_order_mode;
+
   public:
 
-  // Test list storage. Objects
-  // will be deleted on destruction.
-  std::vector<basic_test*> storage;
+  test_list();
+  ~test_list();
+
+  // Tests in run order. Reference is valid
+  // until the list is next changed.
+  const std::vector<basic_test*>& ordered(bool full) const;
 
-  void sort(bool full);
   basic_test* find(const std::string& name, bool precise) const;
 
+  // Does not destroy objects, other than those adopted
+  void clear();
+
+  // Caller must ensure name is unique
+  basic_test* add(basic_test* ptr);
+
+  // As add(), but the list takes ownership, i.e.
+  // of tests created when loading results.
+  basic_test* adopt(basic_test* ptr);
+
   // Convenience
-  inline void clear() { storage.clear(); } // <- does not destroy objects
-  inline basic_test* add(basic_test* ptr) { storage.push_back(ptr); return ptr; }
-  inline basic_test* get(std::size_t n) const { return storage[n]; }
-  inline std::size_t size() const { return storage.size(); }
+  inline basic_test* get(std::size_t n) const { return m_storage[n]; }
+  inline std::size_t size() const { return m_storage.size(); }
 
 };
 
@@ -14,6 +14,8 @@
 #include "tdog.hpp"
 #include "util.hpp"
 
+#include <algorithm>
+
 //---------------------------------------------------------------------------
 // NON-CLASS
 //---------------------------------------------------------------------------
@@ -40,6 +42,9 @@ const char* const USER_TYPE_LEADER = "USER TYPE: ";
 const char* const TEST_END_LEADER = "Completed in ";
 const char* const ASSERT_COUNT = "asserts ";
 const char* const FAIL_COUNT = "failures ";
+const char* const BENCH_LEADER = "BENCHMARK: ";
+const char* const COUNTS_LEADER = "COUNTERS: ";
+const char* const ALLOCS_LEADER = "ALLOCATIONS: ";
 const char* const SKIP_SECTION = "SKIPPED/DISABLED TESTS";
 const char* const STAT_SECTION = "STATISTICAL RESULTS";
 const char* const STAT_TOTAL_LEADER = "TOTAL: ";
@@ -153,7 +158,7 @@ void text_reporter::gen_start(std::ostream& os)
   if (!temp_str.empty()) os << PROJECT_VERSION_LEADER << temp_str << "\n";
 
   // Name and platform OS
-  os << PROJECT_HOST_LEADER << tdog::hostname() << "\n";
+  os << PROJECT_HOST_LEADER << owner().run_hostname() << "\n";
   os << PROJECT_PLATFORM_LEADER << TDOG_PLATOS << "\n";
 
   // Start time
@@ -229,10 +234,22 @@ void text_reporter::gen_test(std::ostream& os, const basic_test* tc)
     std::string tn_str;
     if (m_testname_leader) tn_str = tc->full_name() + TC_OUTPUT_SEP;
 
+    // Repeating block being written
+    std::size_t blk_first = 0, blk_last = 0;
+    int blk_left = 0;
+
     // Build a condition result string
     for(std::size_t n = 0; n < lsz; ++n)
     {
       eit = helper.event_log()[n];
+      std::string msg_str = eit.msg();
+
+      if (eit.block > 1 && blk_left == 0)
+      {
+        blk_first = n;
+        blk_last = std::min(n + eit.block, lsz) - 1;
+        blk_left = eit.cycles;
+      }
 
       // Write failures only or everything if verbose is true
       if (verbose() || (eit.item_type != ET_PASS && eit.item_type != ET_INFO))
@@ -241,22 +258,22 @@ void text_reporter::gen_test(std::ostream& os, const basic_test* tc)
         type_str = event_str(eit.item_type);
         line_str = type_str;
 
-        if (!type_str.empty() && !eit.msg_str.empty())
+        if (!type_str.empty() && !msg_str.empty())
         {
           // Build upto "FAIL: "
           line_str += ": ";
         }
 
-        if (!eit.msg_str.empty())
+        if (!msg_str.empty())
         {
           // Build upto "FAIL: fail message"
-          line_str += eit.msg_str;
+          line_str += msg_str;
         }
 
         if (eit.line_num > 0)
         {
           // Build upto "FAIL: fail message [368]"
-          if (!eit.msg_str.empty() || !type_str.empty())
+          if (!msg_str.empty() || !type_str.empty())
           {
             line_str += " ";
           }
@@ -266,10 +283,14 @@ void text_reporter::gen_test(std::ostream& os, const basic_test* tc)
 
         if (!line_str.empty())
         {
-          // EOL
-          result_str += tn_str + line_str + "\n";
+          // EOL, once for each repeat
+          line_str = tn_str + line_str + "\n";
+          for(int r = 0; r < eit.repeat; ++r) result_str += line_str;
         }
       }
+
+      // Block again, once for each cycle
+      if (blk_left > 0 && n == blk_last && --blk_left > 0) n = blk_first - 1;
     }
 
     // Write suite header (verbose only)
@@ -331,6 +352,22 @@ void text_reporter::gen_test(std::ostream& os, const basic_test* tc)
       os << ASSERT_COUNT << helper.assert_cnt() << ", ";
       os << FAIL_COUNT << helper.fail_cnt();
       os << "\n";
+
+      if (helper.counts().valid())
+      {
+        os << tn_str << COUNTS_LEADER << counts_str(helper.counts()) << "\n";
+      }
+
+      if (helper.allocs().valid())
+      {
+        os << tn_str << ALLOCS_LEADER << allocs_str(helper.allocs()) << "\n";
+      }
+    }
+
+    if (helper.bench().valid())
+    {
+      // Benchmark figures (always)
+      os << tn_str << BENCH_LEADER << bench_str(helper.bench()) << "\n";
     }
 
     // Final result
@@ -0,0 +1,382 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : thread_pool.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "thread_pool.hpp"
+#include "work_queue.hpp"
+
+#if defined(_MSC_VER) || defined(WINDOWS) || defined(_WINDOWS) || \
+  defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64)
+  #define TDOG_WINDOWS
+  #include <windows.h>
+  #include <process.h>
+#else
+  #include <pthread.h>
+  #include <errno.h>
+  #include <sys/time.h>
+#endif // defined(_MSC_VER) ...
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+#if defined(TDOG_WINDOWS)
+  typedef HANDLE thread_handle_t;
+#else
+  typedef pthread_t thread_handle_t;
+#endif
+
+// Thread entry argument
+struct worker_arg
+{
+  thread_pool* pool;
+  std::size_t id;
+};
+
+// Thread started by task_thread
+struct task_state
+{
+  thread_handle_t handle;
+  pool_task* task;
+};
+
+#if !defined(TDOG_WINDOWS)
+// POSIX notifier state
+struct notify_state
+{
+  pthread_mutex_t mx;
+  pthread_cond_t cv;
+  bool flag;
+};
+#endif
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+#if defined(TDOG_WINDOWS)
+static unsigned __stdcall _thread_entry(void* arg)
+{
+  // Windows thread entry
+  worker_arg* wa = static_cast<worker_arg*>(arg);
+  wa->pool->worker(wa->id);
+  return 0;
+}
+//---------------------------------------------------------------------------
+static unsigned __stdcall _task_entry(void* arg)
+{
+  // Windows task_thread entry
+  static_cast<task_state*>(arg)->task->run(0);
+  return 0;
+}
+#else
+extern "C" void* _tdog_thread_entry(void* arg)
+{
+  // POSIX thread entry
+  worker_arg* wa = static_cast<worker_arg*>(arg);
+  wa->pool->worker(wa->id);
+  return 0;
+}
+//---------------------------------------------------------------------------
+extern "C" void* _tdog_task_entry(void* arg)
+{
+  // POSIX task_thread entry
+  static_cast<task_state*>(arg)->task->run(0);
+  return 0;
+}
+#endif
+//---------------------------------------------------------------------------
+static bool _start_thread(thread_handle_t& h, worker_arg* arg)
+{
+  // Start thread, returns false on failure
+#if defined(TDOG_WINDOWS)
+  h = reinterpret_cast<HANDLE>(_beginthreadex(0, 0, _thread_entry, arg, 0, 0));
+  return (h != 0);
+#else
+  return (pthread_create(&h, 0, _tdog_thread_entry, arg) == 0);
+#endif
+}
+//---------------------------------------------------------------------------
+static bool _start_task(task_state* ts)
+{
+  // Start task_thread, returns false on failure
+#if defined(TDOG_WINDOWS)
+  ts->handle = reinterpret_cast<HANDLE>(_beginthreadex(0, 0, _task_entry, ts, 0, 0));
+  return (ts->handle != 0);
+#else
+  return (pthread_create(&ts->handle, 0, _tdog_task_entry, ts) == 0);
+#endif
+}
+//---------------------------------------------------------------------------
+static void _join_thread(thread_handle_t& h)
+{
+  // Wait for thread to finish
+#if defined(TDOG_WINDOWS)
+  WaitForSingleObject(h, INFINITE);
+  CloseHandle(h);
+#else
+  pthread_join(h, 0);
+#endif
+}
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+void tdog::memory_barrier()
+{
+  // Orders memory access either side of the call
+#if defined(TDOG_WINDOWS)
+  MemoryBarrier();
+#elif defined(__GNUC__)
+  __sync_synchronize();
+#else
+  // Locking a mutex implies a barrier
+  static mutex s_mx;
+  scoped_lock lock(s_mx);
+#endif
+}
+//---------------------------------------------------------------------------
+// CLASS mutex : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+mutex::mutex()
+{
+  // Constructor
+#if defined(TDOG_WINDOWS)
+  CRITICAL_SECTION* cs = new CRITICAL_SECTION;
+  InitializeCriticalSection(cs);
+  m_handle = cs;
+#else
+  pthread_mutex_t* mx = new pthread_mutex_t;
+  pthread_mutex_init(mx, 0);
+  m_handle = mx;
+#endif
+}
+//---------------------------------------------------------------------------
+mutex::~mutex()
+{
+  // Destructor
+#if defined(TDOG_WINDOWS)
+  CRITICAL_SECTION* cs = static_cast<CRITICAL_SECTION*>(m_handle);
+  DeleteCriticalSection(cs);
+  delete cs;
+#else
+  pthread_mutex_t* mx = static_cast<pthread_mutex_t*>(m_handle);
+  pthread_mutex_destroy(mx);
+  delete mx;
+#endif
+}
+//---------------------------------------------------------------------------
+void mutex::lock()
+{
+#if defined(TDOG_WINDOWS)
+  EnterCriticalSection(static_cast<CRITICAL_SECTION*>(m_handle));
+#else
+  pthread_mutex_lock(static_cast<pthread_mutex_t*>(m_handle));
+#endif
+}
+//---------------------------------------------------------------------------
+void mutex::unlock()
+{
+#if defined(TDOG_WINDOWS)
+  LeaveCriticalSection(static_cast<CRITICAL_SECTION*>(m_handle));
+#else
+  pthread_mutex_unlock(static_cast<pthread_mutex_t*>(m_handle));
+#endif
+}
+//---------------------------------------------------------------------------
+// CLASS notifier : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+notifier::notifier()
+{
+  // Constructor
+#if defined(TDOG_WINDOWS)
+  m_handle = CreateEvent(0, TRUE, FALSE, 0);
+#else
+  notify_state* ns = new notify_state;
+  pthread_mutex_init(&ns->mx, 0);
+  pthread_cond_init(&ns->cv, 0);
+  ns->flag = false;
+  m_handle = ns;
+#endif
+}
+//---------------------------------------------------------------------------
+notifier::~notifier()
+{
+  // Destructor
+#if defined(TDOG_WINDOWS)
+  if (m_handle != 0) CloseHandle(static_cast<HANDLE>(m_handle));
+#else
+  notify_state* ns = static_cast<notify_state*>(m_handle);
+  pthread_cond_destroy(&ns->cv);
+  pthread_mutex_destroy(&ns->mx);
+  delete ns;
+#endif
+}
+//---------------------------------------------------------------------------
+void notifier::notify()
+{
+#if defined(TDOG_WINDOWS)
+  if (m_handle != 0) SetEvent(static_cast<HANDLE>(m_handle));
+#else
+  notify_state* ns = static_cast<notify_state*>(m_handle);
+  pthread_mutex_lock(&ns->mx);
+  ns->flag = true;
+  pthread_cond_broadcast(&ns->cv);
+  pthread_mutex_unlock(&ns->mx);
+#endif
+}
+//---------------------------------------------------------------------------
+bool notifier::wait(int ms)
+{
+  // Timed wait
+  if (ms < 0) ms = 0;
+
+#if defined(TDOG_WINDOWS)
+  if (m_handle == 0) return false;
+  return (WaitForSingleObject(static_cast<HANDLE>(m_handle),
+    static_cast<DWORD>(ms)) == WAIT_OBJECT_0);
+#else
+  // Absolute time for pthread_cond_timedwait()
+  timeval tv;
+  gettimeofday(&tv, 0);
+
+  timespec until;
+  long usec = tv.tv_usec + (ms % 1000) * 1000L;
+  until.tv_sec = tv.tv_sec + (ms / 1000) + usec / 1000000;
+  until.tv_nsec = (usec % 1000000) * 1000;
+
+  notify_state* ns = static_cast<notify_state*>(m_handle);
+  pthread_mutex_lock(&ns->mx);
+
+  while(!ns->flag)
+  {
+    if (pthread_cond_timedwait(&ns->cv, &ns->mx, &until) == ETIMEDOUT) break;
+  }
+
+  bool rslt = ns->flag;
+  pthread_mutex_unlock(&ns->mx);
+  return rslt;
+#endif
+}
+//---------------------------------------------------------------------------
+// CLASS task_thread : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+task_thread::task_thread()
+{
+  // Constructor
+  m_handle = 0;
+}
+//---------------------------------------------------------------------------
+task_thread::~task_thread()
+{
+  // Destructor
+  join();
+}
+//---------------------------------------------------------------------------
+bool task_thread::start(pool_task& task)
+{
+  // Start thread
+  if (m_handle != 0) return false;
+
+  task_state* ts = new task_state;
+  ts->task = &task;
+
+  if (!_start_task(ts))
+  {
+    delete ts;
+    return false;
+  }
+
+  m_handle = ts;
+  return true;
+}
+//---------------------------------------------------------------------------
+void task_thread::join()
+{
+  // Wait for thread
+  if (m_handle != 0)
+  {
+    task_state* ts = static_cast<task_state*>(m_handle);
+    _join_thread(ts->handle);
+    delete ts;
+    m_handle = 0;
+  }
+}
+//---------------------------------------------------------------------------
+// CLASS thread_pool : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+thread_pool::thread_pool(int threads)
+{
+  // Constructor
+  m_threads = (threads > 1) ? threads : 1;
+  m_task = 0;
+  m_queue = 0;
+}
+//---------------------------------------------------------------------------
+int thread_pool::threads() const
+{
+  return m_threads;
+}
+//---------------------------------------------------------------------------
+void thread_pool::run(pool_task& task, std::size_t count,
+  const std::vector<tdog::i64_t>& costs)
+{
+  // Run all items
+  if (count == 0) return;
+
+  // No point having more threads than items,
+  // and the calling thread counts as one.
+  std::size_t wcnt = static_cast<std::size_t>(m_threads);
+  if (wcnt > count) wcnt = count;
+
+  work_queue queue(wcnt);
+  queue.seed(count, costs);
+
+  m_task = &task;
+  m_queue = &queue;
+
+  std::vector<worker_arg> args(wcnt);
+  std::vector<thread_handle_t> handles;
+  handles.reserve(wcnt);
+
+  for(std::size_t n = 1; n < wcnt; ++n)
+  {
+    thread_handle_t h;
+    args[n].pool = this;
+    args[n].id = n;
+
+    // On failure, we continue with the threads we have
+    // got. Their queues will be emptied by stealing.
+    if (!_start_thread(h, &args[n])) break;
+    handles.push_back(h);
+  }
+
+  // Calling thread does work too
+  worker(0);
+
+  for(std::size_t n = 0; n < handles.size(); ++n)
+  {
+    _join_thread(handles[n]);
+  }
+
+  m_task = 0;
+  m_queue = 0;
+}
+//---------------------------------------------------------------------------
+void thread_pool::worker(std::size_t id)
+{
+  // Process items until none left in any queue
+  std::size_t idx;
+
+  while(m_queue->take(id, idx))
+  {
+    m_task->run(idx);
+  }
+}
+//---------------------------------------------------------------------------
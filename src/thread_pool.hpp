@@ -0,0 +1,192 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : thread_pool.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_THREAD_POOL_H
+#define TDOG_THREAD_POOL_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+
+#include <cstddef>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Minimal portable threading support used by the runner to execute
+// test cases concurrently. Uses pthreads under POSIX, and native
+// threads under Windows. Declared here so that platform headers
+// are not exposed to the rest of the library.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+// Forward declarations
+class work_queue;
+
+// Full memory barrier, for lock-free structures
+void memory_barrier();
+
+//---------------------------------------------------------------------------
+// CLASS mutex
+//---------------------------------------------------------------------------
+class mutex
+{
+  private:
+
+  void* m_handle;
+
+  // No copy
+  mutex(const mutex&);
+  mutex& operator=(const mutex&);
+
+  public:
+
+  mutex();
+  ~mutex();
+
+  void lock();
+  void unlock();
+};
+
+//---------------------------------------------------------------------------
+// CLASS scoped_lock
+//---------------------------------------------------------------------------
+class scoped_lock
+{
+  private:
+
+  mutex& m_mutex;
+
+  // No copy
+  scoped_lock(const scoped_lock&);
+  scoped_lock& operator=(const scoped_lock&);
+
+  public:
+
+  scoped_lock(mutex& m) : m_mutex(m) { m_mutex.lock(); }
+  ~scoped_lock() { m_mutex.unlock(); }
+};
+
+//---------------------------------------------------------------------------
+// CLASS pool_task
+//---------------------------------------------------------------------------
+class pool_task
+{
+  public:
+
+  virtual ~pool_task() {}
+
+  // Called once for each item index. Must not throw.
+  virtual void run(std::size_t idx) = 0;
+};
+
+//---------------------------------------------------------------------------
+// CLASS notifier
+//---------------------------------------------------------------------------
+class notifier
+{
+  private:
+
+  void* m_handle;
+
+  // No copy
+  notifier(const notifier&);
+  notifier& operator=(const notifier&);
+
+  public:
+
+  notifier();
+  ~notifier();
+
+  // Set notified state, waking any waiter.
+  // The state is not reset once set.
+  void notify();
+
+  // Wait until notified, or for ms milliseconds.
+  // Returns true if notified.
+  bool wait(int ms);
+};
+
+//---------------------------------------------------------------------------
+// CLASS task_thread
+//---------------------------------------------------------------------------
+class task_thread
+{
+  private:
+
+  void* m_handle;
+
+  // No copy
+  task_thread(const task_thread&);
+  task_thread& operator=(const task_thread&);
+
+  public:
+
+  task_thread();
+  ~task_thread();
+
+  // Start thread calling task.run(0). Returns
+  // false on failure, or if already started.
+  bool start(pool_task& task);
+
+  // Wait for the thread to finish. Called
+  // by the destructor if not called before.
+  void join();
+};
+
+//---------------------------------------------------------------------------
+// CLASS thread_pool
+//---------------------------------------------------------------------------
+class thread_pool
+{
+  private:
+
+  int m_threads;
+  pool_task* m_task;
+  work_queue* m_queue;
+
+  // No copy
+  thread_pool(const thread_pool&);
+  thread_pool& operator=(const thread_pool&);
+
+  public:
+
+  thread_pool(int threads);
+
+  // Returns maximum number of threads
+  int threads() const;
+
+  // Calls task.run() for all indexes in the range [0, count),
+  // distributing them between worker threads. Blocks until
+  // all items are complete. The costs vector gives the expected
+  // cost of each item, or may be empty. Items are scheduled
+  // longest first, with idle workers stealing from busy ones.
+  // The calling thread is used as one of the workers.
+  void run(pool_task& task, std::size_t count,
+    const std::vector<tdog::i64_t>& costs = std::vector<tdog::i64_t>());
+
+  // Internal worker entry
+  void worker(std::size_t id);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
@@ -23,6 +23,7 @@
   #include <errno.h>
   #include <unistd.h>
   #include <sys/time.h>
+  #include <time.h>
   #include <signal.h>
   #ifdef _POSIX_PRIORITY_SCHEDULING
     // sched_yield()
@@ -349,6 +350,35 @@ tdog::i64_t tdog::msec_time()
   return rslt;
 }
 //---------------------------------------------------------------------------
+tdog::i64_t tdog::nsec_mono()
+{
+  // Returns a monotonic time in nanoseconds, for measuring
+  // intervals only. It does not jump with the wall clock,
+  // and under Linux is normally read without a syscall.
+  // Falls back to msec_time() where there is no such clock.
+#if defined(TDOG_WINDOWS)
+  static LARGE_INTEGER freq = {{0, 0}};
+  if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+
+  LARGE_INTEGER cnt;
+  if (freq.QuadPart > 0 && QueryPerformanceCounter(&cnt))
+  {
+    // Split to avoid overflow
+    tdog::i64_t f = freq.QuadPart;
+    tdog::i64_t c = cnt.QuadPart;
+    return (c / f) * 1000000000 + ((c % f) * 1000000000) / f;
+  }
+#elif defined(_POSIX_TIMERS) && (_POSIX_TIMERS > 0) && defined(CLOCK_MONOTONIC)
+  timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+  {
+    return static_cast<tdog::i64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  }
+#endif
+
+  return msec_time() * 1000000;
+}
+//---------------------------------------------------------------------------
 void tdog::msleep(int m)
 {
   // Sleep for number of milli seconds.
@@ -377,10 +407,14 @@ void tdog::msleep(int m)
 
       do
       {
+        // Resume with remaining time if interrupted
         errno = 0;
-        if (nanosleep(&req, &rem) < 0)
+        sleep_again = false;
+
+        if (nanosleep(&req, &rem) < 0 && errno == EINTR)
         {
-          sleep_again = (errno == EINTR);
+          req = rem;
+          sleep_again = true;
         }
       } while(sleep_again);
 #else
@@ -394,6 +428,22 @@ void tdog::msleep(int m)
   }
 }
 //---------------------------------------------------------------------------
+int tdog::cpu_count()
+{
+  // Number of online processors, or 1 if not known.
+  int rslt = 1;
+
+#if defined(TDOG_WINDOWS)
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  rslt = static_cast<int>(si.dwNumberOfProcessors);
+#elif defined(_SC_NPROCESSORS_ONLN)
+  rslt = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+
+  return (rslt > 0) ? rslt : 1;
+}
+//---------------------------------------------------------------------------
 std::string tdog::iso_time(tdog::i64_t t, bool utc)
 {
   // Returns ISO8601 local date/time as string of form: YYYY-MM-DD HH:MM:SS
@@ -45,7 +45,9 @@ std::string xml_esc(std::string s);
 bool is_suffix(const std::string& s, const std::string& sfx);
 std::string hostname();
 tdog::i64_t msec_time();
+tdog::i64_t nsec_mono();
 void msleep(int m);
+int cpu_count();
 std::string iso_time(tdog::i64_t, bool utc = false);
 std::string duration_str(tdog::i64_t t);
 
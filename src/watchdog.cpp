@@ -0,0 +1,347 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : watchdog.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "watchdog.hpp"
+#include "tdog/private/basic_test.hpp"
+#include "util.hpp"
+
+#include <iostream>
+#include <cstdlib>
+
+#if defined(_MSC_VER) || defined(WINDOWS) || defined(_WINDOWS) || \
+  defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64)
+  #define TDOG_WINDOWS
+  // _exit()
+  #include <process.h>
+#else
+  #include <unistd.h>
+  #include <pthread.h>
+  #include <signal.h>
+  #if defined(__GLIBC__)
+    // backtrace()
+    #include <execinfo.h>
+    #define TDOG_BACKTRACE
+  #endif
+#endif // defined(_MSC_VER) ...
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+// Poll interval
+const int WATCH_POLL_MS = 50;
+
+// Time allowed beyond the limit for the test to
+// notice itself, on its next assert or print.
+const tdog::i64_t WATCH_GRACE_MS = 500;
+
+#if defined(TDOG_BACKTRACE)
+
+// Stack snapshot, written by signal handler
+// in the thread being sampled. One at a time.
+const int SNAP_MAX = 64;
+static void* g_snap_buf[SNAP_MAX];
+static volatile sig_atomic_t g_snap_size = 0;
+static volatile sig_atomic_t g_snap_done = 0;
+static mutex g_snap_mutex;
+
+#endif // TDOG_BACKTRACE
+
+//---------------------------------------------------------------------------
+// INTERNAL ROUTINES
+//---------------------------------------------------------------------------
+#if defined(TDOG_BACKTRACE)
+extern "C" void _tdog_snap_handler(int)
+{
+  // Runs in the thread being sampled
+  g_snap_size = backtrace(g_snap_buf, SNAP_MAX);
+  g_snap_done = 1;
+}
+#endif
+//---------------------------------------------------------------------------
+static void* _current_thread()
+{
+  // Identity of calling thread, freed by _free_thread()
+#if defined(TDOG_WINDOWS)
+  return 0;
+#else
+  return new pthread_t(pthread_self());
+#endif
+}
+//---------------------------------------------------------------------------
+static void* _copy_thread(void* t)
+{
+  // Copy of thread identity, or null
+#if defined(TDOG_WINDOWS)
+  (void)t;
+  return 0;
+#else
+  return (t != 0) ? new pthread_t(*static_cast<pthread_t*>(t)) : 0;
+#endif
+}
+//---------------------------------------------------------------------------
+static void _free_thread(void* t)
+{
+#if !defined(TDOG_WINDOWS)
+  delete static_cast<pthread_t*>(t);
+#else
+  (void)t;
+#endif
+}
+//---------------------------------------------------------------------------
+static std::vector<std::string> _stack_snapshot(void* t)
+{
+  // Stack of the given thread, by signalling it to call
+  // backtrace(). The handler is installed only while we
+  // wait, so SIGUSR2 is otherwise left to the application.
+  std::vector<std::string> rslt;
+
+#if defined(TDOG_BACKTRACE)
+  if (t == 0) return rslt;
+
+  scoped_lock lock(g_snap_mutex);
+
+  struct sigaction sa, old_sa;
+  sa.sa_handler = _tdog_snap_handler;
+  sa.sa_flags = SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+
+  if (sigaction(SIGUSR2, &sa, &old_sa) != 0) return rslt;
+
+  g_snap_done = 0;
+  g_snap_size = 0;
+
+  if (pthread_kill(*static_cast<pthread_t*>(t), SIGUSR2) == 0)
+  {
+    // Wait briefly. The thread may have the signal blocked.
+    for(int n = 0; n < 50 && !g_snap_done; ++n) msleep(5);
+  }
+
+  if (g_snap_done)
+  {
+    sigaction(SIGUSR2, &old_sa, 0);
+  }
+
+  // Otherwise, the signal may still be pending, and our
+  // handler is left, as the default would end the process.
+
+  if (g_snap_done && g_snap_size > 0)
+  {
+    char** sym = backtrace_symbols(g_snap_buf, g_snap_size);
+
+    if (sym != 0)
+    {
+      // First two are handler and signal trampoline
+      for(int n = 2; n < g_snap_size; ++n) rslt.push_back(sym[n]);
+      std::free(sym);
+    }
+  }
+#else
+  (void)t;
+#endif
+
+  return rslt;
+}
+//---------------------------------------------------------------------------
+// CLASS watchdog : PRIVATE MEMBERS
+//---------------------------------------------------------------------------
+void watchdog::_check()
+{
+  // Look for tests past their limit. Hangs are reported
+  // after the lock is released, as a snapshot may take
+  // a while, and tests would not enter or leave meanwhile.
+  tdog::i64_t now = nsec_mono();
+  std::vector<hang> found;
+
+  {
+    scoped_lock lock(m_mutex);
+
+    for(std::size_t n = 0; n < m_slots.size(); ++n)
+    {
+      slot& s = m_slots[n];
+      if (s.test == 0 || s.reported) continue;
+
+      if (s.limit > 0 && now - s.start > (s.limit + WATCH_GRACE_MS) * 1000000)
+      {
+        s.reported = true;
+
+        hang h;
+        h.idx = n;
+        h.start = s.start;
+        h.name = s.test->full_name();
+        h.limit = s.limit;
+        h.elapsed = (now - s.start) / 1000000;
+        h.thread = m_stacks ? _copy_thread(s.thread) : 0;
+        found.push_back(h);
+      }
+    }
+  }
+
+  for(std::size_t n = 0; n < found.size(); ++n)
+  {
+    _report(found[n]);
+    _free_thread(found[n].thread);
+  }
+
+  _end(found);
+}
+//---------------------------------------------------------------------------
+void watchdog::_report(const hang& h)
+{
+  // Report hung test on stderr. Written as a
+  // single string, as the test may also be writing.
+  std::string msg = "TDOG WATCHDOG: " + h.name +
+    " has exceeded its time constraint of " + int_to_str(h.limit) +
+    " ms, and is still running after " + int_to_str(h.elapsed) + " ms\n";
+
+  std::vector<std::string> stack = _stack_snapshot(h.thread);
+
+  if (!stack.empty())
+  {
+    msg += "TDOG WATCHDOG: stack snapshot:\n";
+
+    for(std::size_t n = 0; n < stack.size(); ++n)
+    {
+      msg += "  " + stack[n] + "\n";
+    }
+  }
+
+  std::cerr << msg;
+  std::cerr.flush();
+}
+//---------------------------------------------------------------------------
+void watchdog::_end(const std::vector<hang>& found)
+{
+  // End the process for a reported hang, if
+  // the test has not since returned by itself.
+  if (found.empty() || (!m_terminate && m_handler == 0)) return;
+
+  scoped_lock lock(m_mutex);
+
+  for(std::size_t n = 0; n < found.size(); ++n)
+  {
+    const hang& h = found[n];
+    const slot& s = m_slots[h.idx];
+
+    if (s.test != 0 && s.start == h.start)
+    {
+      if (!m_terminate)
+      {
+        // Lock is held, so the test cannot leave
+        m_handler->hung(s.test, (nsec_mono() - s.start) / 1000000);
+      }
+
+      // Parent, if any, will record the failure
+      _exit(EXIT_TIMEOUT);
+    }
+  }
+}
+//---------------------------------------------------------------------------
+// CLASS watchdog : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+watchdog::watchdog(bool terminate, bool stacks, hang_handler* handler)
+{
+  // Constructor. Thread is not
+  // started until first needed.
+  m_terminate = terminate;
+  m_stacks = stacks;
+  m_handler = handler;
+  m_started = false;
+}
+//---------------------------------------------------------------------------
+watchdog::~watchdog()
+{
+  // Destructor
+  m_stop.notify();
+  m_thread.join();
+
+  for(std::size_t n = 0; n < m_slots.size(); ++n)
+  {
+    _free_thread(m_slots[n].thread);
+  }
+}
+//---------------------------------------------------------------------------
+std::size_t watchdog::enter(basic_test* tc)
+{
+  // Start watching
+  scoped_lock lock(m_mutex);
+
+  if (!m_started)
+  {
+#if defined(TDOG_BACKTRACE)
+    if (m_stacks)
+    {
+      // Loads libgcc now, so that the
+      // handler call is signal safe.
+      void* warm[1];
+      backtrace(warm, 1);
+    }
+#endif
+
+    // On failure, we simply
+    // run without a watchdog.
+    m_started = true;
+    m_thread.start(*this);
+  }
+
+  std::size_t idx = 0;
+  while(idx < m_slots.size() && m_slots[idx].test != 0) ++idx;
+
+  if (idx == m_slots.size())
+  {
+    slot s;
+    s.thread = 0;
+    m_slots.push_back(s);
+  }
+
+  slot& s = m_slots[idx];
+  _free_thread(s.thread);
+  s.test = tc;
+  s.start = nsec_mono();
+  s.limit = 0;
+  s.reported = false;
+  s.thread = m_stacks ? _current_thread() : 0;
+
+  // Limit is given when the test starts
+  tc->set_watcher(this, idx);
+
+  return idx;
+}
+//---------------------------------------------------------------------------
+void watchdog::leave(std::size_t slot)
+{
+  // Stop watching
+  scoped_lock lock(m_mutex);
+
+  if (slot < m_slots.size() && m_slots[slot].test != 0)
+  {
+    m_slots[slot].test->set_watcher(0, 0);
+    m_slots[slot].test = 0;
+  }
+}
+//---------------------------------------------------------------------------
+void watchdog::limit_changed(std::size_t slot, tdog::i64_t ms)
+{
+  // Called in the test's thread
+  scoped_lock lock(m_mutex);
+  if (slot < m_slots.size()) m_slots[slot].limit = ms;
+}
+//---------------------------------------------------------------------------
+void watchdog::run(std::size_t)
+{
+  // Thread loop, until destroyed
+  while(!m_stop.wait(WATCH_POLL_MS))
+  {
+    _check();
+  }
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,155 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : watchdog.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_WATCHDOG_H
+#define TDOG_WATCHDOG_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+#include "tdog/private/run_helper.hpp"
+#include "thread_pool.hpp"
+
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Time limits are otherwise only checked when a test raises an event,
+// so a test which hangs without calling an assert or print is never
+// stopped. The watchdog runs a background thread which polls the
+// tests entered into it, and acts on any which have overrun their
+// time limit by more than a grace period.
+//
+// The hang is first reported on stderr. Where stacks is true, the report
+// includes a stack snapshot of the thread, where the platform supports
+// it. In a worker process, where terminate is true, the process then
+// exits with EXIT_TIMEOUT, and the parent records the test as failed.
+// Otherwise, a running thread cannot be stopped safely. Where there is
+// a hang_handler, it is called to record the test as failed and write
+// the results so far, and the process exits with EXIT_TIMEOUT. Without
+// one, the run continues when the test returns, at which point it fails.
+//
+// Tests give their time limit to the watchdog as it changes, through
+// limit_watcher, so that it is read under the watchdog's lock.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+// Forward declarations
+class basic_test;
+
+// Told of a test hung in this process, on the watchdog thread, before
+// the process exits. Tests cannot enter or leave the watchdog meanwhile.
+class hang_handler
+{
+  public:
+
+  virtual ~hang_handler() {}
+  virtual void hung(basic_test* tc, tdog::i64_t elapsed) = 0;
+};
+
+//---------------------------------------------------------------------------
+// CLASS watchdog
+//---------------------------------------------------------------------------
+class watchdog : public pool_task, public limit_watcher
+{
+  private:
+
+  struct slot
+  {
+    basic_test* test;         // <- null if free
+    tdog::i64_t start;        // <- nsec_mono() on entry
+    tdog::i64_t limit;        // <- ms, given by test
+    bool reported;
+    void* thread;             // <- platform id of thread running test
+  };
+
+  bool m_terminate;
+  bool m_stacks;
+  hang_handler* m_handler;
+  bool m_started;
+  std::vector<slot> m_slots;
+  mutex m_mutex;
+  notifier m_stop;
+  task_thread m_thread;
+
+  // Hung test found by _check()
+  struct hang
+  {
+    std::size_t idx;
+    tdog::i64_t start;
+    std::string name;
+    tdog::i64_t limit;
+    tdog::i64_t elapsed;
+    void* thread;   // <- copy, freed after report
+  };
+
+  void _check();
+  void _report(const hang& h);
+  void _end(const std::vector<hang>& found);
+
+  // No copy
+  watchdog(const watchdog&);
+  watchdog& operator=(const watchdog&);
+
+  public:
+
+  // Exit code of worker process stopped by watchdog
+  static const int EXIT_TIMEOUT = 124;
+
+  watchdog(bool terminate, bool stacks = true, hang_handler* handler = 0);
+  virtual ~watchdog();
+
+  // Start watching test, which must be about to run
+  // in the calling thread. Returns slot to pass to leave().
+  std::size_t enter(basic_test* tc);
+  void leave(std::size_t slot);
+
+  // Limit of test in slot, from the test's thread
+  virtual void limit_changed(std::size_t slot, tdog::i64_t ms);
+
+  // Internal thread entry
+  virtual void run(std::size_t idx);
+
+  // Watch test for lifetime of guard. Does
+  // nothing where watchdog pointer is null.
+  class guard
+  {
+    private:
+
+    watchdog* m_wd;
+    std::size_t m_slot;
+
+    // No copy
+    guard(const guard&);
+    guard& operator=(const guard&);
+
+    public:
+
+    guard(watchdog* wd, basic_test* tc)
+      : m_wd(wd), m_slot(0) { if (m_wd != 0) m_slot = m_wd->enter(tc); }
+    ~guard() { if (m_wd != 0) m_wd->leave(m_slot); }
+  };
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
@@ -0,0 +1,144 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : work_queue.cpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "work_queue.hpp"
+
+#include <algorithm>
+
+//---------------------------------------------------------------------------
+// NON-CLASS
+//---------------------------------------------------------------------------
+using namespace tdog;
+
+// Orders by descending cost, then by index
+struct cost_order
+{
+  const std::vector<tdog::i64_t>& costs;
+
+  cost_order(const std::vector<tdog::i64_t>& c) : costs(c) {}
+
+  bool operator()(std::size_t a, std::size_t b) const
+  {
+    if (costs[a] != costs[b]) return costs[a] > costs[b];
+    return a < b;
+  }
+};
+
+//---------------------------------------------------------------------------
+// CLASS work_queue : PUBLIC MEMBERS
+//---------------------------------------------------------------------------
+work_queue::work_queue(std::size_t workers)
+{
+  // Constructor
+  if (workers < 1) workers = 1;
+  m_queues.resize(workers);
+  m_load.resize(workers, 0);
+}
+//---------------------------------------------------------------------------
+std::size_t work_queue::workers() const
+{
+  return m_queues.size();
+}
+//---------------------------------------------------------------------------
+void work_queue::seed(std::size_t count, const std::vector<tdog::i64_t>& costs)
+{
+  // Assign items longest first, each to the queue with
+  // the least total cost so far. Unknown costs are given
+  // the median of those known, so they are placed
+  // neither first nor last.
+  scoped_lock lock(m_mutex);
+
+  std::vector<tdog::i64_t> est(count, 0);
+  std::vector<tdog::i64_t> known;
+
+  for(std::size_t n = 0; n < count && n < costs.size(); ++n)
+  {
+    if (costs[n] >= 0) known.push_back(costs[n]);
+  }
+
+  tdog::i64_t def_cost = 0;
+
+  if (!known.empty())
+  {
+    std::sort(known.begin(), known.end());
+    def_cost = known[known.size() / 2];
+  }
+
+  for(std::size_t n = 0; n < count; ++n)
+  {
+    est[n] = (n < costs.size() && costs[n] >= 0) ? costs[n] : def_cost;
+  }
+
+  std::vector<std::size_t> order(count);
+  for(std::size_t n = 0; n < count; ++n) order[n] = n;
+  std::sort(order.begin(), order.end(), cost_order(est));
+
+  std::size_t wcnt = m_queues.size();
+
+  for(std::size_t n = 0; n < count; ++n)
+  {
+    // Least loaded queue. Where all costs are
+    // equal, this gives a round-robin assignment.
+    std::size_t w = 0;
+
+    for(std::size_t k = 1; k < wcnt; ++k)
+    {
+      if (m_load[k] < m_load[w] ||
+        (m_load[k] == m_load[w] && m_queues[k].size() < m_queues[w].size()))
+      {
+        w = k;
+      }
+    }
+
+    m_queues[w].push_back( item(order[n], est[order[n]]) );
+    m_load[w] += est[order[n]];
+  }
+}
+//---------------------------------------------------------------------------
+bool work_queue::take(std::size_t worker, std::size_t& idx)
+{
+  // Take from front of own queue, or
+  // steal from back of the busiest.
+  scoped_lock lock(m_mutex);
+
+  std::size_t wcnt = m_queues.size();
+  if (worker >= wcnt) worker = 0;
+
+  if (!m_queues[worker].empty())
+  {
+    idx = m_queues[worker].front().idx;
+    m_load[worker] -= m_queues[worker].front().cost;
+    m_queues[worker].pop_front();
+    return true;
+  }
+
+  std::size_t victim = wcnt;
+
+  for(std::size_t k = 0; k < wcnt; ++k)
+  {
+    if (!m_queues[k].empty() && (victim == wcnt || m_load[k] > m_load[victim] ||
+      (m_load[k] == m_load[victim] && m_queues[k].size() > m_queues[victim].size())))
+    {
+      victim = k;
+    }
+  }
+
+  if (victim < wcnt)
+  {
+    idx = m_queues[victim].back().idx;
+    m_load[victim] -= m_queues[victim].back().cost;
+    m_queues[victim].pop_back();
+    return true;
+  }
+
+  return false;
+}
+//---------------------------------------------------------------------------
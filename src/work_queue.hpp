@@ -0,0 +1,88 @@
+//---------------------------------------------------------------------------
+// PROJECT      : TDOG
+// FILENAME     : work_queue.hpp
+// COPYRIGHT    : Kuiper (c) 2016
+// WEBSITE      : kuiper.zone
+// LICENSE      : Apache 2.0
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// HEADER GUARD
+//---------------------------------------------------------------------------
+#ifndef TDOG_WORK_QUEUE_H
+#define TDOG_WORK_QUEUE_H
+
+//---------------------------------------------------------------------------
+// INCLUDES
+//---------------------------------------------------------------------------
+#include "tdog/compat.hpp"
+#include "thread_pool.hpp"
+
+#include <vector>
+#include <deque>
+
+//---------------------------------------------------------------------------
+// DOCUMENTATION
+//---------------------------------------------------------------------------
+
+// Work-stealing scheduler used by the thread and process pools. Each worker
+// has its own queue of item indexes, which are seeded longest first from
+// the expected cost of each item. Workers take from the front of their
+// own queue, and when empty, steal from the back of the queue with the
+// most remaining cost. Longest items therefore start first, while the
+// shortest are left to fill in at the end.
+//
+// Items are whole test cases, so a single lock is used rather than
+// anything cleverer.
+
+//---------------------------------------------------------------------------
+// DECLARATIONS
+//---------------------------------------------------------------------------
+
+// Namespace
+namespace tdog {
+
+//---------------------------------------------------------------------------
+// CLASS work_queue
+//---------------------------------------------------------------------------
+class work_queue
+{
+  private:
+
+  struct item
+  {
+    std::size_t idx;
+    tdog::i64_t cost;
+    item(std::size_t i = 0, tdog::i64_t c = 0) : idx(i), cost(c) {}
+  };
+
+  std::vector< std::deque<item> > m_queues;
+  std::vector<tdog::i64_t> m_load;
+  mutex m_mutex;
+
+  // No copy
+  work_queue(const work_queue&);
+  work_queue& operator=(const work_queue&);
+
+  public:
+
+  work_queue(std::size_t workers);
+
+  // Number of worker queues
+  std::size_t workers() const;
+
+  // Seed queues with item indexes [0, count). The costs vector
+  // gives the expected cost of each item, or may be empty.
+  // Where a cost is negative, it is taken to be unknown.
+  void seed(std::size_t count, const std::vector<tdog::i64_t>& costs);
+
+  // Take next item for the given worker. Returns
+  // false when no items remain in any queue.
+  bool take(std::size_t worker, std::size_t& idx);
+};
+
+} // namespace
+
+//---------------------------------------------------------------------------
+#endif // HEADER GUARD
+//---------------------------------------------------------------------------
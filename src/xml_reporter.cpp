@@ -13,7 +13,7 @@
 #include "tdog.hpp"
 #include "util.hpp"
 
-#include <sstream>
+#include <algorithm>
 
 //---------------------------------------------------------------------------
 // NON-CLASS
@@ -31,6 +31,8 @@ const char* const TEST_SKIPPED_ELEM = "skipped";
 const char* const TEST_ERROR_ELEM = "error";
 const char* const TEST_FAILURE_ELEM = "failure";
 const char* const TEST_SYSTEMOUT_ELEM = "system-out";
+const char* const TEST_PROPERTIES_ELEM = "properties";
+const char* const TEST_PROPERTY_ELEM = "property";
 
 // XML Attributes
 const char* const NAME_ATTRIB = "name";
@@ -50,6 +52,7 @@ const char* const ASSERTIONS_ATTRIB = "assertions";
 const char* const STATUS_ATTRIB = "status";
 const char* const MESSAGE_ATTRIB = "message";
 const char* const TYPE_ATTRIB = "type";
+const char* const VALUE_ATTRIB = "value";
 
 // Others
 const char* const DEFAULT_SUITE = "DEFAULT";
@@ -62,63 +65,56 @@ void xml_reporter::_impl_clear()
 {
   // Internal clear as public clear is virtual.
   m_current_suite.clear();
-  m_root_output.clear();
-  m_suite_output.clear();
+  m_suite_open = false;
+  m_suite_id = 0;
 
   m_decl_flag = false;
   m_comment_flag = false;
 
-  m_suite_tests = 0;
-  m_suite_errors = 0;
-  m_suite_failures = 0;
-  m_suite_skipped = 0;
-  m_suite_disabled = 0;
-  m_suite_time = 0;
+  m_root_stats = xml_stats();
+  m_suite_stats.clear();
 }
 //---------------------------------------------------------------------------
-void xml_reporter::_close_suite(std::string& ref)
+void xml_reporter::_close_suite(std::ostream& os)
 {
   // Close testsuite and decrement indent
-  ref += _indent(-1) + "</";
-  ref += TEST_SUITE_ELEM;
-  ref += ">\n";
+  os << _indent(-1) << "</" << TEST_SUITE_ELEM << ">\n";
+  m_suite_open = false;
 }
 //---------------------------------------------------------------------------
-void xml_reporter::_write_stats(std::string& ref, bool is_root)
+void xml_reporter::_count(xml_stats& st, const run_helper& helper)
 {
-  // Replaces placeholders with know values
-  const std::string PFX = "$";
+  // Add test to stats
+  ++st.tests;
+  st.time += (helper.duration() / 1000);
 
-  if (is_root)
+  switch( helper.status() )
   {
-    // Root
-    ref = str_replace(ref, PFX + TESTS_ATTRIB, int_to_str(
-      owner().statistic_count(CNT_TOTAL, "*")));
-    ref = str_replace( ref, PFX + FAILURES_ATTRIB, int_to_str(
-      owner().statistic_count(CNT_FAILED, "*")));
-    ref = str_replace(ref, PFX + ERRORS_ATTRIB, int_to_str(
-      owner().statistic_count(CNT_ERRORS, "*")));
-    ref = str_replace(ref, PFX + SKIP_ATTRIB, int_to_str(
-      owner().statistic_count(CNT_SKIPPED, "*")));
-    ref = str_replace(ref, PFX + DISABLED_ATTRIB, int_to_str(
-      owner().statistic_count(CNT_DISABLED, "*")));
-
-    // Total duration
-    tdog::i64_t dur = (owner().end_time() - owner().start_time()) / 1000;
-    ref = str_replace(ref, PFX + TIME_ATTRIB, int_to_str(dur));
-  }
-  else
-  {
-    // Suite
-    ref = str_replace(ref, PFX + TESTS_ATTRIB, int_to_str(m_suite_tests));
-    ref = str_replace(ref, PFX + FAILURES_ATTRIB, int_to_str(m_suite_failures));
-    ref = str_replace(ref, PFX + ERRORS_ATTRIB, int_to_str(m_suite_errors));
-    ref = str_replace(ref, PFX + SKIPPED_ATTRIB, int_to_str(m_suite_skipped));
-    ref = str_replace(ref, PFX + DISABLED_ATTRIB, int_to_str(m_suite_disabled));
-    ref = str_replace(ref, PFX + TIME_ATTRIB, int_to_str(m_suite_time));
+    case TS_FAILED:
+      ++st.failures;
+      break;
+    case TS_ERROR:
+      ++st.errors;
+      break;
+    case TS_SKIPPED:
+      ++st.skipped;
+      break;
+    case TS_DISABLED:
+      ++st.disabled;
+      break;
+    default:
+      break;
   }
 }
 //---------------------------------------------------------------------------
+std::string xml_reporter::_property_str(const std::string& name,
+  const std::string& value)
+{
+  // Property element on one line
+  return _indent() + "<" + TEST_PROPERTY_ELEM + " " + NAME_ATTRIB + "=\"" +
+    name + "\" " + VALUE_ATTRIB + "=\"" + value + "\"/>\n";
+}
+//---------------------------------------------------------------------------
 // CLASS xml_reporter : PUBLIC MEMBERS
 //---------------------------------------------------------------------------
 xml_reporter::xml_reporter(const runner* owner, bool verbose)
@@ -128,6 +124,41 @@ xml_reporter::xml_reporter(const runner* owner, bool verbose)
   _impl_clear();
 }
 //---------------------------------------------------------------------------
+bool xml_reporter::needs_results() const
+{
+  // Counts are written first
+  return true;
+}
+//---------------------------------------------------------------------------
+void xml_reporter::gen_plan(const std::vector<basic_test*>& order)
+{
+  // Calculate root and suite stats in one pass. Suites
+  // break as they will in gen_test(), which skips tests
+  // which are not run.
+  clear();
+
+  std::string suite_name;
+
+  for(std::size_t n = 0; n < order.size(); ++n)
+  {
+    const run_helper& helper = order[n]->helper();
+
+    // Root counts all tests
+    _count(m_root_stats, helper);
+
+    if (helper.status() != TS_READY)
+    {
+      if (m_suite_stats.empty() || order[n]->suite_name() != suite_name)
+      {
+        suite_name = order[n]->suite_name();
+        m_suite_stats.push_back( xml_stats() );
+      }
+
+      _count(m_suite_stats.back(), helper);
+    }
+  }
+}
+//---------------------------------------------------------------------------
 void xml_reporter::clear()
 {
   // Clear internal data
@@ -135,14 +166,14 @@ void xml_reporter::clear()
   _impl_clear();
 }
 //---------------------------------------------------------------------------
-void xml_reporter::gen_start(std::ostream&)
+void xml_reporter::gen_start(std::ostream& os)
 {
-  // Write header.
-  clear();
-
-  // We ignore the ostream here, but write to an internal
-  // buffer as we must update the stats at the end of the run.
-  std::stringstream os;
+  // Write header. Stats from gen_plan() are kept.
+  basic_reporter::clear();
+  m_current_suite.clear();
+  m_suite_open = false;
+  m_suite_id = 0;
+  m_comment_flag = false;
 
   // Write XML log header to output stream
   std::string cs_str = owner().report_charset();
@@ -154,23 +185,28 @@ void xml_reporter::gen_start(std::ostream&)
   os << _indent() << "<!-- Test report generated by: "  << TDOG_LIB_NAME << " ";
   os << TDOG_LIB_VERSION << " -->\n";
 
-  // Root test run element. NOTE - we insert placeholders
-  // prefixed with "$". We will replace this in gen_end();
+  // Check declaration errors
+  std::vector<std::string> decl_errors = owner().declaration_errors(false);
+  m_decl_flag = (decl_errors.size() != 0);
+
+  // Error count is that of declaration
+  // errors, where there are any
+  int err_cnt = m_root_stats.errors;
+  if (m_decl_flag) err_cnt = static_cast<int>(decl_errors.size());
+
+  // Root test run element
+  tdog::i64_t dur = (owner().end_time() - owner().start_time()) / 1000;
   os << _indent(+1) << "<" << TEST_ROOT_ELEM;
   os << " " << NAME_ATTRIB << "=\"" << xml_esc(owner().project_name()) << "\"";
   os << " " << VERSION_ATTRIB << "=\"" << xml_esc(owner().project_version()) << "\"";
-  os << " " << TESTS_ATTRIB << "=\"$" << TESTS_ATTRIB << "\"";
-  os << " " << FAILURES_ATTRIB << "=\"$" << FAILURES_ATTRIB << "\"";
-  os << " " << ERRORS_ATTRIB << "=\"$" << ERRORS_ATTRIB << "\"";
-  os << " " << SKIP_ATTRIB << "=\"$" << SKIP_ATTRIB << "\"";
-  os << " " << DISABLED_ATTRIB << "=\"$" << DISABLED_ATTRIB << "\"";
-  os << " " << TIME_ATTRIB << "=\"$" << TIME_ATTRIB << "\"";
+  os << " " << TESTS_ATTRIB << "=\"" << m_root_stats.tests << "\"";
+  os << " " << FAILURES_ATTRIB << "=\"" << m_root_stats.failures << "\"";
+  os << " " << ERRORS_ATTRIB << "=\"" << err_cnt << "\"";
+  os << " " << SKIP_ATTRIB << "=\"" << m_root_stats.skipped << "\"";
+  os << " " << DISABLED_ATTRIB << "=\"" << m_root_stats.disabled << "\"";
+  os << " " << TIME_ATTRIB << "=\"" << int_to_str(dur) << "\"";
   os << ">\n";
 
-  // Check declaration errors
-  std::vector<std::string> decl_errors = owner().declaration_errors(false);
-  m_decl_flag = (decl_errors.size() != 0);
-
   // Build comment
   os << "\n";
   os << _indent() << "<!-- The '" << TEST_DECLERR_ELEM << "' element contains test case"
@@ -199,16 +235,11 @@ void xml_reporter::gen_start(std::ostream&)
 
   // Spacer
   os << "\n";
-
-  // Hold for later
-  m_root_output = os.str();
 }
 //---------------------------------------------------------------------------
-void xml_reporter::gen_test(std::ostream&, const basic_test* tc)
+void xml_reporter::gen_test(std::ostream& os, const basic_test* tc)
 {
   // Write test case to stream. tc cannot be null.
-  // We ignore the ostream here, but write to an
-  // internal buffer as we must update the stats at the end of the run.
   const run_helper& helper = tc->helper();
 
   // Declaration error - abort
@@ -216,36 +247,22 @@ void xml_reporter::gen_test(std::ostream&, const basic_test* tc)
 
   if (helper.status() != TS_READY)
   {
-    // We ignore the ostream here, but write to an internal
-    // buffer as we must update the stats at the end of the run.
-    std::stringstream os;
-
-    // Suite ID starts at 0
-    std::size_t suite_id = m_suite_output.size();
-
-    if (tc->suite_name() != m_current_suite || suite_id == 0)
+    if (tc->suite_name() != m_current_suite || !m_suite_open)
     {
-      if (suite_id != 0) // <- suite exists
+      if (m_suite_open)
       {
         // Close old suite
-        std::string& ref = m_suite_output.back();
-
-        // Insert stats and add closing tag
-        _write_stats(ref, false);
-        _close_suite(ref);
+        _close_suite(os);
+        ++m_suite_id;
       }
 
       // New suite
-      m_suite_output.push_back( std::string() );
       m_current_suite = tc->suite_name();
+      m_suite_open = true;
 
-      // Zero suite stats
-      m_suite_tests = 0;
-      m_suite_errors = 0;
-      m_suite_failures = 0;
-      m_suite_skipped = 0;
-      m_suite_disabled = 0;
-      m_suite_time = 0;
+      // Stats from plan
+      xml_stats st;
+      if (m_suite_id < m_suite_stats.size()) st = m_suite_stats[m_suite_id];
 
       // Rename default suite
       std::string suite_temp = xml_esc(m_current_suite);
@@ -254,22 +271,18 @@ void xml_reporter::gen_test(std::ostream&, const basic_test* tc)
       // Push on suite element
       os << _indent(+1) << "<" << TEST_SUITE_ELEM;
       os << " " << NAME_ATTRIB << "=\"" << suite_temp << "\"";
-      os << " " << ID_ATTRIB << "=\"" << suite_id << "\"";
-      os << " " << TESTS_ATTRIB << "=\"$" << TESTS_ATTRIB << "\"";
-      os << " " << ERRORS_ATTRIB << "=\"$" << ERRORS_ATTRIB << "\"";
-      os << " " << FAILURES_ATTRIB << "=\"$" << FAILURES_ATTRIB << "\"";
-      os << " " << SKIPPED_ATTRIB << "=\"$" << DISABLED_ATTRIB << "\"";
-      os << " " << DISABLED_ATTRIB << "=\"$" << SKIPPED_ATTRIB << "\"";
-      os << " " << TIME_ATTRIB << "=\"$" << TIME_ATTRIB << "\"";
+      os << " " << ID_ATTRIB << "=\"" << m_suite_id << "\"";
+      os << " " << TESTS_ATTRIB << "=\"" << st.tests << "\"";
+      os << " " << ERRORS_ATTRIB << "=\"" << st.errors << "\"";
+      os << " " << FAILURES_ATTRIB << "=\"" << st.failures << "\"";
+      os << " " << SKIPPED_ATTRIB << "=\"" << st.skipped << "\"";
+      os << " " << DISABLED_ATTRIB << "=\"" << st.disabled << "\"";
+      os << " " << TIME_ATTRIB << "=\"" << int_to_str(st.time) << "\"";
       os << " " << TIMESTAMP_ATTRIB << "=\"" << iso_time(helper.start_time()) << "\"";
-      os << " " << HOSTNAME_ATTRIB << "=\"" << tdog::hostname() << "\"";
+      os << " " << HOSTNAME_ATTRIB << "=\"" << xml_esc(owner().run_hostname()) << "\"";
       os << ">\n";
     }
 
-    // Increment test stats
-    ++m_suite_tests;
-    m_suite_time += (helper.duration() / 1000);
-
     // Add test case
     os << _indent(+1) << "<" << TEST_CASE_ELEM;
     os << " " << NAME_ATTRIB << "=\"" << xml_esc(tc->test_name()) << "\"";
@@ -279,16 +292,64 @@ void xml_reporter::gen_test(std::ostream&, const basic_test* tc)
     os << " " << TIME_ATTRIB << "=\"" << (helper.duration() / 1000) << "\"";
     os << ">\n";
 
+    const bench_result& b = helper.bench();
+    const hw_counts& hc = helper.counts();
+    const alloc_counts& ac = helper.allocs();
+
+    if (b.valid() || hc.valid() || ac.valid())
+    {
+      os << _indent(+1) << "<" << TEST_PROPERTIES_ELEM << ">\n";
+
+      if (b.valid())
+      {
+        // Benchmark figures as properties, times in ns
+        os << _property_str("bench.median_ns", double_to_str(b.median_ns, "%.3f"));
+        os << _property_str("bench.p90_ns", double_to_str(b.p90_ns, "%.3f"));
+        os << _property_str("bench.p99_ns", double_to_str(b.p99_ns, "%.3f"));
+        os << _property_str("bench.mad_ns", double_to_str(b.mad_ns, "%.3f"));
+        os << _property_str("bench.ops_per_sec", double_to_str(b.ops_per_sec(), "%.0f"));
+        os << _property_str("bench.samples", int_to_str(b.samples));
+        os << _property_str("bench.batch", int_to_str(b.batch));
+      }
+
+      // Hardware counts, where read
+      if (hc.cycles >= 0) os << _property_str("hw.cycles", int_to_str(hc.cycles));
+      if (hc.instructions >= 0) os << _property_str("hw.instructions", int_to_str(hc.instructions));
+      if (hc.cache_misses >= 0) os << _property_str("hw.cache_misses", int_to_str(hc.cache_misses));
+      if (hc.branch_misses >= 0) os << _property_str("hw.branch_misses", int_to_str(hc.branch_misses));
+
+      if (ac.valid())
+      {
+        // Heap allocations
+        os << _property_str("alloc.count", int_to_str(ac.count));
+        os << _property_str("alloc.bytes", int_to_str(ac.bytes));
+        os << _property_str("alloc.peak_bytes", int_to_str(ac.peak_bytes));
+      }
+
+      os << _indent(-1) << "</" << TEST_PROPERTIES_ELEM << ">\n";
+    }
+
     if (helper.has_ran())
     {
       // Output failures, errors and messages
       bool sysout_need_close = false;
       std::size_t esz = helper.event_log().size();
 
+      // Repeating block being written
+      std::size_t blk_first = 0, blk_last = 0;
+      int blk_left = 0;
+
       for(std::size_t n = 0; n < esz; ++n)
       {
         event_item eit = helper.event_log()[n];
-        std::string msg = xml_esc(eit.msg_str);
+        std::string msg = xml_esc(eit.msg());
+
+        if (eit.block > 1 && blk_left == 0)
+        {
+          blk_first = n;
+          blk_last = std::min(n + eit.block, esz) - 1;
+          blk_left = eit.cycles;
+        }
 
         // Determine if message, and hold value
         bool is_sysout_msg = (verbose() || (eit.item_type != ET_PASS && eit.item_type != ET_INFO));
@@ -353,12 +414,16 @@ void xml_reporter::gen_test(std::ostream&, const basic_test* tc)
             os << "&#xD\n";
           }
 
-          // Output the message.
+          // Output the message, once for each repeat.
           os << msg;
+          for(int r = 1; r < eit.repeat; ++r) os << "&#xD\n" << msg;
 
           // Flag that we need closure.
           sysout_need_close = true;
         }
+
+        // Block again, once for each cycle
+        if (blk_left > 0 && n == blk_last && --blk_left > 0) n = blk_first - 1;
       }
 
       if (sysout_need_close)
@@ -375,61 +440,17 @@ void xml_reporter::gen_test(std::ostream&, const basic_test* tc)
       os << _indent() << "<" << TEST_SKIPPED_ELEM << "/>\n";
     }
 
-    // Keep count
-    switch( helper.status() )
-    {
-      case TS_FAILED:
-        ++m_suite_failures;
-        break;
-      case TS_ERROR:
-        ++m_suite_errors;
-        break;
-      case TS_SKIPPED:
-        ++m_suite_skipped;
-        break;
-      case TS_DISABLED:
-        ++m_suite_disabled;
-        break;
-      default:
-        break;
-    }
-
     // End testcase element. NB. we do not put closing
     // tag for testsuite. This is done at the start of
     // this method and in gen_end().
     os << _indent(-1) << "</" << TEST_CASE_ELEM << ">\n";
-
-    // Store in array
-    m_suite_output.back() += os.str();
   }
 }
 //---------------------------------------------------------------------------
 void xml_reporter::gen_end(std::ostream& os)
 {
-  // Write footer to stream. In this we write cached
-  // root and suite data. Followed by final closing tag.
-  std::size_t suite_sz = m_suite_output.size();
-
-  if (suite_sz != 0)
-  {
-    // Close old suite
-    std::string& ref = m_suite_output.back();
-
-    // Insert stats and add closing tag
-    _write_stats(ref, false);
-    _close_suite(ref);
-  }
-
-  // Finalize stats
-  _write_stats(m_root_output, true);
-
-  // Write "cached" output
-  os << m_root_output;
-
-  for(std::size_t n = 0; n < suite_sz; ++n)
-  {
-    os << m_suite_output[n];
-  }
+  // Write footer to stream
+  if (m_suite_open) _close_suite(os);
 
   // Close test run
   os << _indent(-1) << "</" << TEST_ROOT_ELEM << ">\n";
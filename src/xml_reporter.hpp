@@ -41,6 +41,11 @@
  * </testsuite>
  */
 
+// Counts in the root and testsuite elements precede the test cases they
+// count. Rather than buffer the report to fill them in at the end, they
+// are calculated in a pass over the final results in gen_plan(), and the
+// report is streamed. The runner therefore writes it after the run.
+
 //---------------------------------------------------------------------------
 // DECLARATIONS
 //---------------------------------------------------------------------------
@@ -55,21 +60,29 @@ class xml_reporter : public basic_reporter
 {
   private:
 
+  // Counts for root or suite
+  struct xml_stats
+  {
+    int tests, errors, failures, skipped, disabled;
+    tdog::i64_t time;
+    xml_stats() : tests(0), errors(0), failures(0),
+      skipped(0), disabled(0), time(0) {}
+  };
+
   bool m_decl_flag;
   bool m_comment_flag;
-  std::string m_root_output;
+  bool m_suite_open;
   std::string m_current_suite;
-  std::vector<std::string> m_suite_output;
+  std::size_t m_suite_id;
 
-  // Keep running stats for each suite
-  int m_suite_tests, m_suite_errors, m_suite_failures,
-    m_suite_skipped, m_suite_disabled;
-  tdog::i64_t m_suite_time;
+  // Calculated by gen_plan()
+  xml_stats m_root_stats;
+  std::vector<xml_stats> m_suite_stats;
 
   void _impl_clear();
-  void _close_suite(std::string& ref);
-  void _write_stats(std::string& ref, bool is_root);
-  static std::string _rslt_str(const basic_test* tc);
+  void _close_suite(std::ostream& os);
+  void _count(xml_stats& st, const run_helper& helper);
+  std::string _property_str(const std::string& name, const std::string& value);
 
   public:
 
@@ -77,6 +90,8 @@ class xml_reporter : public basic_reporter
   xml_reporter(const runner* owner, bool verbose = true);
 
   // Report generator methods
+  virtual bool needs_results() const;
+  virtual void gen_plan(const std::vector<basic_test*>& order);
   virtual void clear();
   virtual void gen_start(std::ostream& os);
   virtual void gen_test(std::ostream& os, const basic_test* tc);